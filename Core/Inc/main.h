@@ -57,6 +57,10 @@ void Error_Handler(void);
 /* USER CODE END EFP */
 
 /* Private defines -----------------------------------------------------------*/
+#define AD9959_P2_Pin GPIO_PIN_2
+#define AD9959_P2_GPIO_Port GPIOE
+#define AD9959_P3_Pin GPIO_PIN_3
+#define AD9959_P3_GPIO_Port GPIOE
 #define AD9959_PDC_Pin GPIO_PIN_8
 #define AD9959_PDC_GPIO_Port GPIOD
 #define AD9959_RST_Pin GPIO_PIN_9
@@ -75,6 +79,10 @@ void Error_Handler(void);
 #define AD9959_UD_GPIO_Port GPIOD
 #define AD9959_CS_Pin GPIO_PIN_6
 #define AD9959_CS_GPIO_Port GPIOC
+#define AD9959_P0_Pin GPIO_PIN_0
+#define AD9959_P0_GPIO_Port GPIOE
+#define AD9959_P1_Pin GPIO_PIN_1
+#define AD9959_P1_GPIO_Port GPIOE
 
 /* USER CODE BEGIN Private defines */
 
@@ -6,6 +6,19 @@
 #define MYAD9959_H
 
 #include "main.h"
+#include "myad9959_queue.h"
+#include "myad9959_trace.h"
+#include "myad9959_tim.h"
+#include "myad9959_sched.h"
+#include "myad9959_mod.h"
+#include "myad9959_stream.h"
+#include "myad9959_hop.h"
+#include "myad9959_sweep.h"
+#include "myad9959_chain.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 /*********************************SPI外设配置*********************************************/
 /**
@@ -19,9 +32,66 @@
 
 /**!!!!!!!!!!!!!!!!!!!!!!!!!!!重要代码!!!!!!!!!!!!!!!!!!!!!!!!!!!!!**/
 /******* 取消注释下面的宏定义以启用硬件SPI模式，注释掉则使用软件SPI模式 *******/
+/* 主机测试定义AD9959_CONFIG_FROM_CMDLINE，由命令行的-D选择以下全部配置(见Host/Makefile) */
+#ifndef AD9959_CONFIG_FROM_CMDLINE
 #define AD9959_USE_HARDWARE_SPI
+#endif
+
+/******* 取消注释下面的宏定义以启用硬件SPI的DMA事务队列(需同时定义AD9959_USE_HARDWARE_SPI) *******/
+//#define AD9959_USE_SPI_DMA
+
+/******* DMA队列模式下由驱动定义HAL_SPI_TxCpltCallback()；应用程序自己实现该回调时注释掉，并在回调中调用ad9959_spi_tx_cplt() *******/
+#ifndef AD9959_CONFIG_FROM_CMDLINE
+#define AD9959_DEFINE_SPI_CALLBACK
+#endif
+
+/******* 取消注释下面的宏定义以在软件SPI模式下使用4位串行模式(SDIO_0-SDIO_3同时传输) *******/
+//#define AD9959_USE_4BIT_SERIAL
+
+/******* 取消注释下面的宏定义以使用定时器单脉冲产生IO_update(UD引脚为TIM4_CH4，见myad9959_tim.h) *******/
+//#define AD9959_USE_TIM_UPDATE
+
+/******* 取消注释下面的宏定义以使用定时器触发DMA输出Profile引脚符号流(见myad9959_stream.h)，注释掉则由ad9959_stream_tick()软件输出 *******/
+//#define AD9959_USE_STREAM_DMA
+
+/******* 取消注释下面的宏定义以使用TIM5中断播放跳频表(见myad9959_hop.h)，注释掉则周期调用ad9959_hop_tick() *******/
+//#define AD9959_USE_HOP_TIM
 
+/******* 软件SPI引擎配置 *******/
+/* 取消注释则使用256项字节BSRR表(占用8KB RAM)，否则按位查2项表，两者都是直线BSRR写入 */
+//#define AD9959_SOFT_SPI_BYTE_TABLE
+/* 软件SPI每半个时钟周期插入的NOP数，0为最快；AD9959的SCLK最高200MHz，一般无需延时 */
+#define AD9959_SOFT_SPI_HALF_PERIOD_NOP		0
 
+/*********************************时间基准与时序参数*********************************************/
+/* 时间基准 - 默认使用DWT周期计数器，主机构建时在包含本文件前重新定义 */
+#ifndef AD9959_TIMER_NOW
+#define AD9959_TIMER_NOW()		(DWT->CYCCNT)
+#define AD9959_TIMER_HZ			SystemCoreClock
+#define AD9959_TIMER_INIT()		do { CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; DWT->LAR = 0xC5ACCE55; \
+									 DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk; } while(0)
+#endif
+
+/* AD9959参考时钟(外部晶振)频率 */
+#define AD9959_REF_CLK			25000000
+/* SYNC_CLK周期(ns)：复位后PLL未使能时SYNC_CLK = REF_CLK/4，是最慢的情况，时序按此计算 */
+#define AD9959_SYNC_CLK_NS		(4000000000UL / AD9959_REF_CLK)
+/* 数据手册最小时序(ns) */
+/* 复位脉冲宽度：数据手册最小值为1个SYNC_CLK(160ns)，但前提是REF_CLK已经稳定。ad9959_init()通常在上电后
+ * 立即调用，晶振/有源振荡器可能还在起振，SYNC_CLK尚未运行，按SYNC_CLK计算的脉宽没有意义；
+ * 因此取1ms(原循环延时约数百us)，只在初始化时执行一次。确认REF_CLK已稳定的场合可以改为AD9959_SYNC_CLK_NS */
+#define AD9959_T_RESET_NS			1000000UL
+#define AD9959_T_RESET_RECOVERY_NS	AD9959_SYNC_CLK_NS		/* 复位结束到第一次串口访问 */
+#define AD9959_T_IO_UPDATE_NS		AD9959_SYNC_CLK_NS		/* IO_update高电平宽度：1个SYNC_CLK */
+#define AD9959_T_READ_VALID_NS		25						/* 软件SPI读取：SCLK下降沿到SDIO输出有效(保守值) */
+
+#if defined(AD9959_USE_SPI_DMA) && !defined(AD9959_USE_HARDWARE_SPI)
+#error "AD9959_USE_SPI_DMA需要同时定义AD9959_USE_HARDWARE_SPI"
+#endif
+
+#if defined(AD9959_USE_4BIT_SERIAL) && defined(AD9959_USE_HARDWARE_SPI)
+#error "4位串行模式只支持软件SPI，请取消AD9959_USE_HARDWARE_SPI"
+#endif
 
 /* SPI通信模式说明：
  * 软件SPI模式：使用GPIO引脚模拟SPI时序，兼容性好，可自由控制时序
@@ -30,8 +100,30 @@
  * 使用方法：
  * 1. 定义 AD9959_USE_HARDWARE_SPI 宏：使用硬件SPI模式
  * 2. 不定义该宏：使用软件SPI模式（默认）
+ *
+ * DMA事务队列说明：
+ * 定义 AD9959_USE_SPI_DMA 后寄存器写入和IO_update都进入队列，由SPI DMA完成中断依次发送，
+ * API调用立即返回，CPU不再等待SPI传输。需要在CubeMX中为SPI外设添加TX DMA并使能对应中断
+ *
+ * 4位串行模式说明：
+ * 定义 AD9959_USE_4BIT_SERIAL 后ad9959_init()通过CSR把芯片切换到4位串行模式，
+ * 每个时钟在SDIO_3..SDIO_0上同时输出一个半字节(高半字节在前，SDIO_3为最高位)，时钟数减少为1/4
+ * 要求SD0-SD3与CLK位于同一个GPIO端口
+ *
+ * 软件SPI引擎说明：
+ * 预先生成每一位(或每个字节)的BSRR字，每个时钟只需两次BSRR写：数据+时钟拉低，时钟拉高
+ * 要求SD0与CLK位于同一个GPIO端口(默认都在GPIOD)
  */
 
+/* AD9959系统时钟频率设定为500MHz，影响频率分辨率和最大输出频率(默认器件，其它器件见ad9959_dev_init()) */
+#define AD9959_System_Clk 500000000
+
+/* SYNC_CLK = 系统时钟/4，扫描的每一步为RSRR/FSRR个SYNC_CLK周期，按当前器件的系统时钟计算 */
+#define AD9959_SYNC_CLK		(ad9959_dev_cur->sys_clk / 4)
+
+/* 定步长扫描函数(ad9959_sweep_frequency等)使用的RSRR/FSRR，按时长扫描的函数自动计算 */
+#define AD9959_SWEEP_SRR_DEFAULT	0xFF
+
 #define Sweep_Fre		0	// 扫频
 #define Sweep_Phase		1	// 扫相
 #define Sweep_Amp		2	// 扫幅
@@ -47,6 +139,19 @@
 #define SRR 	0x07		/* 线性扫描定时器 */
 #define RDW 	0x08		/* 线性向上扫描定时器 */
 #define FDW 	0x09		/* 线性向下扫描定时器 */
+#define CW1 	0x0A		/* 通道字寄存器1 (扫描终点/调制字1) */
+#define CW15 	0x18		/* 通道字寄存器15 */
+#define AD9959_CW(n)	(0x09 + (n))	/* 通道字寄存器n的地址 (n=1-15) */
+
+/* CSR串行模式位 CSR[2:1] */
+#define AD9959_CSR_MODE_2WIRE	0x00		/* 单线串行，SDIO_0双向 */
+#define AD9959_CSR_MODE_3WIRE	0x02		/* 单线串行，SDIO_2输出 */
+#define AD9959_CSR_MODE_2BIT	0x04		/* 2位串行 */
+#define AD9959_CSR_MODE_4BIT	0x06		/* 4位串行 */
+#define AD9959_CSR_MODE_MASK	0x06
+
+#define AD9959_REG_COUNT	0x19	/* 寄存器地址总数 (0x00-0x18) */
+#define AD9959_CH_COUNT		4		/* DDS通道数 */
 
 /*********************************引脚连接说明*********************************************/
 /*
@@ -73,15 +178,85 @@
  */
 
 /*********************************引脚控制宏定义*********************************************/
-#define AD9959_CS(x)      	HAL_GPIO_WritePin(AD9959_CS_GPIO_Port, AD9959_CS_Pin, (x) ? GPIO_PIN_SET : GPIO_PIN_RESET)
-#define AD9959_UD(x)      	HAL_GPIO_WritePin(AD9959_UD_GPIO_Port, AD9959_UD_Pin, (x) ? GPIO_PIN_SET : GPIO_PIN_RESET)
-#define AD9959_CLK(x)     	HAL_GPIO_WritePin(AD9959_CLK_GPIO_Port, AD9959_CLK_Pin, (x) ? GPIO_PIN_SET : GPIO_PIN_RESET)
-#define AD9959_SD0(x)     	HAL_GPIO_WritePin(AD9959_SD0_GPIO_Port, AD9959_SD0_Pin, (x) ? GPIO_PIN_SET : GPIO_PIN_RESET)
-#define AD9959_SD1(x)     	HAL_GPIO_WritePin(AD9959_SD1_GPIO_Port, AD9959_SD1_Pin, (x) ? GPIO_PIN_SET : GPIO_PIN_RESET)
-#define AD9959_SD2(x)     	HAL_GPIO_WritePin(AD9959_SD2_GPIO_Port, AD9959_SD2_Pin, (x) ? GPIO_PIN_SET : GPIO_PIN_RESET)
-#define AD9959_SD3(x)     	HAL_GPIO_WritePin(AD9959_SD3_GPIO_Port, AD9959_SD3_Pin, (x) ? GPIO_PIN_SET : GPIO_PIN_RESET)
-#define AD9959_RST(x)     	HAL_GPIO_WritePin(AD9959_RST_GPIO_Port, AD9959_RST_Pin, (x) ? GPIO_PIN_SET : GPIO_PIN_RESET)
-#define AD9959_PDC(x)     	HAL_GPIO_WritePin(AD9959_PDC_GPIO_Port, AD9959_PDC_Pin, (x) ? GPIO_PIN_SET : GPIO_PIN_RESET)
+/* 直接写BSRR寄存器，省去HAL_GPIO_WritePin的函数调用和分支
+ * 主机仿真时在包含本文件前定义AD9959_BSRR_WRITE，把所有引脚操作转给仿真模型 */
+#ifndef AD9959_BSRR_WRITE
+#define AD9959_BSRR_WRITE(port, word)	((port)->BSRR = (word))
+#endif
+#define AD9959_PIN_WRITE(port, pin, x)	AD9959_BSRR_WRITE((port), (x) ? (uint32_t)(pin) : ((uint32_t)(pin) << 16))
+#ifndef AD9959_PIN_READ
+#define AD9959_PIN_READ(port, pin)		(((port)->IDR & (pin)) != 0U)
+#endif
+#define AD9959_CS(x)      	AD9959_PIN_WRITE(ad9959_dev_cur->cs_port, ad9959_dev_cur->cs_pin, (x))	/* 当前器件的片选 */
+#define AD9959_UD(x)      	AD9959_PIN_WRITE(AD9959_UD_GPIO_Port, AD9959_UD_Pin, (x))
+#define AD9959_CLK(x)     	AD9959_PIN_WRITE(AD9959_CLK_GPIO_Port, AD9959_CLK_Pin, (x))
+#define AD9959_SD0(x)     	AD9959_PIN_WRITE(AD9959_SD0_GPIO_Port, AD9959_SD0_Pin, (x))
+#define AD9959_SD1(x)     	AD9959_PIN_WRITE(AD9959_SD1_GPIO_Port, AD9959_SD1_Pin, (x))
+#define AD9959_SD2(x)     	AD9959_PIN_WRITE(AD9959_SD2_GPIO_Port, AD9959_SD2_Pin, (x))
+#define AD9959_SD3(x)     	AD9959_PIN_WRITE(AD9959_SD3_GPIO_Port, AD9959_SD3_Pin, (x))
+#define AD9959_RST(x)     	AD9959_PIN_WRITE(AD9959_RST_GPIO_Port, AD9959_RST_Pin, (x))
+#define AD9959_PDC(x)     	AD9959_PIN_WRITE(AD9959_PDC_GPIO_Port, AD9959_PDC_Pin, (x))
+
+/*******************************类型定义*******************************************/
+
+/* 突发写入的一个寄存器 */
+typedef struct
+{
+	uint8_t        reg;		/* 寄存器地址 */
+	uint8_t        len;		/* 数据字节数 */
+	const uint8_t *data;	/* 数据，高字节在前 */
+} ad9959_burst_item_t;
+
+/* 单个通道的输出参数，用于ad9959_set_channels() */
+typedef struct
+{
+	uint8_t  ch;			/* 通道 (0-3) */
+	uint16_t phase;			/* 相位 (度) */
+	uint16_t amp;			/* 幅度 (1-1023) */
+	uint64_t fre_mhz;		/* 频率 (0.001Hz) */
+} ad9959_channel_cfg_t;
+
+/*********************************多器件*********************************************/
+/**
+ * 多片AD9959共用SCLK/SDIO/IO_update/RESET/PDC，每片有独立的片选，也可以各用一个SPI外设
+ * 原有的全部接口作用于当前器件(ad9959_dev_select()选择)，默认器件使用本文件中的引脚和AD9959_SPI_HANDLE
+ * IO_update为共用信号，一个脉冲使所有器件已发送的寄存器同时生效；
+ * 再用FR2的多器件同步功能对齐各片的SYNC_CLK，更新可以精确到同一个采样时刻
+ */
+#define AD9959_REG_FILE_BYTES	88		/* 全部寄存器字节数之和 */
+#define AD9959_FLUSH_MAX_BYTES	512		/* 一次ad9959_flush()产生的最大字节数(全部寄存器都改变时约460) */
+
+/* FR2[7:0]多器件同步位 */
+#define AD9959_FR2_AUTO_SYNC		0x80	/* 自动同步使能 */
+#define AD9959_FR2_SYNC_MASTER		0x40	/* 同步主器件：从SYNC_OUT输出同步信号 */
+#define AD9959_FR2_SYNC_STATUS		0x20	/* 同步状态(只读) */
+#define AD9959_FR2_SYNC_MASK		0x10	/* 屏蔽同步状态 */
+#define AD9959_FR2_CLK_OFFSET_MASK	0x03	/* 系统时钟偏移，补偿SYNC_IN的延时 */
+
+/* 影子寄存器：want为软件期望值，chip为已发送到芯片的值 */
+typedef struct
+{
+	uint8_t  want[AD9959_CH_COUNT][AD9959_REG_FILE_BYTES];
+	uint8_t  chip[AD9959_CH_COUNT][AD9959_REG_FILE_BYTES];
+	uint32_t valid[AD9959_CH_COUNT];	/* 按地址的位图：chip中内容已知 */
+	uint32_t dirty[AD9959_CH_COUNT];	/* 按地址的位图：want待发送 */
+} ad9959_shadow_t;
+
+/* 一片AD9959 */
+typedef struct
+{
+	GPIO_TypeDef      *cs_port;		/* 片选端口 */
+	uint16_t           cs_pin;		/* 片选引脚 */
+	SPI_HandleTypeDef *hspi;		/* 硬件SPI外设，软件SPI时不使用 */
+	uint32_t           sys_clk;		/* 系统时钟(Hz) */
+	uint8_t            sync_offset;	/* 多器件同步的系统时钟偏移 (0-3) */
+	uint8_t            serial_mode;	/* 当前串行模式(CSR[2:1]) */
+	ad9959_shadow_t    shadow;		/* 影子寄存器 */
+} ad9959_dev_t;
+
+/* 默认器件和当前器件 */
+extern ad9959_dev_t  ad9959_dev_default;
+extern ad9959_dev_t *ad9959_dev_cur;
 
 /*******************************外部函数声明*******************************************/
 
@@ -96,17 +271,297 @@
 extern void ad9959_init(void);
 
 /**
- * @brief       AD9959统一数据写入函数
- * @param       reg: 寄存器地址 (0x00-0x09)
- * @param       DataNumber: 要写入的数据字节数
- * @param       Data: 指向要写入数据的指针
+ * @brief       进入掉电模式
+ * @param       无
+ * @retval      无
+ * @note        等待已提交的传输完成后拉高PWR_DWN_CTL(PDC为各器件共用)，掉电方式由FR1[6]选择；
+ *              掉电期间寄存器内容保持，串口仍可访问
+ */
+extern void ad9959_power_down(void);
+
+/**
+ * @brief       退出掉电模式
+ * @param       无
  * @retval      无
- * @note        根据编译时宏定义自动选择使用软件SPI或硬件SPI
- *              定义AD9959_USE_HARDWARE_SPI宏则使用硬件SPI，否则使用软件SPI
- *              该函数是对底层SPI通信的统一封装，用户只需调用此函数即可
+ * @note        拉低PWR_DWN_CTL；完全掉电后PLL需要重新锁定，输出稳定前应按数据手册等待锁定时间
+ *              供电跌落可能使寄存器丢失，这时用ad9959_init()复位后ad9959_restore()恢复
+ */
+extern void ad9959_power_up(void);
+
+/**
+ * @brief       AD9959统一数据写入函数(写入影子寄存器)
+ * @param       reg: 寄存器地址 (0x00-0x18)
+ * @param       DataNumber: 要写入的数据字节数，应与寄存器长度相同
+ * @param       Data: 指向要写入数据的指针，高字节在前
+ * @retval      无
+ * @note        不立即发送：数据写入影子寄存器的期望值并标记为待写，
+ *              由之后的ad9959_flush()或IO_update()把与芯片内容不同的寄存器拼成一帧发送，未改变的寄存器不发送
+ *              CSR只记录后续通道寄存器写入的目标通道(逻辑CSR)，发送时由ad9959_flush()按需切换芯片CSR；
+ *              FR1/FR2为全局寄存器，其余寄存器按CSR选中的通道分别记录
+ *              地址无效或长度与寄存器不符时忽略本次写入，不发送，影子寄存器不变
  */
 extern void AD9959_WriteData_Unified(uint8_t reg, uint8_t DataNumber, uint8_t *Data);
 
+/**
+ * @brief       选择并使能AD9959通道
+ * @param       ch: 通道号 (0-3)
+ * @retval      无
+ * @note        之后写入的通道寄存器只作用于该通道
+ */
+extern void ad9959_channel_sel_enable(uint8_t ch);
+
+/**
+ * @brief       突发写入一组寄存器
+ * @param       items: 寄存器列表，可以包含CSR以切换后续寄存器的目标通道
+ * @param       count: 寄存器个数
+ * @retval      无
+ * @note        经过影子寄存器，未改变的寄存器被跳过，其余拼接成一帧在一次片选内发送
+ *              不产生IO_update，需要时再调用IO_update()
+ */
+extern void ad9959_write_burst(const ad9959_burst_item_t *items, uint8_t count);
+
+/**
+ * @brief       将寄存器列表序列化为一段连续的突发数据
+ * @param       items: 寄存器列表
+ * @param       count: 寄存器个数
+ * @param       buf: 输出缓冲区
+ * @param       size: 输出缓冲区字节数
+ * @retval      序列化后的字节数，缓冲区不足时返回0
+ * @note        结果可以保存起来，之后用AD9959_WriteFrame()反复发送
+ */
+extern uint16_t ad9959_burst_serialize(const ad9959_burst_item_t *items, uint8_t count, uint8_t *buf, uint16_t size);
+
+/**
+ * @brief       在一次片选内发送一段连续数据
+ * @param       buf: 由一个或多个"指令字节+数据"组成的数据
+ * @param       len: 字节数
+ * @retval      无
+ * @note        直接发送，不经过影子寄存器；写入通道寄存器后应调用ad9959_shadow_invalidate()
+ *              DMA队列模式下不超过AD9959_QUEUE_MAX_FRAME的帧入队后立即返回，更长的帧等待队列发送完后阻塞发送；
+ *              在中断中调用时队列已满的帧被丢弃，计入ad9959_queue_errors()
+ */
+extern void AD9959_WriteFrame(const uint8_t *buf, uint16_t len);
+
+/**
+ * @brief       切换AD9959串行通信模式
+ * @param       mode: AD9959_CSR_MODE_2WIRE/3WIRE/4BIT
+ * @retval      无
+ * @note        先发送待写寄存器，再用当前模式写CSR，之后的传输使用新模式
+ *              硬件SPI只能使用单线模式，请求4位模式时不做任何改变
+ *              定义AD9959_USE_4BIT_SERIAL时ad9959_init()会自动切换到4位模式
+ */
+extern void ad9959_set_serial_mode(uint8_t mode);
+
+/**
+ * @brief       生成4位串行模式的半字节BSRR表
+ * @param       table: 输出，16个BSRR字，下标为要输出的半字节
+ * @param       sd_pin: SDIO_0-SDIO_3对应的引脚掩码
+ * @param       clk_pin: SCLK对应的引脚掩码
+ * @retval      无
+ * @note        每个字同时设置4根数据线并拉低时钟，半字节第n位输出到SDIO_n
+ *              纯计算函数，不访问硬件
+ */
+extern void ad9959_nibble_bsrr_table(uint32_t table[16], const uint16_t sd_pin[4], uint16_t clk_pin);
+
+/**
+ * @brief       生成单线模式一个字节的BSRR序列
+ * @param       out: 输出，8个BSRR字，依次对应bit7..bit0
+ * @param       value: 要发送的字节
+ * @param       sd_pin: SDIO_0对应的引脚掩码
+ * @param       clk_pin: SCLK对应的引脚掩码
+ * @retval      无
+ * @note        每个字设置SD0并拉低时钟，之后再写一次时钟引脚产生上升沿
+ *              纯计算函数，不访问硬件
+ */
+extern void ad9959_byte_bsrr_table(uint32_t out[8], uint8_t value, uint16_t sd_pin, uint16_t clk_pin);
+
+/**
+ * @brief       从AD9959读取寄存器
+ * @param       reg: 寄存器地址 (0x00-0x18)
+ * @param       DataNumber: 数据字节数 (1-4)
+ * @param       Data: 输出，高字节在前
+ * @retval      0: 成功  1: 当前为2位/4位串行模式，不支持读取
+ * @note        单线2线模式由SDIO_0输出，3线模式(ad9959_set_serial_mode(AD9959_CSR_MODE_3WIRE))由SDIO_2输出；
+ *              软件SPI临时把该数据线切换为输入；硬件SPI为半双工(Init.Direction为SPI_DIRECTION_1LINE，SDIO_0接MOSI)
+ *              时先发送指令再接收，全双工时MISO接SDIO_2，使用3线模式
+ *              通道寄存器读取芯片CSR选中的通道；不经过影子寄存器，一般使用ad9959_read_reg()
+ */
+extern uint8_t AD9959_ReadData(uint8_t reg, uint8_t DataNumber, uint8_t *Data);
+
+/**
+ * @brief       读取一个通道的寄存器
+ * @param       ch: 通道 (0-3)，全局寄存器(CSR/FR1/FR2)忽略
+ * @param       reg: 寄存器地址 (0x00-0x18)
+ * @param       data: 输出，按寄存器长度，高字节在前
+ * @retval      0: 成功  1: 参数错误或当前串行模式不支持读取
+ * @note        先发送待写数据，通道寄存器需要时写一次CSR只选中该通道(逻辑CSR不变)
+ *              读到的是I/O缓冲的内容，即最近写入的值，未必已经IO_update生效
+ */
+extern uint8_t ad9959_read_reg(uint8_t ch, uint8_t reg, uint8_t *data);
+
+/**
+ * @brief       回读寄存器并与影子寄存器比较
+ * @param       regs: 按地址的寄存器位图(1 << reg)，CSR不参与比较
+ * @param       ch_mask: 通道位图(bit0-bit3)，只影响通道寄存器
+ * @param       bad: 输出，各通道不一致的寄存器位图(全局寄存器记在通道0)，AD9959_CH_COUNT项，可以为NULL
+ * @retval      不一致的寄存器数，0xFF表示当前串行模式不支持读取
+ * @note        只比较影子寄存器中内容已知的寄存器；芯片CSR也可能被干扰改变，读取通道寄存器前总是重新选中通道；
+ *              不一致的寄存器标记为待写，之后的ad9959_flush()/IO_update()只重写这些寄存器，不需要重新配置全部通道
+ *              用于强干扰后检查芯片状态，例如ad9959_verify_shadow((1UL << CFTW0) | (1UL << CPOW0) | (1UL << ACR), 0x0F, NULL)
+ */
+extern uint8_t ad9959_verify_shadow(uint32_t regs, uint8_t ch_mask, uint32_t *bad);
+
+/* 状态快照的最大字节数：头7字节，4个通道的位图，全部寄存器(全局寄存器只保存一次)，CRC 2字节 */
+#define AD9959_SNAPSHOT_MAX_BYTES	(7 + 4 * AD9959_CH_COUNT + AD9959_REG_FILE_BYTES * AD9959_CH_COUNT - 6 * (AD9959_CH_COUNT - 1) + 2)
+
+/**
+ * @brief       保存当前器件的逻辑状态(所有通道的频率、相位、幅度、调制和扫描参数等)
+ * @param       buf: 输出缓冲区
+ * @param       size: 缓冲区字节数，AD9959_SNAPSHOT_MAX_BYTES足够
+ * @retval      快照字节数，缓冲区不足时返回0
+ * @note        快照取自影子寄存器的期望值(包括还未发送的修改)，只保存与复位值不同或写过的寄存器，
+ *              四通道单频约75字节；带CRC校验，可以保存在备份SRAM或Flash中
+ *              ad9959_chain_play()等绕过影子寄存器直接写芯片的内容不在快照中
+ */
+extern uint16_t ad9959_snapshot(uint8_t *buf, uint16_t size);
+
+/**
+ * @brief       从快照恢复当前器件的逻辑状态并使之生效
+ * @param       buf: ad9959_snapshot()生成的快照
+ * @param       len: 快照字节数
+ * @retval      0: 成功  1: 快照损坏、版本不符或系统时钟与当前器件不同，没有修改任何状态
+ * @note        快照写入影子寄存器后调用IO_update()，由ad9959_flush()按通道分组在一次突发中发送，
+ *              芯片中已经相同的寄存器不再发送：
+ *              - 供电跌落后：ad9959_init()复位芯片，再恢复，只发送与复位值不同的寄存器
+ *              - 掉电唤醒后：寄存器保持，什么都不发送；不确定时先ad9959_verify_shadow()或ad9959_shadow_invalidate()
+ *              串行模式保持当前器件的设置，不从快照恢复；FR1改变PLL倍频时输出稳定前需要等待PLL锁定
+ */
+extern uint8_t ad9959_restore(const uint8_t *buf, uint16_t len);
+
+/**
+ * @brief       将影子寄存器中的待写数据发送到AD9959
+ * @param       无
+ * @retval      无
+ * @note        AD9959_WriteData_Unified只更新影子寄存器并标记脏位，实际发送推迟到此处
+ *              与芯片当前内容相同的寄存器会被跳过，同一寄存器的多次写入只发送最后一次
+ *              IO_update()会自动调用本函数，一般无需手动调用
+ */
+extern void ad9959_flush(void);
+
+/**
+ * @brief       把待写寄存器收集到缓冲区，不发送
+ * @param       buf: 输出缓冲区，至少AD9959_FLUSH_MAX_BYTES字节
+ * @retval      字节数，为0表示没有待写寄存器
+ * @note        内容与ad9959_flush()发送的相同，调用者负责在一次片选内发送(见myad9959_bus.h)，
+ *              影子寄存器视为已发送；不产生IO_update
+ */
+extern uint16_t ad9959_flush_to(uint8_t *buf);
+
+/**
+ * @brief       将影子寄存器恢复为芯片上电复位后的默认值
+ * @param       无
+ * @retval      无
+ * @note        ad9959_init()复位芯片后会自动调用
+ *              没有确定复位值的寄存器被标记为未知，下一次写入时必定发送
+ */
+extern void ad9959_shadow_reset(void);
+
+/**
+ * @brief       使影子寄存器中记录的芯片内容全部失效
+ * @param       无
+ * @retval      无
+ * @note        芯片状态不确定时调用(如外部复位、干扰)，之后所有寄存器写入都会真实发送
+ */
+extern void ad9959_shadow_invalidate(void);
+
+/**
+ * @brief       使影子寄存器中部分寄存器的芯片内容失效
+ * @param       ch_mask: 通道位图(bit0-bit3)，只影响通道寄存器
+ * @param       regs: 按地址的寄存器位图(1 << reg)，全局寄存器(CSR/FR1/FR2)与ch_mask无关
+ * @retval      无
+ * @note        绕过影子寄存器直接写入芯片后调用(如AD9959_WriteFrame())，之后写入这些寄存器时必定发送
+ */
+extern void ad9959_shadow_forget(uint8_t ch_mask, uint32_t regs);
+
+/**
+ * @brief       使芯片CSR只选中一个通道
+ * @param       ch: 通道 (0-3)
+ * @retval      无
+ * @note        之后用AD9959_WriteFrame()直接发送通道寄存器前调用(跳频表、扫频链)；
+ *              ad9959_flush()按分组选择通道，没有待写的通道寄存器时不发送CSR，不能代替本函数；
+ *              只在芯片CSR不是该通道时发送，待写数据不发送，需要时先调用ad9959_flush()
+ */
+extern void ad9959_select_channel(uint8_t ch);
+
+/**
+ * @brief       发送待写寄存器并产生IO_update，完成后调用回调
+ * @param       cb: 回调函数，可以为NULL
+ * @param       ctx: 传给回调函数的参数
+ * @retval      无
+ * @note        DMA队列模式下立即返回，IO_update脉冲发出后在中断中调用cb
+ *              阻塞模式下发送完成后直接调用cb
+ */
+extern void ad9959_update_async(ad9959_queue_cb_t cb, void *ctx);
+
+/**
+ * @brief       发送待写寄存器，并在指定时刻产生IO_update
+ * @param       when: 时间戳，与AD9959_TIMER_NOW()同一时间基准
+ * @retval      0: 按时预约  1: 时刻已过，立即更新
+ * @note        寄存器立即发送(DMA模式下等待发送完成)，新参数在when时刻同时生效
+ *              定义AD9959_USE_TIM_UPDATE时由定时器产生脉冲，函数立即返回；否则阻塞到when
+ */
+extern uint8_t ad9959_update_at(uint32_t when);
+
+/**
+ * @brief       等待所有已提交的传输完成
+ * @param       无
+ * @retval      无
+ * @note        仅DMA队列模式下需要，阻塞模式下直接返回
+ */
+extern void ad9959_wait_idle(void);
+
+/**
+ * @brief       SPI发送完成处理
+ * @param       hspi: SPI句柄
+ * @retval      无
+ * @note        仅DMA队列模式下定义。先交给多总线并行发送，再交给当前器件的DMA队列；
+ *              定义AD9959_DEFINE_SPI_CALLBACK时由驱动的HAL_SPI_TxCpltCallback()调用，
+ *              否则应用程序需要在自己的HAL_SPI_TxCpltCallback()中调用
+ */
+extern void ad9959_spi_tx_cplt(SPI_HandleTypeDef *hspi);
+
+/**
+ * @brief       初始化延时服务
+ * @param       无
+ * @retval      无
+ * @note        启动时间基准并按AD9959_TIMER_HZ计算换算系数，ad9959_init()会自动调用
+ *              修改系统时钟(SystemCoreClock)后需要重新调用
+ */
+extern void ad9959_delay_init(void);
+
+/**
+ * @brief       纳秒级延时
+ * @param       ns: 延时时间(ns)，实际延时不小于该值
+ * @retval      无
+ * @note        基于DWT周期计数器，与编译优化等级和缓存状态无关
+ */
+extern void ad9959_delay_ns(uint32_t ns);
+
+/**
+ * @brief       产生IO_update脉冲
+ * @param       无
+ * @retval      无
+ * @note        只产生脉冲，不发送影子寄存器，一般使用IO_update()
+ */
+extern void ad9959_io_update_pulse(void);
+
+/**
+ * @brief       发送待写寄存器并产生IO_update，使新参数生效
+ * @param       无
+ * @retval      无
+ */
+extern void IO_update(void);
+
 /**
  * @brief       设置AD9959指定通道输出固定参数信号
  * @param       ch: 输出通道 (0-3)
@@ -120,6 +575,85 @@ extern void AD9959_WriteData_Unified(uint8_t reg, uint8_t DataNumber, uint8_t *D
  */
 extern void ad9959_set_signal_out(uint8_t ch, double fre, uint16_t phase, uint16_t amp);
 
+/**
+ * @brief       同时设置多个通道的输出
+ * @param       cfg: 各通道参数
+ * @param       count: 通道数
+ * @retval      无
+ * @note        全部参数写入影子寄存器后只产生一次IO_update，各通道同时生效且相位对齐；
+ *              数值相同的通道由ad9959_flush()合并为一次CSR多通道写入
+ */
+extern void ad9959_set_channels(const ad9959_channel_cfg_t *cfg, uint8_t count);
+
+/**
+ * @brief       把多个通道的参数批量写入影子寄存器，不更新
+ * @param       cfg: 各通道参数，同一通道出现多次时以最后一次为准
+ * @param       count: 通道数
+ * @retval      0: 成功  1: 有通道号不小于AD9959_CH_COUNT，没有写入任何寄存器
+ * @note        寄存器内容与ad9959_set_channels()相同；控制字按批换算(每种一个循环，频率共用一次倒数查找)，
+ *              直接写入各通道的影子寄存器，不经过CSR选择和逐个寄存器的写入；
+ *              逻辑CSR(后续AD9959_WriteData_Unified的目标通道)不变
+ *              多器件时对每个器件调用后用ad9959_dev_update()或ad9959_bus_update()同时更新
+ */
+extern uint8_t ad9959_load_all(const ad9959_channel_cfg_t *cfg, uint8_t count);
+
+/**
+ * @brief       批量设置多个通道的输出
+ * @param       cfg: 各通道参数
+ * @param       count: 通道数
+ * @retval      0: 成功  1: 有通道号不小于AD9959_CH_COUNT，没有写入也没有更新
+ * @note        ad9959_load_all()后产生一次IO_update；与芯片内容相同的寄存器由ad9959_flush()跳过，
+ *              其余按最少的CSR分组在一次片选内发送
+ */
+extern uint8_t ad9959_set_all(const ad9959_channel_cfg_t *cfg, uint8_t count);
+
+/**
+ * @brief       多通道相位相干启动
+ * @param       cfg: 各通道参数，phase为通道间的相对相位
+ * @param       count: 通道数
+ * @retval      无
+ * @note        利用FR2的全通道自动清零相位累加器位，一次IO_update使所有通道从零相位同时开始，
+ *              之后的更新不再清零，相位保持连续；适用于IQ、波束形成等需要固定相位差的场合
+ */
+extern void ad9959_start_coherent(const ad9959_channel_cfg_t *cfg, uint8_t count);
+
+/* 由角度计算相位控制字：CPOW0 = phase * 2^14 / 360，向下取整(phase为0-65535度)
+ * 纯整数运算，与原双精度计算后截断的结果相同；不截取14位，360度得到0x4000，芯片只使用低14位 */
+#define AD9959_POW_FROM_DEG(phase)		((uint32_t)(phase) * 16384U / 360U)
+
+/**
+ * @brief       由整数Hz计算频率控制字
+ * @param       fre_hz: 频率 (Hz)
+ * @retval      32位频率控制字，FTW = round(fre * 2^32 / System_Clock)
+ * @note        纯整数运算，结果按四舍五入精确取整
+ */
+extern uint32_t ad9959_ftw_from_hz(uint32_t fre_hz);
+
+/**
+ * @brief       由毫赫兹计算频率控制字
+ * @param       fre_mhz: 频率 (0.001Hz)，例如1MHz对应1000000000
+ * @retval      32位频率控制字
+ * @note        纯整数运算，结果按四舍五入精确取整
+ */
+extern uint32_t ad9959_ftw_from_millihz(uint64_t fre_mhz);
+
+/**
+ * @brief       由微赫兹计算频率控制字
+ * @param       fre_uhz: 频率 (0.000001Hz)
+ * @retval      32位频率控制字
+ * @note        纯整数运算，结果按四舍五入精确取整
+ */
+extern uint32_t ad9959_ftw_from_microhz(uint64_t fre_uhz);
+
+/**
+ * @brief       设置指定通道的输出频率
+ * @param       ch: 输出通道 (0-3)
+ * @param       fre_mhz: 输出频率 (0.001Hz)
+ * @retval      无
+ * @note        只改变CFTW0，相位和幅度保持不变，适合频率跳变
+ */
+extern void ad9959_set_frequency_millihz(uint8_t ch, uint64_t fre_mhz);
+
 /**
  * @brief       设置AD9959指定通道线性扫频输出
  * @param       ch: 输出通道 (0-3)
@@ -168,6 +702,141 @@ extern void ad9959_sweep_phase(uint8_t ch, double fre, uint16_t phase1, uint16_t
  */
 extern void ad9959_sweep_amplitude(uint8_t ch, double fre, uint16_t phase, uint16_t amp1, uint16_t amp2, uint16_t rdw, uint16_t fdw);
 
+/* 按时长扫描时求出的步长和斜率 */
+typedef struct
+{
+	uint32_t rdw;			/* 上升步长，扫频为频率控制字，扫相为14位相位字，扫幅为10位幅度字 */
+	uint32_t fdw;			/* 下降步长 */
+	uint8_t  rsrr;			/* 上升每步的SYNC_CLK周期数 */
+	uint8_t  fsrr;			/* 下降每步的SYNC_CLK周期数 */
+	uint64_t rise_ns;		/* 实际上升时间 */
+	uint64_t fall_ns;		/* 实际下降时间 */
+} ad9959_ramp_t;
+
+/**
+ * @brief       求扫描步长和每步周期数
+ * @param       span: 扫描范围(控制字)
+ * @param       sync: 期望时长(SYNC_CLK周期)
+ * @param       dw: 输出，步长
+ * @param       rate: 输出，每步周期数(1-255)
+ * @retval      实际时长(SYNC_CLK周期)，0表示无法实现(斜率低于每255周期1个控制字)
+ * @note        先求所有每步周期数下实际时长与期望值的最小误差，
+ *              再在误差不超过该值或期望时长0.1%的组合中取步长最小的，即扫描最平滑的
+ */
+extern uint64_t ad9959_ramp_solve(uint32_t span, uint64_t sync, uint32_t *dw, uint8_t *rate);
+
+/**
+ * @brief       按时长设置线性扫频
+ * @param       ch: 输出通道 (0-3)
+ * @param       fre1_mhz: 起始频率 (0.001Hz)
+ * @param       fre2_mhz: 终止频率 (0.001Hz)，必须大于起始频率
+ * @param       rise_us: 上升时间(us)
+ * @param       fall_us: 下降时间(us)
+ * @param       phase: 输出相位 (0-360度)
+ * @param       amp: 输出幅度 (1-1023)
+ * @param       ramp: 输出实际的步长、斜率和时间，可以为NULL
+ * @retval      0: 成功  1: 参数错误或斜率太小
+ * @note        与ad9959_sweep_frequency()相同的扫描配置，步长和RSRR/FSRR由ad9959_ramp_solve()求出
+ */
+extern uint8_t ad9959_sweep_frequency_time(uint8_t ch, uint64_t fre1_mhz, uint64_t fre2_mhz, uint32_t rise_us, uint32_t fall_us,
+										   uint16_t phase, uint16_t amp, ad9959_ramp_t *ramp);
+
+/**
+ * @brief       按时长设置线性扫相
+ * @param       ch: 输出通道 (0-3)
+ * @param       fre_mhz: 输出频率 (0.001Hz)
+ * @param       phase1: 起始相位 (度)
+ * @param       phase2: 终止相位 (度)，必须大于起始相位
+ * @param       rise_us: 上升时间(us)
+ * @param       fall_us: 下降时间(us)
+ * @param       amp: 输出幅度 (1-1023)
+ * @param       ramp: 输出实际的步长、斜率和时间，可以为NULL
+ * @retval      0: 成功  1: 参数错误或斜率太小
+ * @note        S0为CPOW0，E0、RDW、FDW中的相位字高位对齐(bit31:18)
+ */
+extern uint8_t ad9959_sweep_phase_time(uint8_t ch, uint64_t fre_mhz, uint16_t phase1, uint16_t phase2, uint32_t rise_us, uint32_t fall_us,
+									   uint16_t amp, ad9959_ramp_t *ramp);
+
+/**
+ * @brief       按时长设置线性扫幅
+ * @param       ch: 输出通道 (0-3)
+ * @param       fre_mhz: 输出频率 (0.001Hz)
+ * @param       phase: 输出相位 (度)
+ * @param       amp1: 起始幅度 (0-1023)
+ * @param       amp2: 终止幅度 (1-1023)，必须大于起始幅度
+ * @param       rise_us: 上升时间(us)
+ * @param       fall_us: 下降时间(us)
+ * @param       ramp: 输出实际的步长、斜率和时间，可以为NULL
+ * @retval      0: 成功  1: 参数错误或斜率太小
+ * @note        S0为ACR中的幅度，E0、RDW、FDW中的幅度字高位对齐(bit31:22)
+ */
+extern uint8_t ad9959_sweep_amplitude_time(uint8_t ch, uint64_t fre_mhz, uint16_t phase, uint16_t amp1, uint16_t amp2,
+										   uint32_t rise_us, uint32_t fall_us, ad9959_ramp_t *ramp);
+
+/**
+ * @brief       按当前器件的系统时钟计算FR1的高字节
+ * @param       无
+ * @retval      FR1[23:16]：PLL倍频系数和VCO增益，500MHz系统时钟时为0xD0
+ * @note        系统时钟为AD9959_REF_CLK的4-20倍时使能PLL，否则旁路PLL
+ */
+extern uint8_t ad9959_fr1_clock(void);
+
+/**
+ * @brief       初始化一个器件
+ * @param       dev: 器件，默认器件不需要初始化
+ * @param       cs_port: 片选端口
+ * @param       cs_pin: 片选引脚
+ * @param       hspi: 硬件SPI外设，可以与其它器件相同(共用总线)，软件SPI时不使用
+ * @param       sys_clk: 系统时钟(Hz)，为AD9959_REF_CLK的4-20倍或等于AD9959_REF_CLK
+ * @retval      无
+ * @note        在ad9959_init()之后调用：复位信号为各器件共用，ad9959_init()已经复位了所有芯片，
+ *              这里只拉高片选并复位影子寄存器；CubeMX中各片选引脚的初始电平应设为高
+ */
+extern void ad9959_dev_init(ad9959_dev_t *dev, GPIO_TypeDef *cs_port, uint16_t cs_pin, SPI_HandleTypeDef *hspi, uint32_t sys_clk);
+
+/**
+ * @brief       选择当前器件
+ * @param       dev: 器件
+ * @retval      之前的当前器件，用于恢复
+ * @note        之后的所有接口(写寄存器、flush、扫频等)都作用于该器件；
+ *              影子寄存器按器件保存，切换不会丢失待写数据，但IO_update是共用的，会同时更新所有器件已发送的寄存器
+ *              跳频表、扫频链等播放期间按当前器件发送，播放结束前不要切换
+ */
+extern ad9959_dev_t *ad9959_dev_select(ad9959_dev_t *dev);
+
+/**
+ * @brief       多个器件同时更新
+ * @param       devs: 器件列表
+ * @param       count: 器件数
+ * @retval      无
+ * @note        依次发送各器件的待写寄存器，最后产生一次共用的IO_update，所有器件在同一个脉冲生效
+ */
+extern void ad9959_dev_update(ad9959_dev_t *const *devs, uint8_t count);
+
+/**
+ * @brief       多个器件在指定时刻同时更新
+ * @param       devs: 器件列表
+ * @param       count: 器件数
+ * @param       when: 时间戳(AD9959_TIMER_NOW()的时基)
+ * @retval      0: 按时  1: 已迟到
+ * @note        与ad9959_update_at()相同，只是在脉冲之前发送所有器件的待写寄存器
+ */
+extern uint8_t ad9959_dev_update_at(ad9959_dev_t *const *devs, uint8_t count, uint32_t when);
+
+/**
+ * @brief       使能多器件同步
+ * @param       devs: 器件列表，devs[0]为主器件，其余为从器件
+ * @param       count: 器件数
+ * @retval      无
+ * @note        各器件FR2置位自动同步，主器件置位同步主器件，系统时钟偏移取各器件的sync_offset，
+ *              随后一次共用的IO_update使配置生效；之后各片的SYNC_CLK相位对齐，
+ *              共用的IO_update在所有器件的同一个SYNC_CLK沿生效
+ *              硬件要求：各片使用同一个参考时钟，主器件SYNC_OUT连接所有从器件的SYNC_IN，走线等长
+ */
+extern void ad9959_dev_sync(ad9959_dev_t *const *devs, uint8_t count);
 
+#ifdef __cplusplus
+}
+#endif
 
 #endif //MYAD9959_H
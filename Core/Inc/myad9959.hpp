@@ -0,0 +1,237 @@
+#ifndef MYAD9959_HPP
+#define MYAD9959_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "myad9959.h"
+
+/**
+ ****************************************************************************************************
+ * @file        myad9959.hpp
+ * @brief       AD9959编译期参数编码(C++17，仅头文件)
+ *              频率/相位/幅度在编译期换算为寄存器字节，频率计划直接生成可发送的字节数组放在Flash中，
+ *              启动时不需要任何运算。编码结果与myad9959.c中的运行时函数逐位一致(Host/tests/test_hpp.cpp)
+ *
+ *              用法：
+ *              static constexpr ad9959::channel_config cfg[] = {
+ *                  {1, 1000000000ULL, 0, 512},		// 通道1，1MHz(单位0.001Hz)，0度，幅度512
+ *                  {2, 1000000000ULL, 90, 512},
+ *              };
+ *              static constexpr auto plan = ad9959::make_plan(cfg);
+ *              ad9959::apply(plan);
+ ****************************************************************************************************
+ */
+
+namespace ad9959
+{
+
+/* 各寄存器字节长度，按地址0x00-0x18排列，与myad9959.c一致 */
+constexpr std::uint8_t reg_len[AD9959_REG_COUNT] =
+{
+	1, 3, 2,
+	3, 4, 2, 3, 2, 4, 4,
+	4, 4, 4, 4, 4, 4, 4, 4,
+	4, 4, 4, 4, 4, 4, 4
+};
+
+/* CSR中的串行模式位，帧中的CSR必须与驱动当前使用的模式一致 */
+#ifdef AD9959_USE_4BIT_SERIAL
+constexpr std::uint8_t csr_mode = AD9959_CSR_MODE_4BIT;
+#else
+constexpr std::uint8_t csr_mode = AD9959_CSR_MODE_2WIRE;
+#endif
+
+/**
+ * @brief       计算 round(num * 2^32 / den) 的低32位
+ * @note        编译期使用，移位减法长除，结果与ad9959_ratio_q32()一致
+ */
+constexpr std::uint32_t ratio_q32(std::uint64_t num, std::uint64_t den)
+{
+	std::uint64_t rem = num % den;
+	std::uint32_t q = 0;
+
+	for(int i = 0; i < 32; i++)
+	{
+		rem <<= 1;
+		q <<= 1;
+		if(rem >= den)
+		{
+			rem -= den;
+			q |= 1;
+		}
+	}
+	if((rem << 1) >= den)
+		q++;
+	return q;
+}
+
+/**
+ * @brief       由整数Hz计算频率控制字，与ad9959_ftw_from_hz()一致
+ */
+constexpr std::uint32_t ftw_hz(std::uint32_t fre_hz, std::uint64_t sys_clk = AD9959_System_Clk)
+{
+	return ratio_q32(fre_hz, sys_clk);
+}
+
+/**
+ * @brief       由毫赫兹计算频率控制字，与ad9959_ftw_from_millihz()一致
+ */
+constexpr std::uint32_t ftw_millihz(std::uint64_t fre_mhz, std::uint64_t sys_clk = AD9959_System_Clk)
+{
+	return ratio_q32(fre_mhz, sys_clk * 1000U);
+}
+
+/**
+ * @brief       由角度计算相位控制字，与C代码共用AD9959_POW_FROM_DEG()
+ * @note        与C函数相同不截取14位，360度得到0x4000(发送0x40,0x00)，芯片只使用低14位
+ */
+constexpr std::uint16_t pow_deg(std::uint16_t phase)
+{
+	return static_cast<std::uint16_t>(AD9959_POW_FROM_DEG(phase));
+}
+
+/**
+ * @brief       由幅度计算ACR，使能幅度乘法器，与AD9959_Get_ACR_Data()一致
+ */
+constexpr std::uint32_t acr(std::uint16_t amp)
+{
+	return 0x001000UL | (amp & 0x03FFU);
+}
+
+/**
+ * @brief       由系统时钟计算FR1[23:16]，与ad9959_fr1_clock()一致
+ * @note        系统时钟为参考时钟的4-20倍时使能PLL并写入倍频系数，高于255MHz时选择VCO高增益档，否则旁路PLL
+ */
+constexpr std::uint8_t fr1_clock(std::uint64_t sys_clk = AD9959_System_Clk)
+{
+	const std::uint64_t ratio = sys_clk / AD9959_REF_CLK;
+
+	if(ratio < 4 || ratio > 20)
+		return 0x00;
+	return static_cast<std::uint8_t>((ratio << 2) | (sys_clk > 255000000UL ? 0x80U : 0x00U));
+}
+
+/* 单个通道的固定输出参数 */
+struct channel_config
+{
+	std::uint8_t  ch;			/* 通道 (0-3) */
+	std::uint64_t fre_mhz;		/* 频率 (0.001Hz) */
+	std::uint16_t phase;		/* 相位 (度) */
+	std::uint16_t amp;			/* 幅度 (1-1023) */
+};
+
+/* 频率计划字节数：FR1一次，每个通道CSR+CFR+ACR+CPOW0+CFTW0 */
+constexpr std::size_t plan_bytes(std::size_t channels)
+{
+	return 4 + channels * (2 + 4 + 4 + 3 + 5);
+}
+
+/**
+ * @brief       编译期生成固定频率计划
+ * @param       chs: 各通道参数
+ * @param       sys_clk: 系统时钟(Hz)，FR1的PLL设置和频率控制字都由它得出
+ * @retval      由"指令字节+数据"组成的字节数组
+ * @note        寄存器内容与ad9959_set_signal_out()写入的一致(单频模式)
+ */
+template <std::size_t N>
+constexpr std::array<std::uint8_t, plan_bytes(N)> make_plan(const channel_config (&chs)[N],
+															 std::uint64_t sys_clk = AD9959_System_Clk)
+{
+	std::array<std::uint8_t, plan_bytes(N)> f{};
+	std::size_t i = 0;
+
+	/* FR1：PLL倍频系数和VCO增益 */
+	f[i++] = FR1;
+	f[i++] = fr1_clock(sys_clk);
+	f[i++] = 0x00;
+	f[i++] = 0x00;
+
+	for(std::size_t n = 0; n < N; n++)
+	{
+		const std::uint32_t ftw = ftw_millihz(chs[n].fre_mhz, sys_clk);
+		const std::uint16_t pw = pow_deg(chs[n].phase);
+		const std::uint32_t ac = acr(chs[n].amp);
+
+		f[i++] = CSR;
+		f[i++] = static_cast<std::uint8_t>((0x10U << chs[n].ch) | csr_mode);
+
+		f[i++] = CFR;
+		f[i++] = 0x00;
+		f[i++] = 0x23;
+		f[i++] = 0x35;
+
+		f[i++] = ACR;
+		f[i++] = static_cast<std::uint8_t>(ac >> 16);
+		f[i++] = static_cast<std::uint8_t>(ac >> 8);
+		f[i++] = static_cast<std::uint8_t>(ac);
+
+		f[i++] = CPOW0;
+		f[i++] = static_cast<std::uint8_t>(pw >> 8);
+		f[i++] = static_cast<std::uint8_t>(pw);
+
+		f[i++] = CFTW0;
+		f[i++] = static_cast<std::uint8_t>(ftw >> 24);
+		f[i++] = static_cast<std::uint8_t>(ftw >> 16);
+		f[i++] = static_cast<std::uint8_t>(ftw >> 8);
+		f[i++] = static_cast<std::uint8_t>(ftw);
+	}
+	return f;
+}
+
+/**
+ * @brief       应用预先生成的寄存器帧
+ * @param       frame: make_plan()等生成的字节数组
+ * @retval      无
+ * @note        先发送影子寄存器中待写的内容，再用AD9959_WriteFrame()原样发送整帧，最后IO_update
+ *              帧中写过的寄存器在影子寄存器中标记为未知(通道寄存器按帧中最近的CSR确定通道，
+ *              之前没有CSR时标记全部通道)，之后的写入会重新发送，不会因影子寄存器过时而被跳过
+ */
+template <std::size_t N>
+inline void apply(const std::array<std::uint8_t, N> &frame)
+{
+	std::size_t i = 0;
+	std::uint8_t chs = 0x0F;
+
+	ad9959_flush();
+	AD9959_WriteFrame(frame.data(), static_cast<std::uint16_t>(N));
+
+	while(i < N)
+	{
+		const std::uint8_t reg = frame[i];
+
+		if(reg == CSR)
+			chs = static_cast<std::uint8_t>(frame[i + 1] >> 4);
+		ad9959_shadow_forget(chs, 1UL << reg);
+		i += 1U + reg_len[reg];
+	}
+	IO_update();
+}
+
+/* 编译期自检 */
+namespace selftest
+{
+static_assert(ftw_hz(1000000) == 0x0083126FUL, "1MHz FTW");
+static_assert(ftw_hz(250000000) == 0x80000000UL, "Nyquist FTW");
+static_assert(ftw_hz(0) == 0, "DC FTW");
+static_assert(ftw_millihz(1000000000ULL) == ftw_hz(1000000), "mHz and Hz agree");
+static_assert(ftw_hz(1) == 9 && ftw_millihz(1000) == 9, "1Hz FTW rounds to nearest");
+static_assert(pow_deg(90) == 0x1000, "90 deg POW");
+static_assert(pow_deg(360) == 0x4000, "360 deg encodes like the C path");
+static_assert(fr1_clock(500000000) == 0xD0 && fr1_clock(200000000) == 0x20 && fr1_clock(25000000) == 0x00, "FR1 clock");
+static_assert(acr(512) == 0x001200UL, "ACR with multiplier enabled");
+
+constexpr channel_config test_cfg[] = {{1, 1000000000ULL, 90, 512}};
+constexpr auto test_plan = make_plan(test_cfg);
+static_assert(test_plan.size() == 22, "plan size");
+static_assert(test_plan[0] == FR1 && test_plan[1] == fr1_clock(), "PLL setting");
+static_assert(test_plan[4] == CSR && test_plan[5] == (0x20 | csr_mode), "channel select");
+static_assert(test_plan[15] == 0x10 && test_plan[16] == 0x00, "phase word");
+static_assert(test_plan[17] == CFTW0 && test_plan[18] == 0x00 && test_plan[19] == 0x83 &&
+			  test_plan[20] == 0x12 && test_plan[21] == 0x6F, "frequency word");
+}
+
+}
+
+#endif //MYAD9959_HPP
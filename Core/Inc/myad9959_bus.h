@@ -0,0 +1,66 @@
+#ifndef MYAD9959_BUS_H
+#define MYAD9959_BUS_H
+
+#include "myad9959.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************多总线并行配置*********************************************/
+/**
+ * 多片AD9959分布在几个SPI外设上(例如SPI2和SPI3)时，各总线的DMA同时发送，配置时间取决于最忙的一条总线
+ * ad9959_bus_update()先把各器件的待写寄存器收集成一帧(ad9959_flush_to())，按器件的hspi分到各总线，
+ * 每条总线依次发送自己的器件(每片一次片选)，全部总线发送完(屏障)后产生一次共用的IO_update
+ * 需要定义AD9959_USE_SPI_DMA，并在CubeMX中为每个SPI外设添加TX DMA；否则按顺序阻塞发送
+ */
+#define AD9959_BUS_MAX			2		/* SPI外设数 */
+#define AD9959_BUS_DEVS			4		/* 每个SPI外设上的最大器件数 */
+
+/**
+ * @brief       多个器件并行发送后同时更新
+ * @param       devs: 器件列表
+ * @param       count: 器件数
+ * @retval      0: 并行发送  1: 总线数或器件数超出配置，已按顺序发送(结果相同，只是更慢)
+ *              2: 有器件的帧启动DMA失败，该器件本次没有更新，其余器件照常更新
+ * @note        与ad9959_dev_update()结果相同；阻塞到IO_update产生，当前器件不变
+ *              发送失败的器件影子寄存器失效、待写寄存器恢复，下一次更新时重发
+ */
+extern uint8_t ad9959_bus_update(ad9959_dev_t *const *devs, uint8_t count);
+
+/**
+ * @brief       多个器件并行发送后在指定时刻同时更新
+ * @param       devs: 器件列表
+ * @param       count: 器件数
+ * @param       when: 时间戳(AD9959_TIMER_NOW()的时基)
+ * @retval      0: 按时  1: 已迟到  2: 有器件的帧启动DMA失败(同ad9959_bus_update())
+ * @note        发送完成后由ad9959_tim_update_at()在when产生IO_update
+ */
+extern uint8_t ad9959_bus_update_at(ad9959_dev_t *const *devs, uint8_t count, uint32_t when);
+
+/**
+ * @brief       SPI发送完成通知
+ * @param       hspi: SPI句柄
+ * @retval      1: 属于正在并行发送的总线，已处理  0: 不是
+ * @note        由ad9959_spi_tx_cplt()调用，拉高当前器件的片选并启动同一总线上的下一个器件
+ */
+extern uint8_t ad9959_bus_tx_done(SPI_HandleTypeDef *hspi);
+
+/**
+ * @brief       把器件分配到各总线，使最忙的总线字节数最少
+ * @param       bytes: 各器件每次更新的字节数
+ * @param       count: 器件数
+ * @param       nbus: 总线数 (1-AD9959_BUS_MAX)
+ * @param       bus: 输出，各器件的总线号
+ * @retval      最忙的总线的字节数(并行发送的总时长与它成正比)，0表示器件数超过nbus * AD9959_BUS_DEVS
+ * @note        穷举全部分配，结果为最优值，每条总线不超过AD9959_BUS_DEVS个器件；
+ *              器件数最多AD9959_BUS_MAX * AD9959_BUS_DEVS个，搜索量为nbus^count(默认配置最多256种)；
+ *              用于决定器件接在哪个SPI外设上
+ */
+extern uint32_t ad9959_bus_balance(const uint16_t *bytes, uint8_t count, uint8_t nbus, uint8_t *bus);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //MYAD9959_BUS_H
@@ -0,0 +1,117 @@
+#ifndef MYAD9959_CHAIN_H
+#define MYAD9959_CHAIN_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************分段硬件扫频配置*********************************************/
+/**
+ * 用芯片内置的线性扫频逐段逼近任意曲线：每段由芯片按RDW/RSRR(向上)或FDW/FSRR(向下)自动步进，
+ * 当前段运行时就把下一段的终点、步长和斜率写入I/O缓冲，段结束时刻再使其生效，段与段之间没有停顿
+ * - 同方向的两段：在段结束时刻产生IO_update(定义AD9959_USE_TIM_UPDATE时由定时器准时产生)
+ * - 换向的两段：新方向的寄存器不影响当前方向的扫描，提前生效，段结束时刻翻转通道的Profile引脚
+ * 扫频使用2级模式，通道n由Pn控制方向，Profile引脚见myad9959_mod.h
+ */
+
+/* 扫频段，由ad9959_chain_add()等计算 */
+typedef struct
+{
+	uint32_t ftw;			/* 终点频率控制字 */
+	uint32_t delta;			/* 每步频率增量(RDW或FDW)，0表示保持 */
+	uint32_t sync;			/* 实际时长(SYNC_CLK周期，系统时钟/4) */
+	uint8_t  rate;			/* 每步的SYNC_CLK周期数(RSRR或FSRR) */
+} ad9959_chain_seg_t;
+
+/* 扫频链 */
+typedef struct
+{
+	ad9959_chain_seg_t *seg;	/* 段缓冲区 */
+	uint16_t size;				/* 容量 */
+	uint16_t count;				/* 段数 */
+	uint32_t start;				/* 起点频率控制字 */
+	uint64_t end_mhz;			/* 最后一段的终点频率 (0.001Hz) */
+	uint8_t  ch;				/* 通道 (0-3) */
+} ad9959_chain_t;
+
+/**
+ * @brief       初始化扫频链
+ * @param       c: 扫频链
+ * @param       buf: 段缓冲区
+ * @param       size: 容量
+ * @param       ch: 通道 (0-3)
+ * @param       start_mhz: 起点频率 (0.001Hz)
+ * @retval      无
+ */
+extern void ad9959_chain_init(ad9959_chain_t *c, ad9959_chain_seg_t *buf, uint16_t size, uint8_t ch, uint64_t start_mhz);
+
+/**
+ * @brief       添加一段线性扫频
+ * @param       c: 扫频链
+ * @param       fre_mhz: 终点频率 (0.001Hz)，与上一段终点相同时为保持
+ * @param       time_ns: 时长(ns)
+ * @retval      0: 成功  1: 缓冲区已满、时长为0或斜率太小
+ * @note        步长和步进周期由ad9959_ramp_solve()求出，实际时长保存在段中，播放按实际时长切换；
+ *              步长最小为1个频率控制字，斜率不能低于每255个SYNC_CLK周期1个频率控制字(500MHz系统时钟时约57kHz/s)
+ */
+extern uint8_t ad9959_chain_add(ad9959_chain_t *c, uint64_t fre_mhz, uint32_t time_ns);
+
+/**
+ * @brief       用若干线性段逼近对数扫频
+ * @param       c: 扫频链
+ * @param       fre_mhz: 终点频率 (0.001Hz)
+ * @param       time_us: 总时长(us)
+ * @param       nseg: 段数
+ * @retval      0: 成功  1: 参数错误或缓冲区不足
+ * @note        分段点按等比分布(由ad9959_sweep_gen_next()生成)，每段时长相同
+ */
+extern uint8_t ad9959_chain_add_log(ad9959_chain_t *c, uint64_t fre_mhz, uint32_t time_us, uint16_t nseg);
+
+/**
+ * @brief       开始播放扫频链
+ * @param       c: 扫频链，播放期间不能修改
+ * @retval      0: 成功  1: 正在播放或扫频链为空
+ * @note        配置通道为线性扫频并从起点开始，第一段立即开始；
+ *              之后由ad9959_chain_poll()在每段开始后预装下一段；
+ *              播放直接改写芯片寄存器，影子寄存器全部失效，播放期间不能调用其它写寄存器的接口
+ */
+extern uint8_t ad9959_chain_play(const ad9959_chain_t *c);
+
+/**
+ * @brief       处理到期的段切换
+ * @param       无
+ * @retval      1: 仍在播放  0: 已结束
+ * @note        在主循环中调用，每段只需要处理一次；换向由这里翻转Profile引脚，调用间隔决定换向时刻的误差
+ *              未定义AD9959_USE_TIM_UPDATE时同方向的段切换由软件延时产生IO_update，调用会阻塞到切换时刻
+ */
+extern uint8_t ad9959_chain_poll(void);
+
+/**
+ * @brief       停止播放
+ * @param       无
+ * @retval      无
+ * @note        不再切换段，芯片按当前段继续扫到终点后停留
+ */
+extern void ad9959_chain_stop(void);
+
+/**
+ * @brief       查询是否正在播放
+ * @param       无
+ * @retval      1: 正在播放  0: 空闲
+ */
+extern uint8_t ad9959_chain_busy(void);
+
+/**
+ * @brief       查询迟到的段切换次数
+ * @param       无
+ * @retval      预装下一段时已经过了切换时刻的次数，迟到的段在终点多停留了一段时间
+ */
+extern uint16_t ad9959_chain_late(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //MYAD9959_CHAIN_H
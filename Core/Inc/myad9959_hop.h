@@ -0,0 +1,105 @@
+#ifndef MYAD9959_HOP_H
+#define MYAD9959_HOP_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************跳频表配置*********************************************/
+/**
+ * 跳频表预先把每一跳的寄存器编码为"指令字节+数据"帧，按跳连续存放，
+ * 播放时每个定时周期先产生IO_update使已预装的一跳生效，再用一次片选发送下一跳的帧，
+ * 播放路径不做任何计算，也不经过影子寄存器
+ * 定义AD9959_USE_HOP_TIM(见myad9959.h)后由TIM5更新中断驱动，否则周期调用ad9959_hop_tick()
+ */
+#define AD9959_HOP_TIM					TIM5
+#define AD9959_HOP_TIM_CLK_ENABLE()		do { RCC->APB1LENR |= RCC_APB1LENR_TIM5EN; (void)RCC->APB1LENR; } while(0)
+#define AD9959_HOP_IRQn					TIM5_IRQn
+#define AD9959_HOP_IRQHandler			TIM5_IRQHandler
+#define AD9959_HOP_IRQ_PRIO				1
+
+/* 每跳帧的字节数：CFTW0 5字节，可选CPOW0 3字节、ACR 4字节 */
+#define AD9959_HOP_FRAME_BYTES(phase, amp)	(5 + ((phase) ? 3 : 0) + ((amp) ? 4 : 0))
+
+/**
+ * 流式播放的填充回调：把最多frames跳的帧写入buf，返回写入的跳数，少于frames表示数据结束
+ * 在播放中断中调用，应当只做整数运算和内存写入
+ */
+typedef uint32_t (*ad9959_hop_refill_t)(uint8_t *buf, uint32_t frames, void *ctx);
+
+/* 跳频表 */
+typedef struct
+{
+	uint8_t *buf;			/* 帧缓冲区，count * frame字节 */
+	uint32_t size;			/* 缓冲区容量(字节) */
+	uint32_t count;			/* 跳数 */
+	uint8_t  frame;			/* 每跳字节数 */
+	uint8_t  ch;			/* 通道 (0-3) */
+	ad9959_hop_refill_t refill;	/* 非NULL时流式播放：表作为双缓冲区，播放完一半就调用它重新填充 */
+	void    *ctx;			/* 传给refill的参数 */
+} ad9959_hop_table_t;
+
+/**
+ * @brief       生成跳频表
+ * @param       table: 跳频表，buf和size由调用者设置
+ * @param       ch: 通道 (0-3)
+ * @param       fre_mhz: 各跳频率 (0.001Hz)
+ * @param       phase: 各跳相位 (度)，NULL表示不改变相位
+ * @param       amp: 各跳幅度 (1-1023)，NULL表示不改变幅度
+ * @param       count: 跳数
+ * @retval      0: 成功  1: 缓冲区不足
+ * @note        phase/amp是否为NULL决定每跳的帧长，整张表的帧长相同
+ */
+extern uint8_t ad9959_hop_build(ad9959_hop_table_t *table, uint8_t ch, const uint64_t *fre_mhz,
+								const uint16_t *phase, const uint16_t *amp, uint32_t count);
+
+/**
+ * @brief       开始播放跳频表
+ * @param       table: 跳频表，播放期间不能修改
+ * @param       rate: 跳速(每秒跳数)
+ * @param       loop: 1: 循环播放  0: 播放一遍后停在最后一跳，流式播放时忽略
+ * @retval      0: 成功  1: 正在播放或表为空
+ * @note        流式播放时count必须为偶数，开始前由refill填满两半，数据结束后停在最后一跳；
+ *              先发送影子寄存器中的待写数据并选中通道，再预装第一跳；
+ *              播放会直接改写芯片寄存器，所以影子寄存器全部失效，之后的写入会完整重发
+ */
+extern uint8_t ad9959_hop_play(const ad9959_hop_table_t *table, uint32_t rate, uint8_t loop);
+
+/**
+ * @brief       停止播放
+ * @param       无
+ * @retval      无
+ * @note        当前一跳保持输出
+ */
+extern void ad9959_hop_stop(void);
+
+/**
+ * @brief       查询是否正在播放
+ * @param       无
+ * @retval      1: 正在播放  0: 空闲
+ */
+extern uint8_t ad9959_hop_busy(void);
+
+/**
+ * @brief       播放一跳
+ * @param       无
+ * @retval      1: 仍在播放  0: 已停止
+ * @note        产生IO_update使预装的一跳生效，然后预装下一跳；
+ *              由TIM5中断调用，未定义AD9959_USE_HOP_TIM时按跳速周期调用
+ */
+extern uint8_t ad9959_hop_tick(void);
+
+/**
+ * @brief       查询已生效的跳数
+ * @param       无
+ * @retval      跳数，循环播放时累加
+ */
+extern uint32_t ad9959_hop_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //MYAD9959_HOP_H
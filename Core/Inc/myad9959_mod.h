@@ -0,0 +1,91 @@
+#ifndef MYAD9959_MOD_H
+#define MYAD9959_MOD_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************Profile引脚配置*********************************************/
+/**
+ * AD9959的P0-P3引脚选择调制字：符号0对应CFTW0/CPOW0/ACR，符号1-15对应CW1-CW15，
+ * 切换引脚即可改变输出，不需要SPI和IO_update，符号速率只受GPIO(或定时器+DMA)限制
+ * P0-P3必须接在同一端口的连续引脚上(P0为最低位)，这样一个符号只需一次BSRR写入
+ * 默认取CubeMX中标为AD9959_P0-AD9959_P3的引脚(main.h)，没有这些标签时在此处或编译选项中定义
+ */
+#ifndef AD9959_PROFILE_GPIO_Port
+#define AD9959_PROFILE_GPIO_Port		AD9959_P0_GPIO_Port
+#endif
+#ifndef AD9959_PROFILE_PIN_SHIFT
+#define AD9959_PROFILE_PIN_SHIFT		__builtin_ctz(AD9959_P0_Pin)	/* P0所在的引脚号，P0-P3依次为PIN_SHIFT ~ PIN_SHIFT+3 */
+#endif
+#ifndef AD9959_PROFILE_CLK_ENABLE
+#define AD9959_PROFILE_CLK_ENABLE()		__HAL_RCC_GPIOE_CLK_ENABLE()
+#endif
+
+/* 调制类型，即CFR[23:22]幅度/频率/相位选择 */
+#define AD9959_MOD_AMP			0x01	/* ASK：调制字为10位幅度 */
+#define AD9959_MOD_FRE			0x02	/* FSK：调制字为32位频率控制字 */
+#define AD9959_MOD_PHASE		0x03	/* PSK：调制字为14位相位控制字 */
+#define AD9959_MOD_GRAY			0x80	/* 与调制类型相或：编码器按格雷码映射符号 */
+
+/**
+ * @brief       初始化Profile引脚
+ * @param       无
+ * @retval      无
+ * @note        P0-P3配置为推挽输出并拉低(符号0)
+ */
+extern void ad9959_mod_init(void);
+
+/**
+ * @brief       配置通道调制并装载调制字
+ * @param       ch: 通道 (0-3)
+ * @param       type: AD9959_MOD_AMP/FRE/PHASE，可以或上AD9959_MOD_GRAY
+ * @param       levels: 调制级数 2/4/8/16
+ * @param       words: levels个调制字，words[0]写入CFTW0/CPOW0/ACR，words[n]写入CWn
+ *                     频率为ad9959_ftw_from_millihz()的结果，相位为0-16383，幅度为0-1023
+ * @retval      0: 成功  1: 参数错误
+ * @note        FR1的调制级数和Profile引脚配置是全局的：
+ *              2级时通道n使用Pn；4级时通道使用一对引脚(通道3为P2/P3，其余为P0/P1)；8/16级时使用P0-P2/P0-P3，同一时间只能调制一个通道
+ *              配置完成后产生IO_update并输出符号0
+ */
+extern uint8_t ad9959_mod_config(uint8_t ch, uint8_t type, uint8_t levels, const uint32_t *words);
+
+/**
+ * @brief       查询每个符号的比特数
+ * @param       无
+ * @retval      log2(levels)，未配置时为0
+ */
+extern uint8_t ad9959_mod_bits(void);
+
+/**
+ * @brief       计算输出一个符号的BSRR值
+ * @param       sym: 符号 (0 ~ levels-1)
+ * @retval      写入AD9959_PROFILE_GPIO_Port->BSRR的值，只改变当前通道使用的引脚
+ */
+extern uint32_t ad9959_mod_bsrr(uint8_t sym);
+
+/**
+ * @brief       输出一个符号
+ * @param       sym: 符号 (0 ~ levels-1)
+ * @retval      无
+ */
+extern void ad9959_mod_symbol(uint8_t sym);
+
+/**
+ * @brief       把比特流编码为符号序列的BSRR值
+ * @param       data: 比特流，每字节高位在前
+ * @param       nbits: 比特数，不足一个符号的尾部补0
+ * @param       out: 输出，每个符号一个BSRR值，可以直接用DMA写入GPIO端口
+ * @param       max: 输出缓冲区容量
+ * @retval      编码的符号数
+ * @note        每个符号log2(levels)位，配置了AD9959_MOD_GRAY时按格雷码映射
+ */
+extern uint32_t ad9959_mod_encode(const uint8_t *data, uint32_t nbits, uint32_t *out, uint32_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //MYAD9959_MOD_H
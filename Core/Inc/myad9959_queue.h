@@ -0,0 +1,118 @@
+#ifndef MYAD9959_QUEUE_H
+#define MYAD9959_QUEUE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************队列容量配置*********************************************/
+#define AD9959_QUEUE_DEPTH		32		/* 队列最多容纳的事务数 */
+#define AD9959_QUEUE_BUF_SIZE	512		/* 事务数据缓冲区字节数 */
+#define AD9959_QUEUE_MAX_FRAME	(AD9959_QUEUE_BUF_SIZE / 2)	/* 一个事务的最大字节数(含指令字节) */
+
+/* 临界区宏定义 - 默认使用PRIMASK关中断，主机测试时可在包含本文件前重新定义 */
+#ifndef AD9959_QUEUE_LOCK
+#define AD9959_QUEUE_LOCK()		uint32_t primask_ = __get_PRIMASK(); __disable_irq()
+#define AD9959_QUEUE_UNLOCK()	__set_PRIMASK(primask_)
+#endif
+
+/* 是否在中断中 - 默认读取IPSR，主机测试时可在包含本文件前重新定义 */
+#ifndef AD9959_QUEUE_IN_ISR
+#define AD9959_QUEUE_IN_ISR()	(__get_IPSR() != 0U)
+#endif
+
+/**
+ * @brief       批次完成回调函数类型
+ * @param       ctx: 入队时传入的用户参数
+ */
+typedef void (*ad9959_queue_cb_t)(void *ctx);
+
+/**
+ * @brief       队列底层传输接口
+ * @note        start启动一次异步发送，发送完成后必须调用ad9959_queue_tx_done()
+ *              start返回0表示启动成功，非0表示失败(该事务会被丢弃并计入错误数)
+ *              主机测试时可以用假的SPI后端实现这三个函数
+ */
+typedef struct
+{
+	void    (*cs)(uint8_t level);							/* 片选控制 */
+	uint8_t (*start)(const uint8_t *buf, uint16_t len);		/* 启动异步发送 */
+	void    (*io_update)(void);								/* 产生IO_update脉冲 */
+} ad9959_queue_ops_t;
+
+/**
+ * @brief       初始化事务队列
+ * @param       ops: 底层传输接口
+ * @retval      无
+ * @note        会丢弃队列中所有未发送的事务
+ */
+extern void ad9959_queue_init(const ad9959_queue_ops_t *ops);
+
+/**
+ * @brief       寄存器写入事务入队
+ * @param       reg: 寄存器地址
+ * @param       len: 数据字节数
+ * @param       data: 数据指针，入队时会拷贝，调用后即可修改
+ * @retval      0: 成功  1: 在中断中调用时队列已满，事务被丢弃(计入错误数)
+ * @note        指令字节与数据合并为一次传输，在一次片选内完成
+ *              主循环中队列已满时等待SPI完成中断把事务发送出去；
+ *              中断(例如跳频定时器)中不等待，因为该中断可能比SPI DMA中断优先级高，等待会死锁
+ */
+extern uint8_t ad9959_queue_write(uint8_t reg, uint8_t len, const uint8_t *data);
+
+/**
+ * @brief       一帧数据入队
+ * @param       buf: 数据指针，入队时会拷贝
+ * @param       len: 字节数
+ * @retval      0: 成功  1: 超过AD9959_QUEUE_MAX_FRAME(没有入队)，或在中断中调用时队列已满
+ * @note        整帧在一次片选内用一次DMA传输发送；等待规则与ad9959_queue_write()相同
+ */
+extern uint8_t ad9959_queue_frame(const uint8_t *buf, uint16_t len);
+
+/**
+ * @brief       IO_update标记入队
+ * @param       cb: 脉冲发出后调用的回调函数，可以为NULL
+ * @param       ctx: 传给回调函数的参数
+ * @retval      0: 成功  1: 在中断中调用时队列已满
+ * @note        标记之前入队的写入全部发送完成后才会产生IO_update脉冲
+ *              回调在SPI完成中断中执行；等待规则与ad9959_queue_write()相同
+ */
+extern uint8_t ad9959_queue_io_update(ad9959_queue_cb_t cb, void *ctx);
+
+/**
+ * @brief       当前传输完成通知
+ * @param       无
+ * @retval      无
+ * @note        由底层传输的完成中断调用，释放片选并启动下一个事务
+ */
+extern void ad9959_queue_tx_done(void);
+
+/**
+ * @brief       查询队列是否还有未完成的事务
+ * @param       无
+ * @retval      1: 忙  0: 空闲
+ */
+extern uint8_t ad9959_queue_busy(void);
+
+/**
+ * @brief       等待队列中所有事务完成
+ * @param       无
+ * @retval      无
+ * @note        不能在比SPI DMA中断优先级高的中断中调用
+ */
+extern void ad9959_queue_wait(void);
+
+/**
+ * @brief       获取被丢弃的事务数
+ * @param       无
+ * @retval      启动失败或在中断中因队列已满而丢弃的事务数
+ */
+extern uint32_t ad9959_queue_errors(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //MYAD9959_QUEUE_H
@@ -0,0 +1,86 @@
+#ifndef MYAD9959_SCHED_H
+#define MYAD9959_SCHED_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************定时更新调度器配置*********************************************/
+#define AD9959_SCHED_DEPTH			32		/* 最多容纳的待执行事件数(编译期固定) */
+#define AD9959_SCHED_HORIZON_US		10000	/* 距离生效时刻小于该值(us)时才预装寄存器并预约IO_update */
+
+/* 事件要修改的参数 */
+#define AD9959_SCHED_FRE			0x01	/* 频率 */
+#define AD9959_SCHED_PHASE			0x02	/* 相位 */
+#define AD9959_SCHED_AMP			0x04	/* 幅度 */
+
+/* 一个定时参数修改事件 */
+typedef struct
+{
+	uint32_t when;			/* 生效时刻，AD9959_TIMER_NOW()时间基准 */
+	uint8_t  ch;			/* 通道 (0-3) */
+	uint8_t  flags;			/* AD9959_SCHED_FRE/PHASE/AMP组合 */
+	uint16_t phase;			/* 相位 (度) */
+	uint16_t amp;			/* 幅度 (1-1023) */
+	uint64_t fre_mhz;		/* 频率 (0.001Hz) */
+} ad9959_sched_event_t;
+
+/* 执行统计 */
+typedef struct
+{
+	uint32_t updates;		/* 已产生的IO_update次数(同一时刻的事件合并为一次) */
+	uint32_t events;		/* 已执行的事件数 */
+	uint32_t late;			/* 迟到的IO_update次数 */
+	uint32_t max_late;		/* 最大迟到量(时间基准计数) */
+	uint32_t rejected;		/* 队列已满被拒绝的事件数 */
+} ad9959_sched_stats_t;
+
+/**
+ * @brief       初始化调度器，清空所有事件和统计
+ * @param       无
+ * @retval      无
+ * @note        在ad9959_init()之后调用
+ */
+extern void ad9959_sched_init(void);
+
+/**
+ * @brief       添加一个事件
+ * @param       ev: 事件，调用时拷贝
+ * @retval      0: 成功  1: 队列已满
+ * @note        不能与ad9959_sched_poll()在不同的中断优先级中同时调用
+ */
+extern uint8_t ad9959_sched_add(const ad9959_sched_event_t *ev);
+
+/**
+ * @brief       调度器处理
+ * @param       无
+ * @retval      无
+ * @note        在主循环或周期定时中断中反复调用，调用间隔应小于AD9959_SCHED_HORIZON_US
+ *              最早的事件进入预装窗口且上一次IO_update已经产生后，发送该时刻所有事件的寄存器，
+ *              再由ad9959_update_at()在生效时刻产生IO_update；
+ *              AD9959每个通道只有一组I/O缓冲，下一时刻的寄存器必须等上一次IO_update之后才能预装
+ *              未定义AD9959_USE_TIM_UPDATE时会阻塞到生效时刻
+ */
+extern void ad9959_sched_poll(void);
+
+/**
+ * @brief       查询待执行事件数
+ * @param       无
+ * @retval      事件数
+ */
+extern uint16_t ad9959_sched_pending(void);
+
+/**
+ * @brief       获取执行统计
+ * @param       stats: 输出
+ * @retval      无
+ */
+extern void ad9959_sched_get_stats(ad9959_sched_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //MYAD9959_SCHED_H
@@ -0,0 +1,95 @@
+#ifndef MYAD9959_STREAM_H
+#define MYAD9959_STREAM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************Profile引脚符号流配置*********************************************/
+/**
+ * 符号按ad9959_mod_config()的配置编码为BSRR值，存放在双缓冲区中循环输出：
+ * 定义AD9959_USE_STREAM_DMA(见myad9959.h)后由定时器更新事件触发DMA写入GPIO的BSRR，
+ * 输出完一半时中断回调重新填充这一半，CPU只在每半个缓冲区处理一次；
+ * 未定义时由ad9959_stream_tick()逐个符号输出(可在任意定时中断中调用，主机构建也走这条路径)
+ * 缓冲区不能位于DTCM(DMA1/DMA2无法访问)，FLASH链接脚本中.bss位于RAM_D1，满足要求
+ */
+#define AD9959_STREAM_HALF				256		/* 半个缓冲区的符号数 */
+
+#define AD9959_STREAM_TIM				TIM2
+#define AD9959_STREAM_TIM_CLK_ENABLE()	do { RCC->APB1LENR |= RCC_APB1LENR_TIM2EN; (void)RCC->APB1LENR; } while(0)
+#define AD9959_STREAM_DMA				DMA2_Stream1
+#define AD9959_STREAM_DMAMUX			DMAMUX1_Channel9		/* DMA2_Streamn对应DMAMUX1通道8+n */
+#define AD9959_STREAM_DMA_REQ			DMA_REQUEST_TIM2_UP
+#define AD9959_STREAM_DMA_CLK_ENABLE()	__HAL_RCC_DMA2_CLK_ENABLE()
+#define AD9959_STREAM_DMA_ISR			(DMA2->LISR)
+#define AD9959_STREAM_DMA_IFCR			(DMA2->LIFCR)
+#define AD9959_STREAM_DMA_HT			DMA_LISR_HTIF1
+#define AD9959_STREAM_DMA_TC			DMA_LISR_TCIF1
+#define AD9959_STREAM_DMA_ALL			(DMA_LISR_FEIF1 | DMA_LISR_DMEIF1 | DMA_LISR_TEIF1 | DMA_LISR_HTIF1 | DMA_LISR_TCIF1)
+#define AD9959_STREAM_IRQn				DMA2_Stream1_IRQn
+#define AD9959_STREAM_IRQHandler		DMA2_Stream1_IRQHandler
+#define AD9959_STREAM_IRQ_PRIO			1
+
+/**
+ * 符号数据源：把nbits个比特(每符号ad9959_mod_bits()位，每字节高位在前)写入data，
+ * 返回实际提供的比特数，少于nbits表示数据结束
+ * 在DMA中断中调用，应当只做内存拷贝
+ */
+typedef uint32_t (*ad9959_stream_src_t)(void *ctx, uint8_t *data, uint32_t nbits);
+
+/**
+ * @brief       开始输出符号流
+ * @param       rate: 符号速率(Hz)
+ * @param       src: 符号数据源
+ * @param       ctx: 传给数据源的参数
+ * @retval      0: 成功  1: 正在输出或未配置调制
+ * @note        先调用ad9959_mod_init()和ad9959_mod_config()；
+ *              数据结束后剩余位置输出符号0，结束的半个缓冲区输出完后自动停止
+ */
+extern uint8_t ad9959_stream_start(uint32_t rate, ad9959_stream_src_t src, void *ctx);
+
+/**
+ * @brief       立即停止输出
+ * @param       无
+ * @retval      无
+ * @note        Profile引脚回到符号0
+ */
+extern void ad9959_stream_stop(void);
+
+/**
+ * @brief       查询是否正在输出
+ * @param       无
+ * @retval      1: 正在输出  0: 空闲
+ */
+extern uint8_t ad9959_stream_busy(void);
+
+/**
+ * @brief       半个缓冲区输出完成
+ * @param       half: 0前半，1后半
+ * @retval      无
+ * @note        由DMA中断(或ad9959_stream_tick())调用：从数据源重新填充这一半，数据已结束时停止
+ */
+extern void ad9959_stream_half_cplt(uint8_t half);
+
+/**
+ * @brief       软件输出下一个符号
+ * @param       无
+ * @retval      1: 仍在输出  0: 已停止
+ * @note        未定义AD9959_USE_STREAM_DMA时按符号速率周期调用
+ */
+extern uint8_t ad9959_stream_tick(void);
+
+/**
+ * @brief       查询已从数据源取得的符号数
+ * @param       无
+ * @retval      符号数
+ */
+extern uint32_t ad9959_stream_symbols(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //MYAD9959_STREAM_H
@@ -0,0 +1,88 @@
+#ifndef MYAD9959_SWEEP_H
+#define MYAD9959_SWEEP_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************软件扫频配置*********************************************/
+/**
+ * 芯片内置扫频只有线性一种，软件扫频在播放时逐点计算频率控制字，经跳频表的流式播放
+ * (见myad9959_hop.h)每点发送一次CFTW0并产生IO_update，可以实现对数扫频和多段折线扫频
+ * 频率控制字以Q32.32定点数递推：线性段每点加一个固定增量，对数段每点乘一个固定比例，
+ * 只用32位乘法，不调用pow/log，点数只受32位计数限制，内存占用与点数无关
+ */
+#define AD9959_SWEEP_RING				128		/* 播放缓冲区的点数，每点5字节，必须为偶数 */
+
+/* 扫频段形状 */
+#define AD9959_SWEEP_LIN		0		/* 线性：频率等差 */
+#define AD9959_SWEEP_LOG		1		/* 对数：频率等比，即频率随时间指数变化 */
+
+/* 扫频段：从上一段的终点(第一段从起始频率)扫到fre_mhz */
+typedef struct
+{
+	uint64_t fre_mhz;		/* 终点频率 (0.001Hz) */
+	uint32_t points;		/* 点数，不含起点，包含终点 */
+	uint8_t  shape;			/* AD9959_SWEEP_LIN / AD9959_SWEEP_LOG */
+} ad9959_sweep_seg_t;
+
+/* 扫频生成器状态 */
+typedef struct
+{
+	const ad9959_sweep_seg_t *seg;
+	uint16_t nseg;
+	uint16_t idx;			/* 当前段 */
+	uint32_t left;			/* 当前段剩余点数 */
+	uint64_t acc;			/* 当前频率控制字，Q32.32 */
+	uint64_t end;			/* 当前段终点频率控制字，Q32.32 */
+	uint64_t step;			/* 线性段每点增量，Q32.32 */
+	uint32_t m_hi;			/* 对数段每点比例与1之差的绝对值，Q0.64的高32位 */
+	uint32_t m_lo;			/* 低32位 */
+	uint8_t  down;			/* 频率递减 */
+	uint8_t  first;			/* 起点尚未输出 */
+} ad9959_sweep_gen_t;
+
+/**
+ * @brief       初始化扫频生成器
+ * @param       g: 生成器
+ * @param       start_mhz: 起始频率 (0.001Hz)
+ * @param       seg: 扫频段，生成期间不能修改
+ * @param       nseg: 段数
+ * @retval      0: 成功  1: 参数错误
+ * @note        对数段的起止频率不能为0，且每点的频率比必须在1/2到2之间；
+ *              对数段的比例在每段开始时计算一次，不依赖libm
+ */
+extern uint8_t ad9959_sweep_gen_init(ad9959_sweep_gen_t *g, uint64_t start_mhz,
+									 const ad9959_sweep_seg_t *seg, uint16_t nseg);
+
+/**
+ * @brief       生成后续的频率控制字
+ * @param       g: 生成器
+ * @param       ftw: 输出
+ * @param       max: 输出容量
+ * @retval      生成的个数，少于max表示扫频结束
+ * @note        第一个为起始频率，每段的终点直接取终点频率的控制字，误差不会跨段累积
+ */
+extern uint32_t ad9959_sweep_gen_next(ad9959_sweep_gen_t *g, uint32_t *ftw, uint32_t max);
+
+/**
+ * @brief       播放软件扫频
+ * @param       ch: 通道 (0-3)
+ * @param       start_mhz: 起始频率 (0.001Hz)
+ * @param       seg: 扫频段，播放期间不能修改
+ * @param       nseg: 段数
+ * @param       rate: 每秒点数
+ * @retval      0: 成功  1: 参数错误或跳频表正在播放
+ * @note        占用跳频表的播放器，由TIM5中断或ad9959_hop_tick()驱动，用ad9959_hop_busy()查询是否结束，
+ *              结束后停在最后一段的终点频率
+ */
+extern uint8_t ad9959_sweep_play(uint8_t ch, uint64_t start_mhz,
+								 const ad9959_sweep_seg_t *seg, uint16_t nseg, uint32_t rate);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //MYAD9959_SWEEP_H
@@ -0,0 +1,65 @@
+#ifndef MYAD9959_TIM_H
+#define MYAD9959_TIM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************IO_update定时器配置*********************************************/
+/**
+ * 定义AD9959_USE_TIM_UPDATE(见myad9959.h)后，IO_update脉冲由定时器单脉冲模式在UD引脚上直接输出，
+ * CPU只写几个寄存器就返回，脉冲时刻不受中断影响，也可以预约在指定时刻产生
+ * UD引脚必须是定时器的通道4，默认PD15 = TIM4_CH4(AF2)；未定义时使用GPIO软件脉冲
+ * HAL的TIM模块未启用，这里直接操作寄存器
+ */
+#define AD9959_UPDATE_TIM				TIM4
+#define AD9959_UPDATE_TIM_AF			GPIO_AF2_TIM4
+#define AD9959_UPDATE_TIM_CLK_ENABLE()	do { RCC->APB1LENR |= RCC_APB1LENR_TIM4EN; (void)RCC->APB1LENR; } while(0)
+
+/**
+ * @brief       初始化IO_update定时器
+ * @param       无
+ * @retval      无
+ * @note        把UD引脚切换为定时器输出，ad9959_init()会自动调用
+ *              软件模式下为空操作
+ */
+extern void ad9959_tim_init(void);
+
+/**
+ * @brief       延时指定时间后产生IO_update脉冲
+ * @param       delay_ns: 距离现在的时间(ns)，0表示立即产生
+ * @retval      无
+ * @note        定时器模式下立即返回；如果上一个脉冲还没结束，先等待它结束
+ *              软件模式下阻塞延时后用GPIO产生脉冲
+ */
+extern void ad9959_tim_update_after(uint32_t delay_ns);
+
+/**
+ * @brief       在指定时刻产生IO_update脉冲
+ * @param       when: 时间戳，与AD9959_TIMER_NOW()同一时间基准
+ * @retval      0: 按时预约  1: 时刻已过，立即产生
+ */
+extern uint8_t ad9959_tim_update_at(uint32_t when);
+
+/**
+ * @brief       查询定时器脉冲是否还未结束
+ * @param       无
+ * @retval      1: 未结束  0: 空闲
+ */
+extern uint8_t ad9959_tim_busy(void);
+
+/**
+ * @brief       计算APB1定时器(TIM2-TIM7等)的计数时钟
+ * @param       无
+ * @retval      Hz
+ * @note        只在使用了硬件定时器(AD9959_USE_TIM_UPDATE/STREAM_DMA/HOP_TIM)时编译
+ */
+extern uint32_t ad9959_tim_get_clk(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //MYAD9959_TIM_H
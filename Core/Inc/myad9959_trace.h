@@ -0,0 +1,110 @@
+#ifndef MYAD9959_TRACE_H
+#define MYAD9959_TRACE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************性能统计配置*********************************************/
+/******* 取消注释下面的宏定义以记录每次API调用的总线流量和耗时，注释掉则所有统计代码不参与编译 *******/
+//#define AD9959_USE_TRACE
+
+#define AD9959_TRACE_DEPTH		64		/* 最近事件环形缓冲区容量 */
+
+/* 时间戳使用myad9959.h中的AD9959_TIMER_NOW()时间基准 */
+
+/* 被统计的API */
+#define AD9959_TRACE_API_WRITE		0	/* AD9959_WriteData_Unified() */
+#define AD9959_TRACE_API_UPDATE		1	/* IO_update() / ad9959_update_async() */
+#define AD9959_TRACE_API_FLUSH		2	/* ad9959_flush() */
+#define AD9959_TRACE_API_COUNT		3
+
+/* 一次API调用的记录 */
+typedef struct
+{
+	uint8_t  api;			/* AD9959_TRACE_API_xxx */
+	uint8_t  reg;			/* 写入的寄存器地址(仅AD9959_TRACE_API_WRITE) */
+	uint16_t bytes;			/* 发送的字节数(含指令字节) */
+	uint16_t frames;		/* SPI传输次数，每次传输一次片选 */
+	uint16_t updates;		/* IO_update脉冲数 */
+	uint32_t start;			/* 开始时间戳 */
+	uint32_t ticks;			/* 耗时 */
+} ad9959_trace_event_t;
+
+/* 累计统计 */
+typedef struct
+{
+	uint32_t calls[AD9959_TRACE_API_COUNT];		/* 调用次数 */
+	uint64_t ticks[AD9959_TRACE_API_COUNT];		/* 总耗时 */
+	uint32_t max_ticks[AD9959_TRACE_API_COUNT];	/* 最长一次耗时 */
+	uint32_t bytes;								/* 总字节数 */
+	uint32_t frames;							/* 总传输(片选)次数 */
+	uint32_t updates;							/* 总IO_update次数 */
+	uint32_t events;							/* 已记录的事件总数(环形缓冲区只保留最近的) */
+} ad9959_trace_stats_t;
+
+#ifdef AD9959_USE_TRACE
+
+/* 驱动内部的统计点 */
+#define AD9959_TRACE_BEGIN(api, reg)	ad9959_trace_begin((api), (reg))
+#define AD9959_TRACE_END()				ad9959_trace_end()
+#define AD9959_TRACE_FRAME(len)			ad9959_trace_frame(len)
+#define AD9959_TRACE_UPDATE()			ad9959_trace_update()
+
+/**
+ * @brief       初始化统计，启动时间戳计数器
+ * @param       无
+ * @retval      无
+ */
+extern void ad9959_trace_init(void);
+
+/**
+ * @brief       清零所有统计和事件
+ * @param       无
+ * @retval      无
+ */
+extern void ad9959_trace_reset(void);
+
+/**
+ * @brief       获取累计统计的快照
+ * @param       stats: 输出
+ * @retval      无
+ */
+extern void ad9959_trace_snapshot(ad9959_trace_stats_t *stats);
+
+/**
+ * @brief       读取最近的事件
+ * @param       events: 输出缓冲区，按时间先后排列
+ * @param       max: 输出缓冲区容量
+ * @retval      读出的事件数
+ */
+extern uint16_t ad9959_trace_recent(ad9959_trace_event_t *events, uint16_t max);
+
+/**
+ * @brief       时间戳计数换算为纳秒
+ * @param       ticks: 计数值
+ * @retval      纳秒
+ */
+extern uint32_t ad9959_trace_ns(uint32_t ticks);
+
+extern void ad9959_trace_begin(uint8_t api, uint8_t reg);
+extern void ad9959_trace_end(void);
+extern void ad9959_trace_frame(uint16_t len);
+extern void ad9959_trace_update(void);
+
+#else
+
+#define AD9959_TRACE_BEGIN(api, reg)	do { } while(0)
+#define AD9959_TRACE_END()				do { } while(0)
+#define AD9959_TRACE_FRAME(len)			do { } while(0)
+#define AD9959_TRACE_UPDATE()			do { } while(0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //MYAD9959_TRACE_H
@@ -44,12 +44,16 @@ void MX_GPIO_Init(void)
   GPIO_InitTypeDef GPIO_InitStruct = {0};
 
   /* GPIO Ports Clock Enable */
+  __HAL_RCC_GPIOE_CLK_ENABLE();
   __HAL_RCC_GPIOH_CLK_ENABLE();
   __HAL_RCC_GPIOB_CLK_ENABLE();
   __HAL_RCC_GPIOD_CLK_ENABLE();
   __HAL_RCC_GPIOC_CLK_ENABLE();
   __HAL_RCC_GPIOA_CLK_ENABLE();
 
+  /*Configure GPIO pin Output Level */
+  HAL_GPIO_WritePin(GPIOE, AD9959_P2_Pin|AD9959_P3_Pin|AD9959_P0_Pin|AD9959_P1_Pin, GPIO_PIN_RESET);
+
   /*Configure GPIO pin Output Level */
   HAL_GPIO_WritePin(GPIOD, AD9959_PDC_Pin|AD9959_RST_Pin|AD9959_SD3_Pin|AD9959_SD2_Pin
                           |AD9959_SD1_Pin|AD9959_SD0_Pin|AD9959_CLK_Pin|AD9959_UD_Pin, GPIO_PIN_RESET);
@@ -57,6 +61,13 @@ void MX_GPIO_Init(void)
   /*Configure GPIO pin Output Level */
   HAL_GPIO_WritePin(AD9959_CS_GPIO_Port, AD9959_CS_Pin, GPIO_PIN_RESET);
 
+  /*Configure GPIO pins : AD9959_P2_Pin AD9959_P3_Pin AD9959_P0_Pin AD9959_P1_Pin */
+  GPIO_InitStruct.Pin = AD9959_P2_Pin|AD9959_P3_Pin|AD9959_P0_Pin|AD9959_P1_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+  HAL_GPIO_Init(GPIOE, &GPIO_InitStruct);
+
   /*Configure GPIO pins : AD9959_PDC_Pin AD9959_RST_Pin AD9959_SD3_Pin AD9959_SD2_Pin
                            AD9959_SD1_Pin AD9959_SD0_Pin AD9959_CLK_Pin AD9959_UD_Pin */
   GPIO_InitStruct.Pin = AD9959_PDC_Pin|AD9959_RST_Pin|AD9959_SD3_Pin|AD9959_SD2_Pin
@@ -98,9 +98,14 @@ int main(void)
   // 初始化AD9959芯片（GPIO初始化已由MX_GPIO_Init()完成）
   ad9959_init();
 
-  ad9959_set_signal_out(1, 1000000, 0, 512);  // 设置通道0输出1MHz正弦波，幅度512
-  ad9959_set_signal_out(2, 1000000, 90, 512);  // 设置通道1输出1MHz正弦波，幅度512
-  ad9959_set_signal_out(3, 1000000, 180, 512);  // 设置通道2输出1MHz正弦波，幅度512
+  // 通道1-3输出1MHz正弦波，幅度512，相位依次为0/90/180度，相位累加器同时清零后一起启动
+  static const ad9959_channel_cfg_t out_cfg[] =
+  {
+    {1, 0,   512, 1000000000ULL},
+    {2, 90,  512, 1000000000ULL},
+    {3, 180, 512, 1000000000ULL},
+  };
+  ad9959_start_coherent(out_cfg, 3);
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -3,8 +3,10 @@
 //
 
 #include "myad9959.h"
+#include "myad9959_bus.h"
 
 #include "spi.h"
+#include <string.h>
 
 /**
  ****************************************************************************************************
@@ -18,38 +20,121 @@
  ****************************************************************************************************
  */
 
-/* AD9959系统时钟频率设定为500MHz，影响频率分辨率和最大输出频率 */
-#define AD9959_System_Clk 500000000
+/* 纳秒换算为时间基准计数的系数(Q16)，由ad9959_delay_init()计算 */
+static uint32_t ad9959_ticks_per_ns_q16;
 
-/* AD9959延时宏定义 - 便于移植时修改 */
-#define AD9959_DELAY(x)   ad9959_delay(x)
+/* 默认器件：myad9959.h中的片选引脚和SPI外设 */
+ad9959_dev_t ad9959_dev_default =
+{
+	AD9959_CS_GPIO_Port,
+	AD9959_CS_Pin,
+	&AD9959_SPI_HANDLE,
+	AD9959_System_Clk,
+	0,
+	AD9959_CSR_MODE_2WIRE
+};
+
+/* 当前器件，所有接口都作用于它 */
+ad9959_dev_t *ad9959_dev_cur = &ad9959_dev_default;
+
+/* 软件SPI的BSRR表，由ad9959_soft_spi_init()生成 */
+static uint32_t ad9959_nibble_bsrr[16];			/* 4位模式：半字节 -> 数据线+时钟拉低 */
+static uint32_t ad9959_bit_bsrr[2];				/* 单线模式：位 -> SD0+时钟拉低 */
+#ifdef AD9959_SOFT_SPI_BYTE_TABLE
+static uint32_t ad9959_byte_bsrr[256][8];		/* 单线模式：字节 -> 8个时钟的BSRR字 */
+#endif
 
-/* 延时循环次数 - 根据系统主频调整以获得合适的延时
- * STM32H743 at 480MHz, a value around 50 gives a small delay for SPI.
- * 降低此值会缩短延时，增加此值会延长延时。
+static void ad9959_soft_spi_init(void);
+
+/**
+ * @brief       初始化延时服务
+ * @param       无
+ * @retval      无
+ * @note        系数向上取整，保证延时不短于要求值
  */
-#define AD9959_DELAY_LOOP_COUNT 50
+void ad9959_delay_init(void)
+{
+	AD9959_TIMER_INIT();
+	ad9959_ticks_per_ns_q16 = (uint32_t)((((uint64_t)AD9959_TIMER_HZ << 16) + 999999999ULL) / 1000000000ULL);
+}
 
 /**
- * @brief       AD9959软件延时函数
- * @param       nns: 延时参数，数值越大延时越长
+ * @brief       纳秒级延时
+ * @param       ns: 延时时间(ns)
  * @retval      无
- * @note        使用for循环实现延时，便于根据系统主频调整。
- *              通过修改 AD9959_DELAY_LOOP_COUNT 来调整延时长度。
+ * @note        等待时间基准走过足够的计数，计数器回绕不影响结果
  */
-void ad9959_delay(uint32_t nns)
+void ad9959_delay_ns(uint32_t ns)
 {
-	for(; nns != 0; nns--)
+	uint32_t start, ticks;
+
+	if(ad9959_ticks_per_ns_q16 == 0)
+		ad9959_delay_init();		// 先启动计数器，再读起点
+
+	start = AD9959_TIMER_NOW();
+	ticks = (uint32_t)(((uint64_t)ns * ad9959_ticks_per_ns_q16 + 0xFFFF) >> 16);
+	while((uint32_t)(AD9959_TIMER_NOW() - start) < ticks)
 	{
-		for(volatile uint32_t i = 0; i < AD9959_DELAY_LOOP_COUNT; i++)
-		{
-			/* This loop creates a delay. The volatile keyword prevents the compiler
-			 * from optimizing this loop away. */
-			__NOP();
-		}
 	}
 }
 
+#ifdef AD9959_USE_SPI_DMA
+/**
+ * @brief       DMA队列的片选控制
+ * @param       level: 片选电平
+ * @retval      无
+ */
+static void ad9959_dma_cs(uint8_t level)
+{
+	AD9959_CS(level);
+}
+
+/**
+ * @brief       DMA队列启动一次SPI DMA发送
+ * @param       buf: 数据指针(位于队列缓冲区，DMA可访问)
+ * @param       len: 字节数
+ * @retval      0: 成功  1: 失败
+ */
+static uint8_t ad9959_dma_start(const uint8_t *buf, uint16_t len)
+{
+	return HAL_SPI_Transmit_DMA(ad9959_dev_cur->hspi, buf, len) != HAL_OK;
+}
+
+static const ad9959_queue_ops_t ad9959_dma_ops =
+{
+	ad9959_dma_cs,
+	ad9959_dma_start,
+	ad9959_io_update_pulse
+};
+
+/**
+ * @brief       SPI发送完成处理
+ * @param       hspi: SPI句柄
+ * @retval      无
+ */
+void ad9959_spi_tx_cplt(SPI_HandleTypeDef *hspi)
+{
+	if(ad9959_bus_tx_done(hspi))
+		return;		// 多总线并行发送
+	if(hspi == ad9959_dev_cur->hspi)
+		ad9959_queue_tx_done();
+}
+
+#ifdef AD9959_DEFINE_SPI_CALLBACK
+/**
+ * @brief       SPI发送完成回调
+ * @param       hspi: SPI句柄
+ * @retval      无
+ * @note        覆盖HAL库的弱函数。应用程序也需要此回调时取消AD9959_DEFINE_SPI_CALLBACK，
+ *              在自己的实现中调用ad9959_spi_tx_cplt()
+ */
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+	ad9959_spi_tx_cplt(hspi);
+}
+#endif
+#endif
+
 /**
  * @brief       AD9959芯片复位和基本初始化
  * @param       无
@@ -69,131 +154,1467 @@ void ad9959_init(void)
 	AD9959_SD2(0);		// 串行数据线2
 	AD9959_SD3(0);		// 串行数据线3
 
+#ifdef AD9959_USE_SPI_DMA
+	/* 等待之前的传输结束，然后初始化DMA事务队列 */
+	ad9959_queue_wait();
+	ad9959_queue_init(&ad9959_dma_ops);
+#endif
+
 	/* 设置PDC为低电平，关闭功率下降模式 */
 	AD9959_PDC(0);
 
-	/* 执行AD9959硬件复位时序 */
- 	AD9959_RST(0);		// 复位信号拉低
- 	AD9959_DELAY(3);	// 保持复位状态至少3个时钟周期
- 	AD9959_RST(1);		// 复位信号拉高，开始复位过程
- 	AD9959_DELAY(500);	// 等待复位完成，确保内部电路稳定
- 	AD9959_RST(0);		// 复位信号拉低，完成复位时序
+	/* 执行AD9959硬件复位时序：上电后REF_CLK可能尚未稳定，脉宽取保守值，恢复时间按数据手册最小值 */
+	ad9959_delay_init();
+	AD9959_RST(1);									// 复位信号拉高，开始复位
+	ad9959_delay_ns(AD9959_T_RESET_NS);			// 保守的上电复位脉宽，见AD9959_T_RESET_NS
+	AD9959_RST(0);									// 复位信号拉低，完成复位
+	ad9959_delay_ns(AD9959_T_RESET_RECOVERY_NS);	// 等待复位结束后再访问串口
+
+	/* 定时器模式下UD引脚交给定时器 */
+	ad9959_tim_init();
+
+	/* 复位后寄存器恢复默认值，同步影子寄存器 */
+	ad9959_shadow_reset();
+	ad9959_dev_cur->serial_mode = AD9959_CSR_MODE_2WIRE;
+
+	/* 生成软件SPI的BSRR表 */
+	ad9959_soft_spi_init();
+#ifdef AD9959_USE_4BIT_SERIAL
+	/* 切换到4位串行模式 */
+	ad9959_set_serial_mode(AD9959_CSR_MODE_4BIT);
+#endif
+}
+
+/**
+ * @brief       进入掉电模式
+ * @param       无
+ * @retval      无
+ * @note        等待已提交的传输完成后拉高PWR_DWN_CTL，PDC为各器件共用
+ */
+void ad9959_power_down(void)
+{
+	ad9959_wait_idle();
+	AD9959_PDC(1);
+}
+
+/**
+ * @brief       退出掉电模式
+ * @param       无
+ * @retval      无
+ */
+void ad9959_power_up(void)
+{
+	AD9959_PDC(0);
+}
+
+/**
+ * @brief       产生IO_update脉冲
+ * @param       无
+ * @retval      无
+ * @note        只产生脉冲，不发送影子寄存器，DMA队列在中断中也会调用此函数
+ */
+void ad9959_io_update_pulse(void)
+{
+#ifdef AD9959_USE_TIM_UPDATE
+	ad9959_tim_update_after(0);					// 定时器输出脉冲，不占用CPU
+#else
+	AD9959_UD(1);								// 更新信号拉高，产生上升沿
+	ad9959_delay_ns(AD9959_T_IO_UPDATE_NS);	// 高电平至少保持1个SYNC_CLK
+	AD9959_UD(0);								// 更新信号拉低，完成更新脉冲
+#endif
+}
+
+/**
+ * @brief       发送待写寄存器并产生IO_update，完成后调用回调
+ * @param       cb: 回调函数，可以为NULL
+ * @param       ctx: 传给回调函数的参数
+ * @retval      无
+ */
+void ad9959_update_async(ad9959_queue_cb_t cb, void *ctx)
+{
+	AD9959_TRACE_BEGIN(AD9959_TRACE_API_UPDATE, 0);
+	ad9959_flush();		// 先发送影子寄存器中的待写数据
+
+	AD9959_TRACE_UPDATE();
+#ifdef AD9959_USE_SPI_DMA
+	ad9959_queue_io_update(cb, ctx);
+#else
+	ad9959_io_update_pulse();
+	if(cb != NULL)
+		cb(ctx);
+#endif
+	AD9959_TRACE_END();
+}
+
+/**
+ * @brief       等待所有已提交的传输完成
+ * @param       无
+ * @retval      无
+ */
+void ad9959_wait_idle(void)
+{
+#ifdef AD9959_USE_SPI_DMA
+	ad9959_queue_wait();
+#endif
+	while(ad9959_tim_busy())
+	{
+	}
+}
+
+/**
+ * @brief       发送待写寄存器，并在指定时刻产生IO_update
+ * @param       when: 时间戳
+ * @retval      0: 按时  1: 已迟到
+ */
+uint8_t ad9959_update_at(uint32_t when)
+{
+	uint8_t late;
+
+	AD9959_TRACE_BEGIN(AD9959_TRACE_API_UPDATE, 0);
+	ad9959_flush();
+	ad9959_wait_idle();		// 寄存器必须在脉冲之前全部发送完
+	AD9959_TRACE_UPDATE();
+	late = ad9959_tim_update_at(when);
+	AD9959_TRACE_END();
+	return late;
+}
+
+/**
+ * @brief       AD9959数据更新函数
+ * @param       无
+ * @retval      无
+ * @note        向AD9959发送更新脉冲，使之前写入的寄存器数据生效
+ *              必须在写入频率、相位、幅度等参数后调用此函数
+ *              发送脉冲前会先调用ad9959_flush()发送所有待写寄存器
+ *              DMA队列模式下只是把脉冲放入队列，函数立即返回
+ */
+void IO_update(void)
+{
+	ad9959_update_async(NULL, NULL);
+}
+
+/**
+ * @brief       生成4位串行模式的半字节BSRR表
+ * @param       table: 输出，16个BSRR字
+ * @param       sd_pin: SDIO_0-SDIO_3对应的引脚掩码
+ * @param       clk_pin: SCLK对应的引脚掩码
+ * @retval      无
+ */
+void ad9959_nibble_bsrr_table(uint32_t table[16], const uint16_t sd_pin[4], uint16_t clk_pin)
+{
+	uint8_t nibble, n;
+	uint32_t set, reset;
+
+	for(nibble = 0; nibble < 16; nibble++)
+	{
+		set = 0;
+		reset = clk_pin;						// 时钟拉低
+		for(n = 0; n < 4; n++)
+		{
+			if(nibble & (1 << n))
+				set |= sd_pin[n];				// 第n位输出到SDIO_n
+			else
+				reset |= sd_pin[n];
+		}
+		table[nibble] = set | (reset << 16);
+	}
+}
+
+/**
+ * @brief       生成单线模式一个字节的BSRR序列
+ * @param       out: 输出，8个BSRR字，依次对应bit7..bit0
+ * @param       value: 要发送的字节
+ * @param       sd_pin: SDIO_0对应的引脚掩码
+ * @param       clk_pin: SCLK对应的引脚掩码
+ * @retval      无
+ * @note        每个字同时设置SD0并拉低时钟，要求SD0与CLK在同一GPIO端口
+ *              纯计算函数，不访问硬件
+ */
+void ad9959_byte_bsrr_table(uint32_t out[8], uint8_t value, uint16_t sd_pin, uint16_t clk_pin)
+{
+	uint8_t i;
+
+	for(i = 0; i < 8; i++)
+	{
+		if(value & (0x80 >> i))
+			out[i] = sd_pin | ((uint32_t)clk_pin << 16);
+		else
+			out[i] = ((uint32_t)sd_pin | clk_pin) << 16;
+	}
+}
+
+/**
+ * @brief       生成软件SPI使用的BSRR表
+ * @param       无
+ * @retval      无
+ */
+static void ad9959_soft_spi_init(void)
+{
+	const uint16_t sd_pin[4] = {AD9959_SD0_Pin, AD9959_SD1_Pin, AD9959_SD2_Pin, AD9959_SD3_Pin};
+	uint32_t bits[8];
+
+	ad9959_nibble_bsrr_table(ad9959_nibble_bsrr, sd_pin, AD9959_CLK_Pin);
+
+	ad9959_byte_bsrr_table(bits, 0x00, AD9959_SD0_Pin, AD9959_CLK_Pin);
+	ad9959_bit_bsrr[0] = bits[0];
+	ad9959_byte_bsrr_table(bits, 0x80, AD9959_SD0_Pin, AD9959_CLK_Pin);
+	ad9959_bit_bsrr[1] = bits[0];
+
+#ifdef AD9959_SOFT_SPI_BYTE_TABLE
+	{
+		uint16_t v;
+
+		for(v = 0; v < 256; v++)
+			ad9959_byte_bsrr_table(ad9959_byte_bsrr[v], (uint8_t)v, AD9959_SD0_Pin, AD9959_CLK_Pin);
+	}
+#endif
+}
+
+/* 软件SPI半个时钟周期的延时 */
+#if AD9959_SOFT_SPI_HALF_PERIOD_NOP > 0
+#define AD9959_SOFT_HALF_PERIOD()	do { for(uint32_t n_ = 0; n_ < AD9959_SOFT_SPI_HALF_PERIOD_NOP; n_++) __NOP(); } while(0)
+#else
+#define AD9959_SOFT_HALF_PERIOD()	do { } while(0)
+#endif
+
+/* 一个时钟周期：写入数据并拉低时钟，然后拉高时钟让AD9959采样 */
+#define AD9959_SOFT_CLOCK(port, word)	do { AD9959_BSRR_WRITE(port, word); AD9959_SOFT_HALF_PERIOD(); \
+											 AD9959_BSRR_WRITE(port, AD9959_CLK_Pin); AD9959_SOFT_HALF_PERIOD(); } while(0)
+
+/**
+ * @brief       软件SPI发送一个字节
+ * @param       Value: 要发送的字节，高位在前
+ * @retval      无
+ * @note        调用前片选必须已经拉低，结束时时钟保持高电平
+ *              每个时钟只有两次BSRR写入，没有分支和函数调用
+ */
+static inline void ad9959_soft_write_byte(uint8_t Value)
+{
+	GPIO_TypeDef *port = AD9959_CLK_GPIO_Port;
+
+	if(ad9959_dev_cur->serial_mode == AD9959_CSR_MODE_4BIT)
+	{
+		/* 4位模式：两个时钟，高半字节在前 */
+		AD9959_SOFT_CLOCK(port, ad9959_nibble_bsrr[Value >> 4]);
+		AD9959_SOFT_CLOCK(port, ad9959_nibble_bsrr[Value & 0x0F]);
+		return;
+	}
+
+#ifdef AD9959_SOFT_SPI_BYTE_TABLE
+	{
+		const uint32_t *w = ad9959_byte_bsrr[Value];
+
+		AD9959_SOFT_CLOCK(port, w[0]);
+		AD9959_SOFT_CLOCK(port, w[1]);
+		AD9959_SOFT_CLOCK(port, w[2]);
+		AD9959_SOFT_CLOCK(port, w[3]);
+		AD9959_SOFT_CLOCK(port, w[4]);
+		AD9959_SOFT_CLOCK(port, w[5]);
+		AD9959_SOFT_CLOCK(port, w[6]);
+		AD9959_SOFT_CLOCK(port, w[7]);
+	}
+#else
+	AD9959_SOFT_CLOCK(port, ad9959_bit_bsrr[(Value >> 7) & 1]);
+	AD9959_SOFT_CLOCK(port, ad9959_bit_bsrr[(Value >> 6) & 1]);
+	AD9959_SOFT_CLOCK(port, ad9959_bit_bsrr[(Value >> 5) & 1]);
+	AD9959_SOFT_CLOCK(port, ad9959_bit_bsrr[(Value >> 4) & 1]);
+	AD9959_SOFT_CLOCK(port, ad9959_bit_bsrr[(Value >> 3) & 1]);
+	AD9959_SOFT_CLOCK(port, ad9959_bit_bsrr[(Value >> 2) & 1]);
+	AD9959_SOFT_CLOCK(port, ad9959_bit_bsrr[(Value >> 1) & 1]);
+	AD9959_SOFT_CLOCK(port, ad9959_bit_bsrr[Value & 1]);
+#endif
+}
+
+/**
+ * @brief       向AD9959写入数据
+ * @param       reg: 寄存器地址 (0x00-0x18)
+ * @param       DataNumber: 要写入的数据字节数
+ * @param       Data: 指向要写入数据的指针
+ * @retval      无
+ * @note        使用软件SPI向AD9959指定寄存器写入数据
+ *              先发送8位寄存器地址，再发送指定字节数的数据
+ */
+void AD9959_WriteData(uint8_t reg, uint8_t DataNumber, uint8_t *Data)
+{
+	uint8_t cnt;
+
+	/* 开始SPI通信：时钟拉低，片选拉低 */
+	AD9959_CLK(0);
+	AD9959_CS(0);		// 选中AD9959芯片
+
+	AD9959_TRACE_FRAME(DataNumber + 1);
+
+	/* 发送8位寄存器地址 */
+	ad9959_soft_write_byte(reg);
+
+	/* 发送数据字节 */
+	for (cnt=0; cnt<DataNumber; cnt++)
+		ad9959_soft_write_byte(Data[cnt]);
+	AD9959_CLK(0);
+
+	/* 结束SPI通信：片选拉高 */
+	AD9959_CS(1);
+}
+
+/**
+ * @brief       AD9959 SPI数据写入函数
+ * @param       reg: 寄存器地址 (0x00-0x18)
+ * @param       DataNumber: 要写入的数据字节数
+ * @param       Data: 指向要写入数据的指针
+ * @retval      无
+ * @note        指令字节与数据合并后用一次HAL_SPI_Transmit发送，避免两次调用之间的间隙
+ */
+void AD9959_WriteData_SPI(uint8_t reg, uint8_t DataNumber, uint8_t *Data)
+{
+	uint8_t buf[1 + 255];
+
+	buf[0] = reg;							// 指令字节
+	if(DataNumber > 0 && Data != NULL)
+		memcpy(&buf[1], Data, DataNumber);	// 数据字节
+	else
+		DataNumber = 0;
+
+	AD9959_TRACE_FRAME(DataNumber + 1);
+	AD9959_CS(0);		// 选中AD9959芯片
+	HAL_SPI_Transmit(ad9959_dev_cur->hspi, buf, (uint16_t)(DataNumber + 1), HAL_MAX_DELAY);
+	AD9959_CS(1);		// 结束SPI通信
+}
+
+/**
+ * @brief       在一次片选内发送一段连续数据
+ * @param       buf: 数据指针，可以包含多个"指令字节+数据"
+ * @param       len: 字节数
+ * @retval      无
+ * @note        AD9959允许在同一次片选内连续进行多个指令/数据周期，
+ *              根据编译时宏定义选择软件SPI、硬件SPI或DMA队列
+ *              直接发送，不经过影子寄存器
+ */
+void AD9959_WriteFrame(const uint8_t *buf, uint16_t len)
+{
+	if(len == 0)
+		return;
+	AD9959_TRACE_FRAME(len);
+
+#if defined(AD9959_USE_HARDWARE_SPI) && defined(AD9959_USE_SPI_DMA)
+	/* 使用DMA事务队列，放不进队列的长帧等队列发送完后阻塞发送 */
+	if(len <= AD9959_QUEUE_MAX_FRAME)
+	{
+		ad9959_queue_frame(buf, len);
+		return;
+	}
+	ad9959_queue_wait();
+	AD9959_CS(0);
+	HAL_SPI_Transmit(ad9959_dev_cur->hspi, buf, len, HAL_MAX_DELAY);
+	AD9959_CS(1);
+#elif defined(AD9959_USE_HARDWARE_SPI)
+	/* 使用硬件SPI模式，一次传输 */
+	AD9959_CS(0);
+	HAL_SPI_Transmit(ad9959_dev_cur->hspi, buf, len, HAL_MAX_DELAY);
+	AD9959_CS(1);
+#else
+	/* 使用软件SPI模式（默认） */
+	uint16_t i;
+
+	AD9959_CLK(0);
+	AD9959_CS(0);
+	for(i = 0; i < len; i++)
+		ad9959_soft_write_byte(buf[i]);
+	AD9959_CLK(0);
+	AD9959_CS(1);
+#endif
+}
+
+/**
+ * @brief       从AD9959读取寄存器
+ * @param       reg: 寄存器地址 (0x00-0x18)
+ * @param       DataNumber: 数据字节数
+ * @param       Data: 输出，高字节在前
+ * @retval      0: 成功  1: 当前为2位/4位串行模式，不支持读取
+ * @note        指令字节bit7置1，之后芯片在SCLK下降沿输出数据：单线2线模式由SDIO_0输出，3线模式由SDIO_2输出
+ *              软件SPI临时把输出数据线切换为输入；硬件SPI为半双工(1LINE)时先发送指令再接收，
+ *              全双工时MISO应接SDIO_2(3线模式)，指令和数据在一次传输内完成
+ *              通道寄存器读取CSR选中的通道，CSR应只选中一个通道；不经过影子寄存器
+ */
+uint8_t AD9959_ReadData(uint8_t reg, uint8_t DataNumber, uint8_t *Data)
+{
+	uint8_t mode = ad9959_dev_cur->serial_mode;
+
+	if(mode == AD9959_CSR_MODE_2BIT || mode == AD9959_CSR_MODE_4BIT)
+		return 1;
+
+#if defined(AD9959_USE_HARDWARE_SPI)
+	uint8_t tx[1 + 4] = {0};
+	uint8_t rx[1 + 4];
+
+#ifdef AD9959_USE_SPI_DMA
+	ad9959_queue_wait();		// 之前入队的写入先完成
+#endif
+	if(DataNumber > 4)
+		DataNumber = 4;
+	tx[0] = (uint8_t)(reg | 0x80);
+	AD9959_TRACE_FRAME(DataNumber + 1);
+	AD9959_CS(0);
+	if(ad9959_dev_cur->hspi->Init.Direction == SPI_DIRECTION_1LINE)
+	{
+		HAL_SPI_Transmit(ad9959_dev_cur->hspi, tx, 1, HAL_MAX_DELAY);
+		HAL_SPI_Receive(ad9959_dev_cur->hspi, Data, DataNumber, HAL_MAX_DELAY);
+	}
+	else
+	{
+		HAL_SPI_TransmitReceive(ad9959_dev_cur->hspi, tx, rx, (uint16_t)(DataNumber + 1), HAL_MAX_DELAY);
+		memcpy(Data, &rx[1], DataNumber);
+	}
+	AD9959_CS(1);
+#else
+	GPIO_InitTypeDef gpio = {0};
+	GPIO_TypeDef *port = (mode == AD9959_CSR_MODE_3WIRE) ? AD9959_SD2_GPIO_Port : AD9959_SD0_GPIO_Port;
+	uint16_t pin = (mode == AD9959_CSR_MODE_3WIRE) ? AD9959_SD2_Pin : AD9959_SD0_Pin;
+	uint8_t i, bit, v;
+
+	AD9959_TRACE_FRAME(DataNumber + 1);
+	AD9959_CLK(0);
+	AD9959_CS(0);
+	ad9959_soft_write_byte((uint8_t)(reg | 0x80));
+
+	/* 输出数据线切换为输入 */
+	gpio.Pin = pin;
+	gpio.Mode = GPIO_MODE_INPUT;
+	gpio.Pull = GPIO_NOPULL;
+	HAL_GPIO_Init(port, &gpio);
+
+	for(i = 0; i < DataNumber; i++)
+	{
+		v = 0;
+		for(bit = 0; bit < 8; bit++)
+		{
+			AD9959_CLK(0);								// 下降沿，芯片输出下一位
+			ad9959_delay_ns(AD9959_T_READ_VALID_NS);
+			v = (uint8_t)((v << 1) | AD9959_PIN_READ(port, pin));
+			AD9959_CLK(1);
+		}
+		Data[i] = v;
+	}
+	AD9959_CLK(0);
+	AD9959_CS(1);
+
+	/* 恢复为输出 */
+	gpio.Mode = GPIO_MODE_OUTPUT_PP;
+	gpio.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	HAL_GPIO_Init(port, &gpio);
+#endif
+	return 0;
+}
+
+/**
+ * @brief       将寄存器列表序列化为一段连续的突发数据
+ * @param       items: 寄存器列表
+ * @param       count: 寄存器个数
+ * @param       buf: 输出缓冲区
+ * @param       size: 输出缓冲区字节数
+ * @retval      序列化后的字节数，缓冲区不足时返回0
+ * @note        每个寄存器依次输出"指令字节+数据"，结果可直接交给AD9959_WriteFrame()
+ */
+uint16_t ad9959_burst_serialize(const ad9959_burst_item_t *items, uint8_t count, uint8_t *buf, uint16_t size)
+{
+	uint16_t len = 0;
+	uint8_t i;
+
+	for(i = 0; i < count; i++)
+	{
+		if(len + 1 + items[i].len > size)
+			return 0;
+		buf[len++] = items[i].reg;
+		memcpy(&buf[len], items[i].data, items[i].len);
+		len += items[i].len;
+	}
+	return len;
+}
+
+/* 突发缓冲区：ad9959_flush()把所有待写寄存器拼接到这里，一次片选发送 */
+#define AD9959_BURST_BUF_SIZE	256
+
+static uint8_t  ad9959_burst_buf[AD9959_BURST_BUF_SIZE];
+static uint16_t ad9959_burst_len;
+
+/* 非NULL时突发数据收集到这里而不发送，由ad9959_flush_to()使用 */
+static uint8_t *ad9959_burst_capture;
+static uint16_t ad9959_burst_capture_len;
+
+/**
+ * @brief       发送突发缓冲区中的数据
+ * @param       无
+ * @retval      无
+ */
+static void ad9959_burst_send(void)
+{
+	if(ad9959_burst_capture == NULL)
+	{
+		AD9959_WriteFrame(ad9959_burst_buf, ad9959_burst_len);
+		ad9959_burst_len = 0;
+		return;
+	}
+
+	if(ad9959_burst_capture_len + ad9959_burst_len > AD9959_FLUSH_MAX_BYTES)
+	{
+		/* 放不下时先直接发送已收集的数据，保持写入顺序 */
+		AD9959_WriteFrame(ad9959_burst_capture, ad9959_burst_capture_len);
+		ad9959_burst_capture_len = 0;
+	}
+	memcpy(&ad9959_burst_capture[ad9959_burst_capture_len], ad9959_burst_buf, ad9959_burst_len);
+	ad9959_burst_capture_len += ad9959_burst_len;
+	ad9959_burst_len = 0;
+}
+
+/**
+ * @brief       向突发缓冲区追加一个寄存器
+ * @param       reg: 寄存器地址
+ * @param       len: 数据字节数
+ * @param       data: 数据指针
+ * @retval      无
+ * @note        缓冲区放不下时先把已有数据发送出去
+ */
+static void ad9959_burst_append(uint8_t reg, uint8_t len, const uint8_t *data)
+{
+	if(ad9959_burst_len + 1 + len > AD9959_BURST_BUF_SIZE)
+		ad9959_burst_send();
+
+	ad9959_burst_buf[ad9959_burst_len++] = reg;
+	memcpy(&ad9959_burst_buf[ad9959_burst_len], data, len);
+	ad9959_burst_len += len;
+}
+
+/**
+ * @brief       AD9959底层数据写入函数
+ * @param       reg: 寄存器地址 (0x00-0x18)
+ * @param       DataNumber: 要写入的数据字节数
+ * @param       Data: 指向要写入数据的指针
+ * @retval      无
+ * @note        指令字节与数据合并为一帧发送，不经过影子寄存器
+ */
+void AD9959_WriteData_Raw(uint8_t reg, uint8_t DataNumber, uint8_t *Data)
+{
+	if(Data == NULL)
+		DataNumber = 0;
+
+	ad9959_burst_send();		// 保证写入顺序
+	ad9959_burst_append(reg, DataNumber, Data);
+	ad9959_burst_send();
+}
+
+/*********************************影子寄存器*********************************************/
+
+/* 各寄存器字节长度，按地址0x00-0x18排列 */
+static const uint8_t ad9959_reg_len[AD9959_REG_COUNT] =
+{
+	1, 3, 2,							/* CSR FR1 FR2 */
+	3, 4, 2, 3, 2, 4, 4,				/* CFR CFTW0 CPOW0 ACR SRR RDW FDW */
+	4, 4, 4, 4, 4, 4, 4, 4,				/* CW1-CW8 */
+	4, 4, 4, 4, 4, 4, 4					/* CW9-CW15 */
+};
+
+/* 各寄存器在影子寄存器中的字节偏移 */
+static const uint8_t ad9959_reg_ofs[AD9959_REG_COUNT] =
+{
+	0, 1, 4,
+	6, 9, 13, 15, 18, 20, 24,
+	28, 32, 36, 40, 44, 48, 52, 56,
+	60, 64, 68, 72, 76, 80, 84
+};
+
+#define AD9959_GLOBAL_REG_MASK	0x00000007UL	/* CSR/FR1/FR2为全局寄存器，只保存在通道0 */
+#define AD9959_FR2_ALL_CLR_PHASE	0x10	/* FR2[12]：清零并保持所有通道的相位累加器(高字节) */
+
+/**
+ * @brief       判断寄存器是否需要发送
+ * @param       ch: 通道号 (0-3)
+ * @param       reg: 寄存器地址
+ * @retval      1: 需要发送  0: 与芯片内容一致
+ */
+static uint8_t ad9959_shadow_differs(uint8_t ch, uint8_t reg)
+{
+	uint8_t ofs = ad9959_reg_ofs[reg];
+
+	if(!(ad9959_dev_cur->shadow.valid[ch] & (1UL << reg)))
+		return 1;
+	return memcmp(&ad9959_dev_cur->shadow.want[ch][ofs], &ad9959_dev_cur->shadow.chip[ch][ofs], ad9959_reg_len[reg]) != 0;
+}
+
+/**
+ * @brief       把一个寄存器加入突发缓冲区并同步影子寄存器
+ * @param       ch: 影子寄存器所在通道 (全局寄存器为0)
+ * @param       reg: 寄存器地址
+ * @retval      无
+ */
+static void ad9959_shadow_send(uint8_t ch, uint8_t reg)
+{
+	uint8_t ofs = ad9959_reg_ofs[reg];
+
+	ad9959_burst_append(reg, ad9959_reg_len[reg], &ad9959_dev_cur->shadow.want[ch][ofs]);
+	memcpy(&ad9959_dev_cur->shadow.chip[ch][ofs], &ad9959_dev_cur->shadow.want[ch][ofs], ad9959_reg_len[reg]);
+	ad9959_dev_cur->shadow.valid[ch] |= (1UL << reg);
+	ad9959_dev_cur->shadow.dirty[ch] &= ~(1UL << reg);
+}
+
+/**
+ * @brief       将影子寄存器恢复为芯片上电复位后的默认值
+ * @param       无
+ * @retval      无
+ * @note        默认值参考AD9959数据手册寄存器映射表
+ *              CSR=0xF0，FR1/FR2/CFTW0/CPOW0=0，CFR=0x000302，其余寄存器视为未知
+ */
+void ad9959_shadow_reset(void)
+{
+	uint8_t ch, ofs;
+
+	memset(&ad9959_dev_cur->shadow, 0, sizeof(ad9959_dev_cur->shadow));
+
+	ad9959_dev_cur->shadow.want[0][0] = 0xF0;	// CSR：四通道全部使能，单线串行，MSB优先
+	ad9959_dev_cur->shadow.chip[0][0] = 0xF0;
+	ad9959_dev_cur->shadow.valid[0] = AD9959_GLOBAL_REG_MASK;
+
+	for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+	{
+		ofs = ad9959_reg_ofs[CFR];
+		ad9959_dev_cur->shadow.want[ch][ofs + 1] = 0x03;		// DAC满量程电流
+		ad9959_dev_cur->shadow.want[ch][ofs + 2] = 0x02;
+		ad9959_dev_cur->shadow.chip[ch][ofs + 1] = 0x03;
+		ad9959_dev_cur->shadow.chip[ch][ofs + 2] = 0x02;
+		ad9959_dev_cur->shadow.valid[ch] |= (1UL << CFR) | (1UL << CFTW0) | (1UL << CPOW0);
+	}
+}
+
+/**
+ * @brief       使影子寄存器中记录的芯片内容全部失效
+ * @param       无
+ * @retval      无
+ */
+void ad9959_shadow_invalidate(void)
+{
+	uint8_t ch;
+
+	for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+		ad9959_dev_cur->shadow.valid[ch] = 0;
+}
+
+/**
+ * @brief       使影子寄存器中部分寄存器的芯片内容失效
+ * @param       ch_mask: 通道位图(bit0-bit3)
+ * @param       regs: 按地址的寄存器位图
+ * @retval      无
+ */
+void ad9959_shadow_forget(uint8_t ch_mask, uint32_t regs)
+{
+	uint8_t ch;
+
+	ad9959_dev_cur->shadow.valid[0] &= ~(regs & AD9959_GLOBAL_REG_MASK);
+	for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+	{
+		if(ch_mask & (1 << ch))
+			ad9959_dev_cur->shadow.valid[ch] &= ~(regs & ~AD9959_GLOBAL_REG_MASK);
+	}
+}
+
+/**
+ * @brief       使芯片CSR只选中一个通道
+ * @param       ch: 通道
+ * @retval      无
+ */
+void ad9959_select_channel(uint8_t ch)
+{
+	uint8_t csr = (uint8_t)((0x10 << ch) | ad9959_dev_cur->serial_mode);
+
+	if(!(ad9959_dev_cur->shadow.valid[0] & (1UL << CSR)) || ad9959_dev_cur->shadow.chip[0][0] != csr)
+	{
+		AD9959_WriteData_Raw(CSR, 1, &csr);
+		ad9959_dev_cur->shadow.chip[0][0] = csr;
+		ad9959_dev_cur->shadow.valid[0] |= (1UL << CSR);
+	}
+}
+
+/*********************************多通道分组*********************************************/
+
+/**
+ * CSR可以同时选中多个通道，一次写入对所有选中的通道生效
+ * 每个待写的(寄存器，数值)构成一项：need为必须写入该值的通道，allow为写入后不出错的通道
+ * (need加上芯片中已经是该值、且不需要修改的通道)，分组就是为每一项选一个need⊆mask⊆allow的CSR，
+ * 寄存器字节数与分组方式无关，所以目标是使用的不同mask最少，即CSR写入次数最少
+ */
+#define AD9959_GROUP_MAX_ITEMS	((AD9959_REG_COUNT - CFR) * AD9959_CH_COUNT)
+#define AD9959_GROUP_MAX_MASKS	15			/* 4个通道的非空组合数 */
+
+typedef struct
+{
+	uint8_t reg;		/* 寄存器地址 */
+	uint8_t src;		/* 数值取自该通道的影子寄存器 */
+	uint8_t need;		/* 必须写入的通道位图 */
+	uint8_t allow;		/* 可以写入的通道位图 */
+} ad9959_group_item_t;
+
+static ad9959_group_item_t ad9959_group_item[AD9959_GROUP_MAX_ITEMS];
+static uint8_t ad9959_group_cur[AD9959_GROUP_MAX_MASKS];
+static uint8_t ad9959_group_best[AD9959_GROUP_MAX_MASKS];
+static uint8_t ad9959_group_best_n;
+
+/* mask能否用于写入一项 */
+#define AD9959_GROUP_FITS(item, mask)	\
+	((((item)->need & ~(mask)) == 0) && (((mask) & ~(item)->allow) == 0))
+
+/**
+ * @brief       判断寄存器在两个通道的影子寄存器中数值是否相同
+ * @param       a: 通道a的数据区
+ * @param       b: 通道b的数据区
+ * @param       reg: 寄存器地址
+ * @retval      1: 相同  0: 不同
+ */
+static uint8_t ad9959_reg_equal(const uint8_t *a, const uint8_t *b, uint8_t reg)
+{
+	uint8_t ofs = ad9959_reg_ofs[reg];
+
+	return memcmp(&a[ofs], &b[ofs], ad9959_reg_len[reg]) == 0;
+}
+
+/**
+ * @brief       搜索最少的mask集合
+ * @param       n: 项数
+ * @param       depth: 已选mask数
+ * @retval      无
+ * @note        取第一项未被覆盖的项，依次尝试它所有可用的mask(从大到小)，
+ *              比当前最优解多时剪枝；4个通道最多15个mask，递归深度有限
+ */
+static void ad9959_group_search(uint8_t n, uint8_t depth)
+{
+	const ad9959_group_item_t *item = NULL;
+	uint8_t i, k, extra, sub, mask;
+
+	for(i = 0; i < n && item == NULL; i++)
+	{
+		item = &ad9959_group_item[i];
+		for(k = 0; k < depth; k++)
+		{
+			if(AD9959_GROUP_FITS(item, ad9959_group_cur[k]))
+			{
+				item = NULL;
+				break;
+			}
+		}
+	}
+
+	if(item == NULL)
+	{
+		/* 全部覆盖 */
+		if(depth < ad9959_group_best_n)
+		{
+			memcpy(ad9959_group_best, ad9959_group_cur, depth);
+			ad9959_group_best_n = depth;
+		}
+		return;
+	}
+	if(depth + 1 >= ad9959_group_best_n)
+		return;
+
+	extra = (uint8_t)(item->allow & ~item->need);
+	sub = extra;
+	do
+	{
+		mask = (uint8_t)(item->need | sub);
+		ad9959_group_cur[depth] = mask;
+		ad9959_group_search(n, (uint8_t)(depth + 1));
+		sub = (uint8_t)((sub - 1) & extra);
+	} while(sub != extra);
+}
+
+/**
+ * @brief       收集各通道待写寄存器并分组
+ * @param       无
+ * @retval      项数
+ * @note        结果在ad9959_group_item和ad9959_group_best中，mask数为ad9959_group_best_n
+ */
+static uint8_t ad9959_group_plan(void)
+{
+	ad9959_group_item_t *item;
+	uint8_t ch, other, reg, n = 0;
+	uint8_t pending[AD9959_REG_COUNT] = {0};	/* 按寄存器：还未归入某一项的通道 */
+	uint8_t changed[AD9959_REG_COUNT];			/* 按寄存器：需要写入的通道 */
+
+	for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+	{
+		for(reg = CFR; reg < AD9959_REG_COUNT; reg++)
+		{
+			if((ad9959_dev_cur->shadow.dirty[ch] & (1UL << reg)) && ad9959_shadow_differs(ch, reg))
+				pending[reg] |= (uint8_t)(1 << ch);
+		}
+		ad9959_dev_cur->shadow.dirty[ch] &= AD9959_GLOBAL_REG_MASK;
+	}
+	memcpy(changed, pending, sizeof(changed));
+
+	/* 按寄存器地址生成各项，同一寄存器数值相同的通道合并为一项 */
+	for(reg = CFR; reg < AD9959_REG_COUNT; reg++)
+	{
+		for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+		{
+			if(!(pending[reg] & (1 << ch)))
+				continue;
+
+			item = &ad9959_group_item[n++];
+			item->reg = reg;
+			item->src = ch;
+			item->need = 0;
+			item->allow = 0;
+			for(other = ch; other < AD9959_CH_COUNT; other++)
+			{
+				if(!ad9959_reg_equal(ad9959_dev_cur->shadow.want[ch], ad9959_dev_cur->shadow.want[other], reg))
+					continue;
+				if(pending[reg] & (1 << other))
+				{
+					item->need |= (uint8_t)(1 << other);
+					pending[reg] &= (uint8_t)~(1 << other);
+				}
+			}
+			for(other = 0; other < AD9959_CH_COUNT; other++)
+			{
+				if(!(changed[reg] & (1 << other)) && !ad9959_shadow_differs(other, reg)
+					&& ad9959_reg_equal(ad9959_dev_cur->shadow.want[ch], ad9959_dev_cur->shadow.chip[other], reg))
+					item->allow |= (uint8_t)(1 << other);
+			}
+			item->allow |= item->need;
+		}
+	}
+
+	ad9959_group_best_n = AD9959_GROUP_MAX_MASKS + 1;
+	if(n != 0)
+		ad9959_group_search(n, 0);
+	else
+		ad9959_group_best_n = 0;
+	return n;
+}
+
+/**
+ * @brief       将影子寄存器中的待写数据发送到AD9959
+ * @param       无
+ * @retval      无
+ * @note        先发送FR1/FR2，再按分组写CSR并发送该组的通道寄存器
+ *              数值相同的通道共用一次CSR选择和一次寄存器写入，CSR写入次数最少；
+ *              与芯片当前CSR相同的分组排在最前面，省去一次CSR写入，完成后CSR保持在最后一组
+ *              CSR写入立即生效，所以全部寄存器可以拼成一帧，在一次片选内发送
+ */
+void ad9959_flush(void)
+{
+	ad9959_group_item_t *item;
+	uint8_t i, g, ch, n, mask, csr_ofs = ad9959_reg_ofs[CSR];
+	uint8_t logic_csr = ad9959_dev_cur->shadow.want[0][csr_ofs];
+	uint8_t done[AD9959_GROUP_MAX_ITEMS] = {0};
+
+	AD9959_TRACE_BEGIN(AD9959_TRACE_API_FLUSH, 0);
+
+	/* 全局寄存器 */
+	for(i = FR1; i <= FR2; i++)
+	{
+		if((ad9959_dev_cur->shadow.dirty[0] & (1UL << i)) && ad9959_shadow_differs(0, i))
+			ad9959_shadow_send(0, i);
+		ad9959_dev_cur->shadow.dirty[0] &= ~(1UL << i);
+	}
+
+	/* 通道寄存器 */
+	n = ad9959_group_plan();
+	for(g = 1; g < ad9959_group_best_n; g++)
+	{
+		if((ad9959_dev_cur->shadow.valid[0] & (1UL << CSR)) && ad9959_group_best[g] == (ad9959_dev_cur->shadow.chip[0][csr_ofs] >> 4))
+		{
+			mask = ad9959_group_best[g];
+			ad9959_group_best[g] = ad9959_group_best[0];
+			ad9959_group_best[0] = mask;
+			break;
+		}
+	}
+
+	for(g = 0; g < ad9959_group_best_n; g++)
+	{
+		mask = ad9959_group_best[g];
+
+		/* 选中该组通道，保留串行模式位 */
+		ad9959_dev_cur->shadow.want[0][csr_ofs] = (uint8_t)((logic_csr & 0x0F) | (mask << 4));
+		if(ad9959_shadow_differs(0, CSR))
+			ad9959_shadow_send(0, CSR);
+
+		for(i = 0; i < n; i++)
+		{
+			item = &ad9959_group_item[i];
+			if(done[i] || !AD9959_GROUP_FITS(item, mask))
+				continue;
+			done[i] = 1;
+
+			ad9959_shadow_send(item->src, item->reg);
+			for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+			{
+				if((mask & (1 << ch)) && ch != item->src)
+				{
+					memcpy(&ad9959_dev_cur->shadow.chip[ch][ad9959_reg_ofs[item->reg]],
+						&ad9959_dev_cur->shadow.want[item->src][ad9959_reg_ofs[item->reg]], ad9959_reg_len[item->reg]);
+					ad9959_dev_cur->shadow.valid[ch] |= (1UL << item->reg);
+				}
+			}
+		}
+	}
+
+	/* 恢复逻辑CSR，芯片CSR保持在最后选择的通道 */
+	ad9959_dev_cur->shadow.want[0][csr_ofs] = logic_csr;
+	ad9959_dev_cur->shadow.dirty[0] &= ~(1UL << CSR);
+
+	ad9959_burst_send();
+	AD9959_TRACE_END();
+}
+
+/**
+ * @brief       把待写寄存器收集到缓冲区，不发送
+ * @param       buf: 输出缓冲区，至少AD9959_FLUSH_MAX_BYTES字节
+ * @retval      字节数
+ * @note        与ad9959_flush()相同，只是结果留给调用者在一次片选内发送，影子寄存器视为已发送
+ */
+uint16_t ad9959_flush_to(uint8_t *buf)
+{
+	ad9959_burst_send();
+	ad9959_burst_capture = buf;
+	ad9959_burst_capture_len = 0;
+	ad9959_flush();
+	ad9959_burst_capture = NULL;
+	return ad9959_burst_capture_len;
+}
+
+/**
+ * @brief       切换AD9959串行通信模式
+ * @param       mode: AD9959_CSR_MODE_2WIRE/3WIRE/4BIT
+ * @retval      无
+ * @note        CSR写入后立即生效，所以CSR本身用旧模式发送，之后的传输使用新模式
+ */
+void ad9959_set_serial_mode(uint8_t mode)
+{
+	uint8_t csr;
+
+	mode &= AD9959_CSR_MODE_MASK;
+#ifdef AD9959_USE_HARDWARE_SPI
+	if(mode == AD9959_CSR_MODE_2BIT || mode == AD9959_CSR_MODE_4BIT)
+		return;		// 硬件SPI只有一根数据线
+#endif
+
+	ad9959_flush();
+
+	/* 芯片CSR保留当前通道选择，只修改模式位 */
+	csr = (uint8_t)((ad9959_dev_cur->shadow.chip[0][0] & ~AD9959_CSR_MODE_MASK) | mode);
+	AD9959_WriteData_Raw(CSR, 1, &csr);
+	ad9959_dev_cur->serial_mode = mode;
+
+	ad9959_dev_cur->shadow.chip[0][0] = csr;
+	ad9959_dev_cur->shadow.want[0][0] = (uint8_t)((ad9959_dev_cur->shadow.want[0][0] & ~AD9959_CSR_MODE_MASK) | mode);
+	ad9959_dev_cur->shadow.valid[0] |= (1UL << CSR);
+}
+
+/*********************************寄存器回读*********************************************/
+
+/**
+ * @brief       选中通道并读取寄存器，不发送待写数据
+ * @param       ch: 通道
+ * @param       reg: 寄存器地址
+ * @param       data: 输出
+ * @retval      0: 成功  1: 当前串行模式不支持读取
+ */
+static uint8_t ad9959_read_chip(uint8_t ch, uint8_t reg, uint8_t *data)
+{
+	/* 通道寄存器：芯片CSR只选中该通道 */
+	if(reg > FR2)
+		ad9959_select_channel(ch);
+	return AD9959_ReadData(reg, ad9959_reg_len[reg], data);
+}
+
+/**
+ * @brief       读取一个通道的寄存器
+ * @param       ch: 通道 (0-3)，全局寄存器忽略
+ * @param       reg: 寄存器地址 (0x00-0x18)
+ * @param       data: 输出，按寄存器长度，高字节在前
+ * @retval      0: 成功  1: 参数错误或当前串行模式不支持读取
+ */
+uint8_t ad9959_read_reg(uint8_t ch, uint8_t reg, uint8_t *data)
+{
+	if(reg >= AD9959_REG_COUNT || ch >= AD9959_CH_COUNT || data == NULL)
+		return 1;
+
+	ad9959_flush();		// 待写数据先发送，读到的是最新内容
+	return ad9959_read_chip(ch, reg, data);
+}
+
+/**
+ * @brief       回读寄存器并与影子寄存器比较
+ * @param       regs: 按地址的寄存器位图，CSR不参与比较
+ * @param       ch_mask: 通道位图，只影响通道寄存器
+ * @param       bad: 输出，各通道不一致的寄存器位图(全局寄存器记在通道0)，可以为NULL
+ * @retval      不一致的寄存器数，0xFF表示当前串行模式不支持读取
+ */
+uint8_t ad9959_verify_shadow(uint32_t regs, uint8_t ch_mask, uint32_t *bad)
+{
+	ad9959_shadow_t *s = &ad9959_dev_cur->shadow;
+	uint8_t data[4];
+	uint8_t ch, reg, n = 0;
+
+	if(bad != NULL)
+		memset(bad, 0, AD9959_CH_COUNT * sizeof(uint32_t));
+	regs &= ~(1UL << CSR);
+	ad9959_flush();
+	s->valid[0] &= ~(1UL << CSR);		// 干扰也可能改变了芯片CSR的通道选择，读取前重新选中通道
+
+	for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+	{
+		for(reg = FR1; reg < AD9959_REG_COUNT; reg++)
+		{
+			if(!(regs & (1UL << reg)))
+				continue;
+			if(reg <= FR2 ? (ch != 0) : !(ch_mask & (1 << ch)))
+				continue;
+			if(!(s->valid[ch] & (1UL << reg)))
+				continue;		// 芯片内容未知，无从比较
+
+			if(ad9959_read_chip(ch, reg, data))
+				return 0xFF;
+			if(memcmp(data, &s->chip[ch][ad9959_reg_ofs[reg]], ad9959_reg_len[reg]) == 0)
+				continue;
+
+			/* 芯片内容与记录不符：标记为未知并待写，下一次ad9959_flush()只重写这些寄存器 */
+			s->valid[ch] &= ~(1UL << reg);
+			s->dirty[ch] |= (1UL << reg);
+			if(bad != NULL)
+				bad[ch] |= (1UL << reg);
+			n++;
+		}
+	}
+	return n;
+}
+
+/*********************************状态快照*********************************************/
+
+/**
+ * 快照格式(多字节数据高字节在前)：
+ * 魔数0xAD 0x59，版本，系统时钟(4字节)，
+ * 通道0-3各一个寄存器位图(4字节)及位图中寄存器的数据(按地址顺序)，最后是CRC-16/CCITT
+ * 只保存与复位值不同或应用程序写过的寄存器，全局寄存器只在通道0
+ */
+#define AD9959_SNAPSHOT_MAGIC0		0xAD
+#define AD9959_SNAPSHOT_MAGIC1		0x59
+#define AD9959_SNAPSHOT_VERSION		1
+#define AD9959_SNAPSHOT_HEADER		7
+#define AD9959_RESET_KNOWN_MASK		((1UL << CFR) | (1UL << CFTW0) | (1UL << CPOW0))	/* 复位后内容已知的通道寄存器 */
+
+/**
+ * @brief       寄存器的复位值
+ * @param       reg: 寄存器地址
+ * @param       data: 输出，按寄存器长度
+ * @retval      无
+ * @note        与ad9959_shadow_reset()一致，复位后未知的寄存器按0处理
+ */
+static void ad9959_reg_default(uint8_t reg, uint8_t *data)
+{
+	memset(data, 0, ad9959_reg_len[reg]);
+	if(reg == CSR)
+		data[0] = 0xF0;
+	else if(reg == CFR)
+	{
+		data[1] = 0x03;
+		data[2] = 0x02;
+	}
+}
+
+/* 32位数据，高字节在前 */
+static void ad9959_snap_put32(uint8_t *p, uint32_t v)
+{
+	p[0] = (uint8_t)(v >> 24);
+	p[1] = (uint8_t)(v >> 16);
+	p[2] = (uint8_t)(v >> 8);
+	p[3] = (uint8_t)v;
+}
+
+static uint32_t ad9959_snap_get32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+/**
+ * @brief       CRC-16/CCITT
+ * @param       buf: 数据
+ * @param       len: 字节数
+ * @retval      校验值
+ */
+static uint16_t ad9959_crc16(const uint8_t *buf, uint16_t len)
+{
+	uint16_t crc = 0xFFFF;
+	uint8_t bit;
+
+	while(len--)
+	{
+		crc ^= (uint16_t)(*buf++ << 8);
+		for(bit = 0; bit < 8; bit++)
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+	}
+	return crc;
+}
+
+/**
+ * @brief       保存当前器件的逻辑状态
+ * @param       buf: 输出缓冲区
+ * @param       size: 缓冲区字节数，AD9959_SNAPSHOT_MAX_BYTES足够
+ * @retval      快照字节数，缓冲区不足时返回0
+ */
+uint16_t ad9959_snapshot(uint8_t *buf, uint16_t size)
+{
+	const ad9959_shadow_t *s = &ad9959_dev_cur->shadow;
+	uint8_t def[4];
+	uint32_t mask, known;
+	uint16_t len = AD9959_SNAPSHOT_HEADER, crc;
+	uint8_t ch, reg, ofs;
+
+	if(size < AD9959_SNAPSHOT_HEADER + 2)
+		return 0;
+	buf[0] = AD9959_SNAPSHOT_MAGIC0;
+	buf[1] = AD9959_SNAPSHOT_MAGIC1;
+	buf[2] = AD9959_SNAPSHOT_VERSION;
+	ad9959_snap_put32(&buf[3], ad9959_dev_cur->sys_clk);
+
+	for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+	{
+		/* 复位后已知且与复位值相同的寄存器不保存；未知的寄存器写过就保存 */
+		known = (ch == 0) ? (AD9959_GLOBAL_REG_MASK | AD9959_RESET_KNOWN_MASK) : AD9959_RESET_KNOWN_MASK;
+		mask = 0;
+		for(reg = (ch == 0) ? CSR : CFR; reg < AD9959_REG_COUNT; reg++)
+		{
+			ad9959_reg_default(reg, def);
+			if(memcmp(&s->want[ch][ad9959_reg_ofs[reg]], def, ad9959_reg_len[reg]) != 0
+				|| (((s->valid[ch] | s->dirty[ch]) & ~known) & (1UL << reg)))
+				mask |= (1UL << reg);
+		}
+
+		if(len + 4 > size)
+			return 0;
+		ad9959_snap_put32(&buf[len], mask);
+		len += 4;
+		for(reg = CSR; reg < AD9959_REG_COUNT; reg++)
+		{
+			if(!(mask & (1UL << reg)))
+				continue;
+			ofs = ad9959_reg_ofs[reg];
+			if(len + ad9959_reg_len[reg] > size)
+				return 0;
+			memcpy(&buf[len], &s->want[ch][ofs], ad9959_reg_len[reg]);
+			len += ad9959_reg_len[reg];
+		}
+	}
+
+	if(len + 2 > size)
+		return 0;
+	crc = ad9959_crc16(buf, len);
+	buf[len++] = (uint8_t)(crc >> 8);
+	buf[len++] = (uint8_t)crc;
+	return len;
+}
+
+/**
+ * @brief       从快照恢复当前器件的逻辑状态并发送
+ * @param       buf: 快照
+ * @param       len: 快照字节数
+ * @retval      0: 成功  1: 快照损坏、版本不符或系统时钟不同，没有修改任何状态
+ */
+uint8_t ad9959_restore(const uint8_t *buf, uint16_t len)
+{
+	ad9959_shadow_t *s = &ad9959_dev_cur->shadow;
+	uint8_t want[AD9959_CH_COUNT][AD9959_REG_FILE_BYTES];
+	uint32_t mask[AD9959_CH_COUNT];
+	uint16_t pos = AD9959_SNAPSHOT_HEADER;
+	uint8_t ch, reg, ofs;
+
+	/* 先完整校验，失败时不修改影子寄存器 */
+	if(len < AD9959_SNAPSHOT_HEADER + 2 || buf[0] != AD9959_SNAPSHOT_MAGIC0 || buf[1] != AD9959_SNAPSHOT_MAGIC1
+		|| buf[2] != AD9959_SNAPSHOT_VERSION)
+		return 1;
+	if(ad9959_crc16(buf, (uint16_t)(len - 2)) != (uint16_t)((buf[len - 2] << 8) | buf[len - 1]))
+		return 1;
+	if(ad9959_snap_get32(&buf[3]) != ad9959_dev_cur->sys_clk)
+		return 1;		// 频率控制字按快照时的系统时钟计算
+
+	for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+	{
+		for(reg = CSR; reg < AD9959_REG_COUNT; reg++)
+			ad9959_reg_default(reg, &want[ch][ad9959_reg_ofs[reg]]);
+
+		if(pos + 4 > len - 2)
+			return 1;
+		mask[ch] = ad9959_snap_get32(&buf[pos]);
+		pos += 4;
+		if((mask[ch] >> AD9959_REG_COUNT) != 0 || (ch != 0 && (mask[ch] & AD9959_GLOBAL_REG_MASK)))
+			return 1;
+		for(reg = CSR; reg < AD9959_REG_COUNT; reg++)
+		{
+			if(!(mask[ch] & (1UL << reg)))
+				continue;
+			ofs = ad9959_reg_ofs[reg];
+			if(pos + ad9959_reg_len[reg] > len - 2)
+				return 1;
+			memcpy(&want[ch][ofs], &buf[pos], ad9959_reg_len[reg]);
+			pos += ad9959_reg_len[reg];
+		}
+	}
+	if(pos != len - 2)
+		return 1;
+
+	/* 串行模式属于接线，保持当前器件的设置 */
+	want[0][0] = (uint8_t)((want[0][0] & ~AD9959_CSR_MODE_MASK) | ad9959_dev_cur->serial_mode);
+
+	/* 写入影子寄存器：快照中的寄存器和数值改变的寄存器待写，芯片中已经相同的由ad9959_flush()跳过 */
+	for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+	{
+		for(reg = (ch == 0) ? CSR : CFR; reg < AD9959_REG_COUNT; reg++)
+		{
+			ofs = ad9959_reg_ofs[reg];
+			if((mask[ch] & (1UL << reg)) || memcmp(&s->want[ch][ofs], &want[ch][ofs], ad9959_reg_len[reg]) != 0)
+				s->dirty[ch] |= (1UL << reg);
+		}
+		memcpy(s->want[ch], want[ch], AD9959_REG_FILE_BYTES);
+	}
+
+	IO_update();		// 一次分组突发写入后生效
+	return 0;
+}
+
+/**
+ * @brief       写入影子寄存器(AD9959_WriteData_Unified的实现)
+ * @param       reg: 寄存器地址
+ * @param       DataNumber: 数据字节数
+ * @param       Data: 数据指针
+ * @retval      无
+ */
+static void ad9959_write_unified(uint8_t reg, uint8_t DataNumber, uint8_t *Data)
+{
+	uint8_t ch, ofs, channels;
+
+	/* 长度不符时芯片会把多余的字节当作下一条指令，写入的内容无法确定，不发送 */
+	if(reg >= AD9959_REG_COUNT || Data == NULL || DataNumber != ad9959_reg_len[reg])
+		return;
+
+	ofs = ad9959_reg_ofs[reg];
+	if(reg <= FR2)
+	{
+		/* 全局寄存器，保存在通道0 */
+		memcpy(&ad9959_dev_cur->shadow.want[0][ofs], Data, DataNumber);
+		if(reg != CSR)
+			ad9959_dev_cur->shadow.dirty[0] |= (1UL << reg);
+		else	// 串行模式位由ad9959_set_serial_mode()管理，调用者只选择通道
+			ad9959_dev_cur->shadow.want[0][ofs] = (uint8_t)((Data[0] & ~AD9959_CSR_MODE_MASK) | ad9959_dev_cur->serial_mode);
+		return;
+	}
+
+	/* 通道寄存器，写入CSR选中的所有通道 */
+	channels = ad9959_dev_cur->shadow.want[0][0] >> 4;
+	for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+	{
+		if(channels & (1 << ch))
+		{
+			memcpy(&ad9959_dev_cur->shadow.want[ch][ofs], Data, DataNumber);
+			ad9959_dev_cur->shadow.dirty[ch] |= (1UL << reg);
+		}
+	}
+}
+
+/**
+ * @brief       AD9959统一数据写入函数
+ * @param       reg: 寄存器地址 (0x00-0x18)
+ * @param       DataNumber: 要写入的数据字节数
+ * @param       Data: 指向要写入数据的指针
+ * @retval      无
+ * @note        数据先写入影子寄存器并标记脏位，由ad9959_flush()或IO_update()统一发送
+ *              写CSR只改变后续通道寄存器写入的目标通道，真正发送时按需切换
+ *              地址无效或长度与寄存器不符的写入被忽略，影子寄存器不变
+ */
+void AD9959_WriteData_Unified(uint8_t reg, uint8_t DataNumber, uint8_t *Data)
+{
+	AD9959_TRACE_BEGIN(AD9959_TRACE_API_WRITE, reg);
+	ad9959_write_unified(reg, DataNumber, Data);
+	AD9959_TRACE_END();
 }
 
 /**
- * @brief       AD9959数据更新函数
- * @param       无
+ * @brief       突发写入一组寄存器
+ * @param       items: 寄存器列表，可以包含CSR以切换后续寄存器的目标通道
+ * @param       count: 寄存器个数
  * @retval      无
- * @note        向AD9959发送更新脉冲，使之前写入的寄存器数据生效
- *              必须在写入频率、相位、幅度等参数后调用此函数
+ * @note        经过影子寄存器，未改变的寄存器被跳过，其余在一次片选内发送
+ *              不产生IO_update
  */
-void IO_update(void)
+void ad9959_write_burst(const ad9959_burst_item_t *items, uint8_t count)
 {
-	AD9959_UD(0);		// 确保更新信号为低电平
-	AD9959_DELAY(6);	// 延时确保信号稳定
-	AD9959_UD(1);		// 更新信号拉高，产生上升沿
-	AD9959_DELAY(12);	// 保持高电平，满足更新脉冲宽度要求
-	AD9959_UD(0);		// 更新信号拉低，完成更新脉冲
+	uint8_t i;
+
+	for(i = 0; i < count; i++)
+		AD9959_WriteData_Unified(items[i].reg, items[i].len, (uint8_t *)items[i].data);
+	ad9959_flush();
 }
 
+/* round(num * 2^32 / den)所用的倒数，按分母缓存(Hz/mHz/uHz各一项) */
+typedef struct
+{
+	uint64_t den;		/* 分母 */
+	uint64_t recip;		/* floor(2^(64+k) / den)，位于[2^63, 2^64) */
+	uint8_t  shift;		/* 32 + k */
+} ad9959_recip_t;
+
+static ad9959_recip_t ad9959_recip_cache[3];
+
 /**
- * @brief       向AD9959写入数据
- * @param       reg: 寄存器地址 (0x00-0x09)
- * @param       DataNumber: 要写入的数据字节数
- * @param       Data: 指向要写入数据的指针
+ * @brief       64位乘64位得到128位乘积
+ * @param       a, b: 乘数
+ * @param       hi, lo: 输出，乘积的高/低64位
  * @retval      无
- * @note        使用SPI协议向AD9959指定寄存器写入数据
- *              先发送8位寄存器地址，再发送指定字节数的数据
+ * @note        拆成4次32位乘法，M7上对应UMULL指令
  */
-void AD9959_WriteData(uint8_t reg, uint8_t DataNumber, uint8_t *Data)
+static void ad9959_mul_64x64(uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo)
 {
-	uint8_t	CMD, Value, cnt, i;
-	CMD = reg;
+	uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+	uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+	uint64_t p0 = a_lo * b_lo, p1 = a_lo * b_hi, p2 = a_hi * b_lo, p3 = a_hi * b_hi;
+	uint64_t mid = (p0 >> 32) + (uint32_t)p1 + (uint32_t)p2;
 
-	/* 开始SPI通信：时钟拉低，片选拉低 */
-	AD9959_CLK(0);
-	AD9959_CS(0);		// 选中AD9959芯片
+	*lo = (mid << 32) | (uint32_t)p0;
+	*hi = p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+}
 
-	/* 发送8位寄存器地址 */
-	for(i=0; i<8; i++)
+/**
+ * @brief       获取(必要时计算)分母对应的倒数
+ * @param       den: 分母 (2 ~ 2^63-1)
+ * @retval      倒数缓存项
+ * @note        只在分母第一次出现时做一次长除法
+ */
+static const ad9959_recip_t *ad9959_recip_get(uint64_t den)
+{
+	ad9959_recip_t *c;
+	uint64_t rem = 1, recip = 0;
+	uint8_t i, k = 0;
+
+	for(i = 0; i < 3; i++)
 	{
-		AD9959_CLK(0);						// 时钟拉低，准备数据
-		if(0x80 == (CMD & 0x80))			// 检查最高位
-			AD9959_SD0(1);					// 发送1
-		else
-			AD9959_SD0(0);					// 发送0
-		AD9959_CLK(1);						// 时钟拉高，AD9959采样数据
-		CMD <<= 1;							// 左移1位，准备下一位数据
+		if(ad9959_recip_cache[i].den == den)
+			return &ad9959_recip_cache[i];
 	}
-	AD9959_CLK(0);
 
-	/* 发送数据字节 */
-	for (cnt=0; cnt<DataNumber; cnt++)
+	/* 新分母替换最早的缓存项 */
+	memmove(&ad9959_recip_cache[1], &ad9959_recip_cache[0], 2 * sizeof(ad9959_recip_t));
+	c = &ad9959_recip_cache[0];
+
+	/* k = floor(log2(den - 1))，保证倒数小于2^64 */
+	while(((den - 1) >> (k + 1)) != 0)
+		k++;
+
+	/* recip = floor(2^(64+k) / den)，移位减法长除 */
+	for(i = 0; i < 64 + k; i++)
 	{
-		Value = Data[cnt];					// 获取当前要发送的字节
-		for (i=0; i<8; i++)
+		rem <<= 1;
+		recip <<= 1;
+		if(rem >= den)
 		{
-			AD9959_CLK(0);					// 时钟拉低，准备数据
-			if(0x80 == (Value & 0x80))		// 检查最高位
-				AD9959_SD0(1);				// 发送1
-			else
-				AD9959_SD0(0);				// 发送0
-			AD9959_CLK(1);					// 时钟拉高，AD9959采样数据
-			Value <<= 1;					// 左移1位，准备下一位数据
+			rem -= den;
+			recip |= 1;
 		}
-		AD9959_CLK(0);
 	}
 
-	/* 结束SPI通信：片选拉高 */
-	AD9959_CS(1);
+	c->den = den;
+	c->recip = recip;
+	c->shift = (uint8_t)(32 + k);
+	return c;
 }
 
 /**
- * @brief       AD9959 SPI数据写入函数
- * @param       reg: 寄存器地址 (0x00-0x09)
- * @param       DataNumber: 要写入的数据字节数
- * @param       Data: 指向要写入数据的指针
- * @retval      无
- * @note        该函数目前未实现，保留以便未来扩展SPI数据写入功能
- *              目前所有数据写入通过AD9959_WriteData函数完成
+ * @brief       用已取得的倒数计算 round(num * 2^32 / den) 的低32位
+ * @param       num: 分子
+ * @param       den: 分母 (2 ~ 2^63-1)
+ * @param       c: den的倒数缓存项
+ * @retval      32位结果，四舍五入
+ * @note        先用倒数乘法估计商(误差不超过1)，再用精确余数修正并舍入，
+ *              全程整数运算，结果与精确值四舍五入一致
+ *              整数部分乘以2^32后对32位取模为0，所以num不小于den时只保留余数
  */
-void AD9959_WriteData_SPI(uint8_t reg, uint8_t DataNumber, uint8_t *Data)
+static uint32_t ad9959_ratio_q32_recip(uint64_t num, uint64_t den, const ad9959_recip_t *c)
 {
-	/* 开始SPI通信：片选拉低 */
-	AD9959_CS(0);		// 选中AD9959芯片
+	uint64_t hi, lo, q, rem;
 
-	/* 发送8位寄存器地址 */
-	HAL_SPI_Transmit(&AD9959_SPI_HANDLE, &reg, 1, HAL_MAX_DELAY);
+	if(num >= den)
+		num %= den;
 
-	/* 发送数据字节 */
-	if(DataNumber > 0 && Data != NULL)
+	/* 估计商 q = floor(num * recip / 2^(32+k)) */
+	ad9959_mul_64x64(num, c->recip, &hi, &lo);
+	if(c->shift >= 64)
+		q = hi >> (c->shift - 64);
+	else
+		q = (hi << (64 - c->shift)) | (lo >> c->shift);
+
+	/* 精确余数 num*2^32 - q*den 在[0, 2*den)内，按2^64取模计算即可 */
+	rem = (num << 32) - q * den;
+	if(rem >= den)
 	{
-		HAL_SPI_Transmit(&AD9959_SPI_HANDLE, Data, DataNumber, HAL_MAX_DELAY);
+		rem -= den;
+		q++;
 	}
 
-	/* 结束SPI通信：片选拉高 */
-	AD9959_CS(1);
+	/* 剩余部分不小于0.5则进位 */
+	if((rem << 1) >= den)
+		q++;
+	return (uint32_t)q;
 }
 
 /**
- * @brief       AD9959统一数据写入函数
- * @param       reg: 寄存器地址 (0x00-0x09)
- * @param       DataNumber: 要写入的数据字节数
- * @param       Data: 指向要写入数据的指针
+ * @brief       计算 round(num * 2^32 / den) 的低32位
+ * @param       num: 分子
+ * @param       den: 分母 (2 ~ 2^63-1)
+ * @retval      32位结果，四舍五入
+ */
+static uint32_t ad9959_ratio_q32(uint64_t num, uint64_t den)
+{
+	return ad9959_ratio_q32_recip(num, den, ad9959_recip_get(den));
+}
+
+/**
+ * @brief       由整数Hz计算频率控制字
+ * @param       fre_hz: 频率 (Hz)
+ * @retval      32位频率控制字，FTW = round(fre * 2^32 / System_Clock)
+ */
+uint32_t ad9959_ftw_from_hz(uint32_t fre_hz)
+{
+	return ad9959_ratio_q32(fre_hz, ad9959_dev_cur->sys_clk);
+}
+
+/**
+ * @brief       由毫赫兹计算频率控制字
+ * @param       fre_mhz: 频率 (0.001Hz)
+ * @retval      32位频率控制字
+ */
+uint32_t ad9959_ftw_from_millihz(uint64_t fre_mhz)
+{
+	return ad9959_ratio_q32(fre_mhz, (uint64_t)ad9959_dev_cur->sys_clk * 1000U);
+}
+
+/**
+ * @brief       由微赫兹计算频率控制字
+ * @param       fre_uhz: 频率 (0.000001Hz)
+ * @retval      32位频率控制字
+ */
+uint32_t ad9959_ftw_from_microhz(uint64_t fre_uhz)
+{
+	return ad9959_ratio_q32(fre_uhz, (uint64_t)ad9959_dev_cur->sys_clk * 1000000U);
+}
+
+/**
+ * @brief       32位数据按高字节在前拆分为4个字节
+ * @param       Value: 32位数据
+ * @param       Data: 输出，4字节
  * @retval      无
- * @note        根据编译时宏定义自动选择使用软件SPI或硬件SPI
- *              定义AD9959_USE_HARDWARE_SPI宏则使用硬件SPI，否则使用软件SPI
- *              该函数是对底层SPI通信的统一封装，用户只需调用此函数即可
  */
-void AD9959_WriteData_Unified(uint8_t reg, uint8_t DataNumber, uint8_t *Data)
+static void ad9959_put_u32(uint32_t Value, uint8_t *Data)
 {
-#ifdef AD9959_USE_HARDWARE_SPI
-	/* 使用硬件SPI模式 */
-	AD9959_WriteData_SPI(reg, DataNumber, Data);
-#else
-	/* 使用软件SPI模式（默认） */
-	AD9959_WriteData(reg, DataNumber, Data);
-#endif
+	Data[0] = (uint8_t)(Value>>24);		// 最高字节
+	Data[1] = (uint8_t)(Value>>16);		// 次高字节
+	Data[2] = (uint8_t)(Value>>8);		// 次低字节
+	Data[3] = (uint8_t)Value;			// 最低字节
 }
 
 /**
@@ -202,23 +1623,15 @@ void AD9959_WriteData_Unified(uint8_t reg, uint8_t DataNumber, uint8_t *Data)
  * @param       CFTW0_Data: 指向4字节频率控制字数组的指针
  * @retval      无
  * @note        根据公式 CFTW0 = fre * 2^32 / System_Clock 计算32位频率控制字
- *              System_Clock = 500MHz�����频率分辨率约为0.116Hz
+ *              频率先换算为微赫兹整数，再用ad9959_ftw_from_microhz()四舍五入计算
+ *              System_Clock = 500MHz时频率分辨率约为0.116Hz
  */
 void AD9959_Get_CFTW0_Data(double fre, uint8_t *CFTW0_Data)
 {
-	double buff;
-	uint32_t Value;
+	uint64_t fre_uhz;
 
-	/* 计算频率控制字：CFTW0 = fre * 2^32 / System_Clock */
-	buff = 4294967296.0 / AD9959_System_Clk;	// 2^32 / 500MHz
-	buff = buff * fre;							// 乘以目标频率
-	Value = (uint32_t)buff;						// 转换为32位整数
-
-	/* 将32位数据拆分为4个字节，高字节在前 */
-	CFTW0_Data[0] = (uint8_t)(Value>>24);		// 最高字节
-	CFTW0_Data[1] = (uint8_t)(Value>>16);		// 次高字节
-	CFTW0_Data[2] = (uint8_t)(Value>>8);		// 次低字节
-	CFTW0_Data[3] = (uint8_t)Value;				// 最低字节
+	fre_uhz = (fre > 0) ? (uint64_t)(fre * 1000000.0 + 0.5) : 0;	// 换算为微赫兹
+	ad9959_put_u32(ad9959_ftw_from_microhz(fre_uhz), CFTW0_Data);
 }
 
 /**
@@ -227,17 +1640,14 @@ void AD9959_Get_CFTW0_Data(double fre, uint8_t *CFTW0_Data)
  * @param       CPOW0_Data: 指向2字节相��控制字数组的指针
  * @retval      无
  * @note        根据公式 CPOW0 = phase * 2^14 / 360 计算14位相位控制字
- *              相位分辨率为360/2^14 ≈ 0.022度
+ *              相位分辨率为360/2^14 ≈ 0.022度；phase取低16位，用AD9959_POW_FROM_DEG()整数计算
  */
 void AD9959_Get_CPOW0_Data(int phase, uint8_t *CPOW0_Data)
 {
-	double buff;
 	uint32_t Value;
 
 	/* 计算相位控制字：CPOW0 = phase * 2^14 / 360 */
-	buff = 16384.0/360;						// 2^14 / 360度
-	buff = phase * buff;					// 乘以目标相位
-	Value = (uint32_t)buff;					// 转换为整数
+	Value = AD9959_POW_FROM_DEG((uint16_t)phase);
 
 	/* 将14位数据拆分为2个字节，高字节在前 */
 	CPOW0_Data[0] = (uint8_t)(Value>>8);	// 高字节(包含高6位)
@@ -293,7 +1703,7 @@ void ad9959_set_signal_out(uint8_t ch, double fre, uint16_t phase, uint16_t amp)
 	uint8_t CPOW0_Data[2];					// 相位控制字缓存
 	uint8_t ACR_Data[3] = {0x00,0x10,0x00};	// 幅度控制寄存器配置
 	uint8_t CFR_Data[3] = {0x00,0x23,0x35};	// 通道功能寄存器配置
-	uint8_t FR1_Data[3] = {0xD0,0x00,0x00};	// 功能寄存器1配置
+	uint8_t FR1_Data[3] = {ad9959_fr1_clock(),0x00,0x00};	// 功能寄存器1配置
 
 	/* ����要操作的通道 */
 	ad9959_channel_sel_enable(ch);
@@ -318,6 +1728,195 @@ void ad9959_set_signal_out(uint8_t ch, double fre, uint16_t phase, uint16_t amp)
 	IO_update();
 }
 
+/**
+ * @brief       把多个通道的参数写入影子寄存器
+ * @param       cfg: 各通道参数
+ * @param       count: 通道数
+ * @param       CFR_Data: 各通道的CFR配置
+ * @retval      无
+ */
+static void ad9959_load_channels(const ad9959_channel_cfg_t *cfg, uint8_t count, uint8_t *CFR_Data)
+{
+	uint8_t CFTW0_Data[4];					// 频率控制字缓存
+	uint8_t CPOW0_Data[2];					// 相位控制字缓存
+	uint8_t ACR_Data[3];					// 幅度控制寄存器配置
+	uint8_t FR1_Data[3] = {ad9959_fr1_clock(),0x00,0x00};	// 功能寄存器1配置
+	uint8_t i;
+
+	AD9959_WriteData_Unified(FR1, 3, FR1_Data);
+
+	for(i = 0; i < count; i++)
+	{
+		ad9959_channel_sel_enable(cfg[i].ch);
+		AD9959_WriteData_Unified(CFR, 3, CFR_Data);
+
+		ACR_Data[0] = 0x00;
+		ACR_Data[1] = 0x10;
+		ACR_Data[2] = 0x00;
+		AD9959_Get_ACR_Data(cfg[i].amp, ACR_Data);
+		AD9959_WriteData_Unified(ACR, 3, ACR_Data);
+
+		AD9959_Get_CPOW0_Data(cfg[i].phase, CPOW0_Data);
+		AD9959_WriteData_Unified(CPOW0, 2, CPOW0_Data);
+
+		ad9959_put_u32(ad9959_ftw_from_millihz(cfg[i].fre_mhz), CFTW0_Data);
+		AD9959_WriteData_Unified(CFTW0, 4, CFTW0_Data);
+	}
+}
+
+/**
+ * @brief       同时设置多个通道的输出
+ * @param       cfg: 各通道参数
+ * @param       count: 通道数
+ * @retval      无
+ * @note        寄存器配置与ad9959_set_signal_out()相同，但所有通道只产生一次IO_update
+ *              例如3个通道同为1MHz时，CFR/ACR/CFTW0各只发送一次
+ */
+void ad9959_set_channels(const ad9959_channel_cfg_t *cfg, uint8_t count)
+{
+	uint8_t CFR_Data[3] = {0x00,0x23,0x35};	// 通道功能寄存器配置：单频模式
+
+	ad9959_load_channels(cfg, count, CFR_Data);
+
+	/* 一次更新，所有通道同时生效 */
+	IO_update();
+}
+
+/**
+ * @brief       批量换算各通道的频率/相位/幅度控制字
+ * @param       cfg: 各通道参数
+ * @param       count: 通道数 (不超过AD9959_CH_COUNT)
+ * @param       ftw: 输出，频率控制字
+ * @param       pow: 输出，相位控制字
+ * @param       asf: 输出，幅度控制字
+ * @retval      无
+ * @note        每种控制字一个循环，循环内没有分支和函数指针，相位/幅度循环可以由编译器向量化；
+ *              频率的分母相同，倒数只查找一次；结果与AD9959_Get_CPOW0_Data()等逐个换算相同
+ */
+static void ad9959_encode_channels(const ad9959_channel_cfg_t *cfg, uint8_t count,
+								   uint32_t *ftw, uint32_t *pow, uint32_t *asf)
+{
+	uint64_t den = (uint64_t)ad9959_dev_cur->sys_clk * 1000U;
+	const ad9959_recip_t *c = ad9959_recip_get(den);
+	uint8_t i;
+
+	for(i = 0; i < count; i++)
+		pow[i] = AD9959_POW_FROM_DEG(cfg[i].phase);
+	for(i = 0; i < count; i++)
+		asf[i] = cfg[i].amp & 0x03FFU;
+	for(i = 0; i < count; i++)
+		ftw[i] = ad9959_ratio_q32_recip(cfg[i].fre_mhz, den, c);
+}
+
+/**
+ * @brief       把多个通道的参数批量写入影子寄存器
+ * @param       cfg: 各通道参数
+ * @param       count: 通道数
+ * @retval      0: 成功  1: 通道号错误
+ */
+uint8_t ad9959_load_all(const ad9959_channel_cfg_t *cfg, uint8_t count)
+{
+	uint8_t CFR_Data[3] = {0x00,0x23,0x35};	// 与ad9959_set_channels()相同：单频模式
+	uint8_t FR1_Data[3] = {ad9959_fr1_clock(),0x00,0x00};
+	uint32_t ftw[AD9959_CH_COUNT], pow[AD9959_CH_COUNT], asf[AD9959_CH_COUNT];
+	uint8_t i, n, ch, *w;
+
+	/* 先检查全部通道号，出错时不写入任何寄存器 */
+	for(i = 0; i < count; i++)
+	{
+		if(cfg[i].ch >= AD9959_CH_COUNT)
+			return 1;
+	}
+
+	AD9959_WriteData_Unified(FR1, 3, FR1_Data);
+
+	while(count > 0)
+	{
+		n = (count > AD9959_CH_COUNT) ? AD9959_CH_COUNT : count;
+		ad9959_encode_channels(cfg, n, ftw, pow, asf);
+
+		/* 直接写入各通道的影子寄存器，不经过CSR选择 */
+		for(i = 0; i < n; i++)
+		{
+			ch = cfg[i].ch;
+			w = ad9959_dev_cur->shadow.want[ch];
+			memcpy(&w[ad9959_reg_ofs[CFR]], CFR_Data, 3);
+			w[ad9959_reg_ofs[ACR]]     = 0x00;
+			w[ad9959_reg_ofs[ACR] + 1] = (uint8_t)(0x10 | (asf[i] >> 8));
+			w[ad9959_reg_ofs[ACR] + 2] = (uint8_t)asf[i];
+			w[ad9959_reg_ofs[CPOW0]]     = (uint8_t)(pow[i] >> 8);
+			w[ad9959_reg_ofs[CPOW0] + 1] = (uint8_t)pow[i];
+			ad9959_put_u32(ftw[i], &w[ad9959_reg_ofs[CFTW0]]);
+			ad9959_dev_cur->shadow.dirty[ch] |= (1UL << CFR) | (1UL << ACR) | (1UL << CPOW0) | (1UL << CFTW0);
+		}
+		cfg += n;
+		count -= n;
+	}
+	return 0;
+}
+
+/**
+ * @brief       批量设置多个通道的输出
+ * @param       cfg: 各通道参数
+ * @param       count: 通道数
+ * @retval      0: 成功  1: 通道号错误
+ */
+uint8_t ad9959_set_all(const ad9959_channel_cfg_t *cfg, uint8_t count)
+{
+	if(ad9959_load_all(cfg, count))
+		return 1;
+	IO_update();
+	return 0;
+}
+
+/**
+ * @brief       多通道相位相干启动
+ * @param       cfg: 各通道参数，phase为相对相位
+ * @param       count: 通道数
+ * @retval      无
+ * @note        按数据手册的清零顺序，两次IO_update都在函数内完成：
+ *              1. 写入全部通道参数并置位FR2[12]，IO_update：新参数生效，所有通道的相位累加器清零并保持为0
+ *              2. FR2[12]写0，IO_update：所有通道的相位累加器在同一个SYNC_CLK同时开始累加
+ *              通道间相位差即各自的CPOW0；CFR不置位自动清零，返回时芯片中的FR2已经恢复，
+ *              之后的跳频等IO_update不会再清零相位，各通道间的相位关系不受影响
+ */
+void ad9959_start_coherent(const ad9959_channel_cfg_t *cfg, uint8_t count)
+{
+	uint8_t CFR_Data[3] = {0x00,0x23,0x31};	// 单频模式，相位累加器不自动清零
+	uint8_t FR2_Data[2];
+
+	ad9959_load_channels(cfg, count, CFR_Data);
+
+	/* 参数生效，相位累加器清零并保持 */
+	memcpy(FR2_Data, &ad9959_dev_cur->shadow.want[0][ad9959_reg_ofs[FR2]], 2);
+	FR2_Data[0] |= AD9959_FR2_ALL_CLR_PHASE;
+	AD9959_WriteData_Unified(FR2, 2, FR2_Data);
+	IO_update();
+
+	/* 释放清零，所有通道同时开始累加 */
+	FR2_Data[0] &= (uint8_t)~AD9959_FR2_ALL_CLR_PHASE;
+	AD9959_WriteData_Unified(FR2, 2, FR2_Data);
+	IO_update();
+}
+
+/**
+ * @brief       设置指定通道的输出频率
+ * @param       ch: 输出通道 (0-3)
+ * @param       fre_mhz: 输出频率 (0.001Hz)
+ * @retval      无
+ * @note        只改变CFTW0，其余参数保持不变，全程整数运算
+ *              经过影子寄存器，只发送CSR(需要时)和CFTW0，然后IO_update
+ */
+void ad9959_set_frequency_millihz(uint8_t ch, uint64_t fre_mhz)
+{
+	uint8_t CFTW0_Data[4];
+
+	ad9959_put_u32(ad9959_ftw_from_millihz(fre_mhz), CFTW0_Data);
+	ad9959_channel_sel_enable(ch);
+	AD9959_WriteData_Unified(CFTW0, 4, CFTW0_Data);
+	IO_update();
+}
+
 /**
  * @brief       AD9959��性扫频功能
  * @param       ch: 输出通道 (0-3)
@@ -337,10 +1936,10 @@ void ad9959_sweep_frequency(uint8_t ch, double fre1, double fre2, double rdw, do
 	uint8_t FDW_Data[4];						// 下降步进频率控制字缓存
 	uint8_t CFTW0_Data[4];						// 频率控制字缓存
 	uint8_t CPOW0_Data[2];						// 相位控制字缓存
-	uint8_t SRR_Data[2] = {0xFF,0xFF};			// 扫描���率寄存器：最快扫描速度
+	uint8_t SRR_Data[2] = {AD9959_SWEEP_SRR_DEFAULT, AD9959_SWEEP_SRR_DEFAULT};	// 扫描斜率寄存器：FSRR、RSRR
 	uint8_t ACR_Data[3] = {0x00,0x10,0x00};		// 幅度控制寄存器配置
 	uint8_t CFR_Data[3] = {0x82, 0x43, 0x30};   // 通道功能寄存器：启用线性扫频模式  //科一电子为{0x80,0x43,0x20} 此处进行了修改;
-	uint8_t FR1_Data[3] = {0xD0,0x00,0x00};		// 功能寄存器1配置
+	uint8_t FR1_Data[3] = {ad9959_fr1_clock(),0x00,0x00};		// 功能寄存器1配置
 
 	/* 选择要操作的通道 */
 	ad9959_channel_sel_enable(ch);
@@ -399,10 +1998,10 @@ void ad9959_sweep_phase(uint8_t ch, double fre, uint16_t phase1, uint16_t phase2
 	uint8_t FDW_Data[4] = {0x00,0x00,0x00,0x00};	// 下降步进相位控制字��存
 	uint8_t CFTW0_Data[4] = {0x00,0x00,0x00,0x00};	// 频率控制字缓存
 	uint8_t CPOW0_Data[4] = {0x00,0x00,0x00,0x00};	// 相位控制字缓存
-	uint8_t SRR_Data[2] = {0xFF,0xFF};				// 扫描斜率寄存器
+	uint8_t SRR_Data[2] = {AD9959_SWEEP_SRR_DEFAULT, AD9959_SWEEP_SRR_DEFAULT};	// 扫描斜率寄存器：FSRR、RSRR
 	uint8_t ACR_Data[3] = {0x00,0x10,0x00};			// 幅度控制寄存器配置
 	uint8_t CFR_Data[3] = {0xc0,0xC3,0x30};			// 通道功能寄存器：启用线性扫相模式
-	uint8_t FR1_Data[3] = {0xD0,0x00,0x00};			// 功能寄存器1配置
+	uint8_t FR1_Data[3] = {ad9959_fr1_clock(),0x00,0x00};			// 功能寄存器1配置
 
 	/* 选择要操作的通道 */
 	ad9959_channel_sel_enable(ch);
@@ -483,10 +2082,10 @@ void ad9959_sweep_amplitude(uint8_t ch, double fre, uint16_t phase, uint16_t amp
 	uint8_t FDW_Data[4];						// 下降步进幅度控制字缓存
 	uint8_t CFTW0_Data[4];						// 频率控制字缓存
 	uint8_t CPOW0_Data[2];						// 相位控制字缓存
-	uint8_t SRR_Data[2] = {0xFF,0xFF};			// 扫描斜率寄存器
+	uint8_t SRR_Data[2] = {AD9959_SWEEP_SRR_DEFAULT, AD9959_SWEEP_SRR_DEFAULT};	// 扫描斜率寄存器：FSRR、RSRR
 	uint8_t ACR_Data[3] = {0x00,0x00,0x00};		// 幅度控制寄存器配置
 	uint8_t CFR_Data[3] = {0x40,0x43,0x20};		// 通道功能��存器��启用��性��幅模式
-	uint8_t FR1_Data[3] = {0xD0,0x00,0x00};		// 功能寄存器1配置
+	uint8_t FR1_Data[3] = {ad9959_fr1_clock(),0x00,0x00};		// 功能寄存器1配置
 
 	/* 选择要操作的通道 */
 	ad9959_channel_sel_enable(ch);
@@ -525,3 +2124,401 @@ void ad9959_sweep_amplitude(uint8_t ch, double fre, uint16_t phase, uint16_t amp
 	/* 更新输出，启动扫幅 */
 	IO_update();
 }
+
+/**
+ * @brief       按每步周期数r求步长和实际时长
+ * @param       span: 扫描范围
+ * @param       sync: 期望时长(SYNC_CLK周期)
+ * @param       r: 每步周期数
+ * @param       dw: 输出，步长
+ * @retval      实际时长，0表示步长不足1
+ */
+static uint64_t ad9959_ramp_try(uint32_t span, uint64_t sync, uint8_t r, uint32_t *dw)
+{
+	uint64_t delta = ((uint64_t)span * r + sync / 2) / sync;
+
+	if(delta == 0)
+		return 0;
+	if(delta > span)
+		delta = span;			// 一步到位
+	*dw = (uint32_t)delta;
+	return ((span + delta - 1) / delta) * r;
+}
+
+/**
+ * @brief       求扫描步长和每步周期数
+ * @param       span: 扫描范围(控制字)
+ * @param       sync: 期望时长(SYNC_CLK周期)
+ * @param       dw: 输出，步长
+ * @param       rate: 输出，每步周期数
+ * @retval      实际时长(SYNC_CLK周期)，0表示无法实现
+ */
+uint64_t ad9959_ramp_solve(uint32_t span, uint64_t sync, uint32_t *dw, uint8_t *rate)
+{
+	uint64_t actual, err, best = 0, tol = UINT64_MAX;
+	uint32_t delta, best_dw = 0xFFFFFFFFUL;
+	uint16_t r;
+
+	if(span == 0 || sync == 0)
+		return 0;
+
+	/* 所有组合中的最小时长误差 */
+	for(r = 1; r <= 255; r++)
+	{
+		actual = ad9959_ramp_try(span, sync, (uint8_t)r, &delta);
+		if(actual == 0)
+			continue;
+		err = (actual > sync) ? actual - sync : sync - actual;
+		if(err < tol)
+			tol = err;
+	}
+	if(tol == UINT64_MAX)
+		return 0;				// r = 255时步长仍不足1
+	if(tol < sync / 1000)
+		tol = sync / 1000;
+
+	/* 满足时长的组合中步长最小的 */
+	for(r = 1; r <= 255; r++)
+	{
+		actual = ad9959_ramp_try(span, sync, (uint8_t)r, &delta);
+		if(actual == 0)
+			continue;
+		err = (actual > sync) ? actual - sync : sync - actual;
+		if(err <= tol && delta < best_dw)
+		{
+			best_dw = delta;
+			best = actual;
+			*dw = delta;
+			*rate = (uint8_t)r;
+		}
+	}
+	return best;
+}
+
+/**
+ * @brief       SYNC_CLK周期数换算为ns
+ * @param       sync: SYNC_CLK周期数
+ * @retval      时长(ns)
+ * @note        先除后乘：扫描时长最长约2^40个周期，直接乘10^9会超出64位
+ */
+static uint64_t ad9959_sync_to_ns(uint64_t sync)
+{
+	uint32_t clk = AD9959_SYNC_CLK;
+
+	return sync / clk * 1000000000ULL + sync % clk * 1000000000ULL / clk;
+}
+
+/**
+ * @brief       配置扫描模式和上升/下降斜率
+ * @param       ch: 输出通道
+ * @param       CFR_Data: 扫描模式的CFR
+ * @param       span: 扫描范围(控制字)
+ * @param       shift: 步长在RDW/FDW中的左移位数，扫频0，扫相18，扫幅22
+ * @param       e0: CW1(E0)的值，已按shift对齐
+ * @param       rise_us: 上升时间
+ * @param       fall_us: 下降时间
+ * @param       ramp: 输出实际值，可以为NULL
+ * @retval      0: 成功  1: 斜率太小
+ * @note        只写入影子寄存器，S0和固定参数由调用者写入后IO_update
+ */
+static uint8_t ad9959_sweep_ramp(uint8_t ch, uint8_t *CFR_Data, uint32_t span, uint8_t shift, uint32_t e0,
+								 uint32_t rise_us, uint32_t fall_us, ad9959_ramp_t *ramp)
+{
+	uint8_t FR1_Data[3] = {ad9959_fr1_clock(),0x00,0x00};		// 功能寄存器1配置
+	uint8_t SRR_Data[2];						// FSRR、RSRR
+	uint8_t Data[4];
+	ad9959_ramp_t r;
+	uint64_t rise, fall;
+
+	rise = ad9959_ramp_solve(span, (uint64_t)rise_us * AD9959_SYNC_CLK / 1000000ULL, &r.rdw, &r.rsrr);
+	fall = ad9959_ramp_solve(span, (uint64_t)fall_us * AD9959_SYNC_CLK / 1000000ULL, &r.fdw, &r.fsrr);
+	if(rise == 0 || fall == 0)
+		return 1;
+	r.rise_ns = ad9959_sync_to_ns(rise);
+	r.fall_ns = ad9959_sync_to_ns(fall);
+	if(ramp != NULL)
+		*ramp = r;
+
+	ad9959_channel_sel_enable(ch);
+	AD9959_WriteData_Unified(FR1, 3, FR1_Data);
+	AD9959_WriteData_Unified(CFR, 3, CFR_Data);
+	ad9959_put_u32(e0, Data);
+	AD9959_WriteData_Unified(AD9959_CW(1), 4, Data);
+	ad9959_put_u32(r.rdw << shift, Data);
+	AD9959_WriteData_Unified(RDW, 4, Data);
+	ad9959_put_u32(r.fdw << shift, Data);
+	AD9959_WriteData_Unified(FDW, 4, Data);
+	SRR_Data[0] = r.fsrr;
+	SRR_Data[1] = r.rsrr;
+	AD9959_WriteData_Unified(SRR, 2, SRR_Data);
+	return 0;
+}
+
+/**
+ * @brief       相位角度换算为14位相位字
+ * @param       phase: 相位 (度)
+ * @retval      相位字，360度取最大值0x3FFF
+ */
+static uint32_t ad9959_phase_word(uint16_t phase)
+{
+	uint32_t v = AD9959_POW_FROM_DEG(phase);
+
+	return (v > 0x3FFF) ? 0x3FFF : v;
+}
+
+/**
+ * @brief       按时长设置线性扫频
+ * @param       ch: 输出通道
+ * @param       fre1_mhz: 起始频率
+ * @param       fre2_mhz: 终止频率
+ * @param       rise_us: 上升时间
+ * @param       fall_us: 下降时间
+ * @param       phase: 输出相位
+ * @param       amp: 输出幅度
+ * @param       ramp: 输出实际值
+ * @retval      0: 成功  1: 失败
+ */
+uint8_t ad9959_sweep_frequency_time(uint8_t ch, uint64_t fre1_mhz, uint64_t fre2_mhz, uint32_t rise_us, uint32_t fall_us,
+									uint16_t phase, uint16_t amp, ad9959_ramp_t *ramp)
+{
+	uint8_t CFR_Data[3] = {0x82,0x43,0x30};		// 与ad9959_sweep_frequency()相同
+	uint8_t ACR_Data[3] = {0x00,0x10,0x00};
+	uint8_t CFTW0_Data[4];
+	uint8_t CPOW0_Data[2];
+	uint32_t s0 = ad9959_ftw_from_millihz(fre1_mhz);
+	uint32_t e0 = ad9959_ftw_from_millihz(fre2_mhz);
+
+	if(e0 <= s0 || ad9959_sweep_ramp(ch, CFR_Data, e0 - s0, 0, e0, rise_us, fall_us, ramp))
+		return 1;
+
+	ad9959_put_u32(s0, CFTW0_Data);
+	AD9959_WriteData_Unified(CFTW0, 4, CFTW0_Data);
+	AD9959_Get_ACR_Data(amp, ACR_Data);
+	AD9959_WriteData_Unified(ACR, 3, ACR_Data);
+	AD9959_Get_CPOW0_Data(phase, CPOW0_Data);
+	AD9959_WriteData_Unified(CPOW0, 2, CPOW0_Data);
+	IO_update();
+	return 0;
+}
+
+/**
+ * @brief       按时长设置线性扫相
+ * @param       ch: 输出通道
+ * @param       fre_mhz: 输出频率
+ * @param       phase1: 起始相位
+ * @param       phase2: 终止相位
+ * @param       rise_us: 上升时间
+ * @param       fall_us: 下降时间
+ * @param       amp: 输出幅度
+ * @param       ramp: 输出实际值
+ * @retval      0: 成功  1: 失败
+ */
+uint8_t ad9959_sweep_phase_time(uint8_t ch, uint64_t fre_mhz, uint16_t phase1, uint16_t phase2, uint32_t rise_us, uint32_t fall_us,
+								uint16_t amp, ad9959_ramp_t *ramp)
+{
+	uint8_t CFR_Data[3] = {0xC0,0xC3,0x30};		// 与ad9959_sweep_phase()相同
+	uint8_t ACR_Data[3] = {0x00,0x10,0x00};
+	uint8_t CFTW0_Data[4];
+	uint8_t CPOW0_Data[2];
+	uint32_t s0 = ad9959_phase_word(phase1);
+	uint32_t e0 = ad9959_phase_word(phase2);
+
+	if(e0 <= s0 || ad9959_sweep_ramp(ch, CFR_Data, e0 - s0, 18, e0 << 18, rise_us, fall_us, ramp))
+		return 1;
+
+	CPOW0_Data[0] = (uint8_t)(s0 >> 8);
+	CPOW0_Data[1] = (uint8_t)s0;
+	AD9959_WriteData_Unified(CPOW0, 2, CPOW0_Data);
+	ad9959_put_u32(ad9959_ftw_from_millihz(fre_mhz), CFTW0_Data);
+	AD9959_WriteData_Unified(CFTW0, 4, CFTW0_Data);
+	AD9959_Get_ACR_Data(amp, ACR_Data);
+	AD9959_WriteData_Unified(ACR, 3, ACR_Data);
+	IO_update();
+	return 0;
+}
+
+/**
+ * @brief       按时长设置线性扫幅
+ * @param       ch: 输出通道
+ * @param       fre_mhz: 输出频率
+ * @param       phase: 输出相位
+ * @param       amp1: 起始幅度
+ * @param       amp2: 终止幅度
+ * @param       rise_us: 上升时间
+ * @param       fall_us: 下降时间
+ * @param       ramp: 输出实际值
+ * @retval      0: 成功  1: 失败
+ */
+uint8_t ad9959_sweep_amplitude_time(uint8_t ch, uint64_t fre_mhz, uint16_t phase, uint16_t amp1, uint16_t amp2,
+									uint32_t rise_us, uint32_t fall_us, ad9959_ramp_t *ramp)
+{
+	uint8_t CFR_Data[3] = {0x40,0x43,0x20};		// 与ad9959_sweep_amplitude()相同
+	uint8_t ACR_Data[3] = {0x00,0x00,0x00};
+	uint8_t CFTW0_Data[4];
+	uint8_t CPOW0_Data[2];
+	uint32_t s0 = amp1 & 0x3FF;
+	uint32_t e0 = amp2 & 0x3FF;
+
+	if(e0 <= s0 || ad9959_sweep_ramp(ch, CFR_Data, e0 - s0, 22, e0 << 22, rise_us, fall_us, ramp))
+		return 1;
+
+	AD9959_Get_ACR_Data((uint16_t)s0, ACR_Data);
+	AD9959_WriteData_Unified(ACR, 3, ACR_Data);
+	AD9959_Get_CPOW0_Data(phase, CPOW0_Data);
+	AD9959_WriteData_Unified(CPOW0, 2, CPOW0_Data);
+	ad9959_put_u32(ad9959_ftw_from_millihz(fre_mhz), CFTW0_Data);
+	AD9959_WriteData_Unified(CFTW0, 4, CFTW0_Data);
+	IO_update();
+	return 0;
+}
+
+/*********************************多器件*********************************************/
+
+/**
+ * @brief       按当前器件的系统时钟计算FR1的高字节
+ * @param       无
+ * @retval      FR1[23:16]：PLL倍频系数和VCO增益
+ * @note        系统时钟为参考时钟的4-20倍时使能PLL，否则旁路PLL(系统时钟即参考时钟)
+ */
+uint8_t ad9959_fr1_clock(void)
+{
+	uint32_t ratio = ad9959_dev_cur->sys_clk / AD9959_REF_CLK;
+	uint8_t fr1;
+
+	if(ratio < 4 || ratio > 20)
+		return 0x00;
+	fr1 = (uint8_t)(ratio << 2);			// FR1[22:18]：PLL倍频系数
+	if(ad9959_dev_cur->sys_clk > 255000000UL)
+		fr1 |= 0x80;						// FR1[23]：VCO高增益档
+	return fr1;
+}
+
+/**
+ * @brief       初始化一个器件
+ * @param       dev: 器件
+ * @param       cs_port: 片选端口
+ * @param       cs_pin: 片选引脚
+ * @param       hspi: SPI外设
+ * @param       sys_clk: 系统时钟(Hz)
+ * @retval      无
+ */
+void ad9959_dev_init(ad9959_dev_t *dev, GPIO_TypeDef *cs_port, uint16_t cs_pin, SPI_HandleTypeDef *hspi, uint32_t sys_clk)
+{
+	ad9959_dev_t *prev;
+
+	dev->cs_port = cs_port;
+	dev->cs_pin = cs_pin;
+	dev->hspi = hspi;
+	dev->sys_clk = sys_clk;
+	dev->sync_offset = 0;
+	dev->serial_mode = AD9959_CSR_MODE_2WIRE;
+	AD9959_PIN_WRITE(cs_port, cs_pin, 1);
+
+	/* 芯片已由ad9959_init()的共用复位信号复位 */
+	prev = ad9959_dev_select(dev);
+	ad9959_shadow_reset();
+#ifdef AD9959_USE_4BIT_SERIAL
+	ad9959_set_serial_mode(AD9959_CSR_MODE_4BIT);
+#endif
+	ad9959_dev_select(prev);
+}
+
+/**
+ * @brief       选择当前器件
+ * @param       dev: 器件
+ * @retval      之前的当前器件
+ * @note        DMA队列中的帧按当前器件的片选发送，切换前等待队列发送完
+ */
+ad9959_dev_t *ad9959_dev_select(ad9959_dev_t *dev)
+{
+	ad9959_dev_t *prev = ad9959_dev_cur;
+
+	if(dev == prev)
+		return prev;
+#ifdef AD9959_USE_SPI_DMA
+	ad9959_queue_wait();
+#endif
+	ad9959_dev_cur = dev;
+	return prev;
+}
+
+/**
+ * @brief       依次发送各器件的待写寄存器
+ * @param       devs: 器件列表
+ * @param       count: 器件数
+ * @retval      无
+ * @note        返回时最后一个器件为当前器件
+ */
+static void ad9959_dev_flush_all(ad9959_dev_t *const *devs, uint8_t count)
+{
+	uint8_t i;
+
+	for(i = 0; i < count; i++)
+	{
+		ad9959_dev_select(devs[i]);
+		ad9959_flush();
+	}
+}
+
+/**
+ * @brief       多个器件同时更新
+ * @param       devs: 器件列表
+ * @param       count: 器件数
+ * @retval      无
+ */
+void ad9959_dev_update(ad9959_dev_t *const *devs, uint8_t count)
+{
+	ad9959_dev_t *prev = ad9959_dev_cur;
+
+	if(count == 0)
+		return;
+	ad9959_dev_flush_all(devs, count);
+	ad9959_update_async(NULL, NULL);		// 共用的IO_update，排在最后一个器件的帧之后
+	ad9959_dev_select(prev);
+}
+
+/**
+ * @brief       多个器件在指定时刻同时更新
+ * @param       devs: 器件列表
+ * @param       count: 器件数
+ * @param       when: 时间戳
+ * @retval      0: 按时  1: 已迟到
+ */
+uint8_t ad9959_dev_update_at(ad9959_dev_t *const *devs, uint8_t count, uint32_t when)
+{
+	ad9959_dev_t *prev = ad9959_dev_cur;
+	uint8_t late;
+
+	if(count == 0)
+		return 0;
+	ad9959_dev_flush_all(devs, count);
+	late = ad9959_update_at(when);
+	ad9959_dev_select(prev);
+	return late;
+}
+
+/**
+ * @brief       使能多器件同步
+ * @param       devs: 器件列表，devs[0]为主器件
+ * @param       count: 器件数
+ * @retval      无
+ */
+void ad9959_dev_sync(ad9959_dev_t *const *devs, uint8_t count)
+{
+	ad9959_dev_t *prev = ad9959_dev_cur;
+	uint8_t FR2_Data[2];
+	uint8_t i;
+
+	for(i = 0; i < count; i++)
+	{
+		ad9959_dev_select(devs[i]);
+		memcpy(FR2_Data, &ad9959_dev_cur->shadow.want[0][ad9959_reg_ofs[FR2]], 2);
+		FR2_Data[1] &= (uint8_t)~(AD9959_FR2_AUTO_SYNC | AD9959_FR2_SYNC_MASTER | AD9959_FR2_SYNC_MASK | AD9959_FR2_CLK_OFFSET_MASK);
+		FR2_Data[1] |= (uint8_t)(AD9959_FR2_AUTO_SYNC | (ad9959_dev_cur->sync_offset & AD9959_FR2_CLK_OFFSET_MASK));
+		if(i == 0)
+			FR2_Data[1] |= AD9959_FR2_SYNC_MASTER;
+		AD9959_WriteData_Unified(FR2, 2, FR2_Data);
+	}
+	ad9959_dev_select(prev);
+	ad9959_dev_update(devs, count);
+}
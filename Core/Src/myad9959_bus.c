@@ -0,0 +1,307 @@
+#include "myad9959.h"
+#include "myad9959_bus.h"
+
+#include <string.h>
+
+/**
+ ****************************************************************************************************
+ * @file        myad9959_bus.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       AD9959多总线并行发送
+ *              各器件的待写寄存器先收集成帧，按SPI外设分组后各总线的DMA同时发送，
+ *              完成中断启动同一总线上的下一个器件，全部发送完后产生一次共用的IO_update
+ ****************************************************************************************************
+ */
+
+/* 一个SPI外设及其上的器件 */
+typedef struct
+{
+	SPI_HandleTypeDef *hspi;
+	ad9959_dev_t *dev[AD9959_BUS_DEVS];
+	uint16_t len[AD9959_BUS_DEVS];		/* 各器件的帧长度 */
+	uint32_t dirty[AD9959_BUS_DEVS][AD9959_CH_COUNT];	/* 各器件收集帧之前的待发送位图，发送失败时恢复 */
+	uint8_t  count;						/* 器件数 */
+	volatile uint8_t idx;				/* 正在发送的器件 */
+	volatile uint8_t busy;				/* 正在发送 */
+	volatile uint8_t failed;			/* 有器件的帧启动发送失败 */
+} ad9959_bus_t;
+
+static ad9959_bus_t ad9959_bus[AD9959_BUS_MAX];
+static uint8_t ad9959_bus_n;
+
+#ifdef AD9959_USE_SPI_DMA
+/* 各器件的帧，DMA直接从这里发送 */
+static uint8_t ad9959_bus_frame[AD9959_BUS_MAX][AD9959_BUS_DEVS][AD9959_FLUSH_MAX_BYTES];
+
+/**
+ * @brief       按SPI外设把器件分组
+ * @param       devs: 器件列表
+ * @param       count: 器件数
+ * @retval      0: 成功  1: 总线数或器件数超出配置
+ */
+static uint8_t ad9959_bus_plan(ad9959_dev_t *const *devs, uint8_t count)
+{
+	ad9959_bus_t *b;
+	uint8_t i, k;
+
+	ad9959_bus_n = 0;
+	for(i = 0; i < count; i++)
+	{
+		b = NULL;
+		for(k = 0; k < ad9959_bus_n; k++)
+		{
+			if(ad9959_bus[k].hspi == devs[i]->hspi)
+				b = &ad9959_bus[k];
+		}
+		if(b == NULL)
+		{
+			if(ad9959_bus_n >= AD9959_BUS_MAX)
+				return 1;
+			b = &ad9959_bus[ad9959_bus_n++];
+			b->hspi = devs[i]->hspi;
+			b->count = 0;
+			b->busy = 0;
+		}
+		if(b->count >= AD9959_BUS_DEVS)
+			return 1;
+		b->dev[b->count++] = devs[i];
+	}
+	return 0;
+}
+
+/**
+ * @brief       帧没有发出时恢复器件的影子寄存器
+ * @param       dev: 器件
+ * @param       dirty: 收集帧之前的待发送位图
+ * @retval      无
+ * @note        收集帧时已把芯片内容记为发送后的值，这里使其失效并恢复待发送位，下次更新时重发
+ */
+static void ad9959_bus_fail(ad9959_dev_t *dev, const uint32_t *dirty)
+{
+	uint8_t ch;
+
+	for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+	{
+		dev->shadow.valid[ch] = 0;
+		dev->shadow.dirty[ch] |= dirty[ch];
+	}
+}
+
+/**
+ * @brief       启动总线上从idx开始的下一个非空帧
+ * @param       b: 总线
+ * @retval      无
+ * @note        没有剩余的帧时清除busy；启动失败的帧恢复影子寄存器并记入failed，继续发送下一个器件
+ */
+static void ad9959_bus_start(ad9959_bus_t *b)
+{
+	ad9959_dev_t *dev;
+	uint8_t n = (uint8_t)(b - ad9959_bus);
+
+	for(; b->idx < b->count; b->idx++)
+	{
+		if(b->len[b->idx] == 0)
+			continue;
+
+		dev = b->dev[b->idx];
+		AD9959_TRACE_FRAME(b->len[b->idx]);
+		AD9959_PIN_WRITE(dev->cs_port, dev->cs_pin, 0);
+		if(HAL_SPI_Transmit_DMA(b->hspi, ad9959_bus_frame[n][b->idx], b->len[b->idx]) == HAL_OK)
+			return;		// 等待ad9959_bus_tx_done()
+		AD9959_PIN_WRITE(dev->cs_port, dev->cs_pin, 1);
+		ad9959_bus_fail(dev, b->dirty[b->idx]);
+		b->failed = 1;
+	}
+	b->busy = 0;
+}
+
+/**
+ * @brief       收集各器件的帧并在所有总线上并行发送
+ * @param       devs: 器件列表
+ * @param       count: 器件数
+ * @retval      0: 已发送  1: 超出配置，没有发送任何数据  2: 有器件的帧启动发送失败，其余已发送
+ * @note        阻塞到所有总线发送完成(屏障)
+ */
+static uint8_t ad9959_bus_send(ad9959_dev_t *const *devs, uint8_t count)
+{
+	ad9959_dev_t *prev = ad9959_dev_cur;
+	ad9959_bus_t *b;
+	uint8_t i, k, failed = 0;
+
+	if(ad9959_bus_plan(devs, count))
+		return 1;
+
+	for(i = 0; i < ad9959_bus_n; i++)
+	{
+		b = &ad9959_bus[i];
+		for(k = 0; k < b->count; k++)
+		{
+			ad9959_dev_select(b->dev[k]);
+			memcpy(b->dirty[k], ad9959_dev_cur->shadow.dirty, sizeof(b->dirty[k]));
+			b->len[k] = ad9959_flush_to(ad9959_bus_frame[i][k]);
+		}
+	}
+	ad9959_dev_select(prev);
+	ad9959_queue_wait();		// DMA队列可能正在使用同一个SPI外设
+
+	for(i = 0; i < ad9959_bus_n; i++)
+	{
+		b = &ad9959_bus[i];
+		b->idx = 0;
+		b->failed = 0;
+		b->busy = 1;
+		ad9959_bus_start(b);
+	}
+	for(i = 0; i < ad9959_bus_n; i++)
+	{
+		while(ad9959_bus[i].busy)
+		{
+		}
+		failed |= ad9959_bus[i].failed;
+	}
+	return failed ? 2 : 0;
+}
+#else
+static uint8_t ad9959_bus_send(ad9959_dev_t *const *devs, uint8_t count)
+{
+	(void)devs;
+	(void)count;
+	return 1;		// 阻塞SPI无法并行
+}
+#endif
+
+/**
+ * @brief       多个器件并行发送后同时更新
+ * @param       devs: 器件列表
+ * @param       count: 器件数
+ * @retval      0: 并行  1: 按顺序  2: 有器件发送失败
+ */
+uint8_t ad9959_bus_update(ad9959_dev_t *const *devs, uint8_t count)
+{
+	uint8_t ret;
+
+	if(count == 0)
+		return 0;
+	ret = ad9959_bus_send(devs, count);
+	if(ret == 1)
+	{
+		ad9959_dev_update(devs, count);
+		return 1;
+	}
+
+	AD9959_TRACE_BEGIN(AD9959_TRACE_API_UPDATE, 0);
+	AD9959_TRACE_UPDATE();
+	ad9959_io_update_pulse();
+	AD9959_TRACE_END();
+	return ret;
+}
+
+/**
+ * @brief       多个器件并行发送后在指定时刻同时更新
+ * @param       devs: 器件列表
+ * @param       count: 器件数
+ * @param       when: 时间戳
+ * @retval      0: 按时  1: 已迟到  2: 有器件发送失败
+ */
+uint8_t ad9959_bus_update_at(ad9959_dev_t *const *devs, uint8_t count, uint32_t when)
+{
+	uint8_t ret, late;
+
+	if(count == 0)
+		return 0;
+	ret = ad9959_bus_send(devs, count);
+	if(ret == 1)
+		return ad9959_dev_update_at(devs, count, when);
+
+	AD9959_TRACE_BEGIN(AD9959_TRACE_API_UPDATE, 0);
+	ad9959_wait_idle();
+	AD9959_TRACE_UPDATE();
+	late = ad9959_tim_update_at(when);
+	AD9959_TRACE_END();
+	return (ret == 2) ? 2 : late;
+}
+
+/**
+ * @brief       SPI发送完成通知
+ * @param       hspi: SPI句柄
+ * @retval      1: 已处理  0: 不属于并行发送
+ */
+uint8_t ad9959_bus_tx_done(SPI_HandleTypeDef *hspi)
+{
+	ad9959_bus_t *b;
+	ad9959_dev_t *dev;
+	uint8_t i;
+
+	for(i = 0; i < ad9959_bus_n; i++)
+	{
+		b = &ad9959_bus[i];
+		if(b->busy && b->hspi == hspi)
+		{
+			dev = b->dev[b->idx];
+			AD9959_PIN_WRITE(dev->cs_port, dev->cs_pin, 1);
+			b->idx++;
+#ifdef AD9959_USE_SPI_DMA
+			ad9959_bus_start(b);
+#endif
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief       把器件分配到各总线
+ * @param       bytes: 各器件的字节数
+ * @param       count: 器件数
+ * @param       nbus: 总线数
+ * @param       bus: 输出，各器件的总线号
+ * @retval      最忙的总线的字节数，0表示器件数超过nbus * AD9959_BUS_DEVS
+ * @note        穷举nbus^count种分配(2条总线、8个器件时256种)，每条总线最多AD9959_BUS_DEVS个器件
+ */
+uint32_t ad9959_bus_balance(const uint16_t *bytes, uint8_t count, uint8_t nbus, uint8_t *bus)
+{
+	uint32_t load[AD9959_BUS_MAX];
+	uint8_t num[AD9959_BUS_MAX];
+	uint32_t best = UINT32_MAX, best_code = 0, total = 1, code, c, span;
+	uint8_t i, k;
+
+	if(nbus == 0)
+		nbus = 1;
+	if(nbus > AD9959_BUS_MAX)
+		nbus = AD9959_BUS_MAX;
+	if(count > nbus * AD9959_BUS_DEVS)
+		return 0;
+
+	for(i = 0; i < count; i++)
+		total *= nbus;
+
+	/* code的第i位(nbus进制)为器件i的总线号 */
+	for(code = 0; code < total; code++)
+	{
+		for(k = 0; k < nbus; k++)
+		{
+			load[k] = 0;
+			num[k] = 0;
+		}
+		span = 0;
+		for(i = 0, c = code; i < count; i++, c /= nbus)
+		{
+			k = (uint8_t)(c % nbus);
+			load[k] += bytes[i];
+			if(load[k] > span)
+				span = load[k];
+			if(++num[k] > AD9959_BUS_DEVS || span >= best)
+				break;
+		}
+		if(i == count)
+		{
+			best = span;
+			best_code = code;
+		}
+	}
+
+	for(i = 0, c = best_code; i < count; i++, c /= nbus)
+		bus[i] = (uint8_t)(c % nbus);
+	return best;
+}
@@ -0,0 +1,316 @@
+#include "myad9959.h"
+#include "myad9959_chain.h"
+
+/**
+ ****************************************************************************************************
+ * @file        myad9959_chain.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       AD9959分段硬件扫频
+ *              第k段开始后立即预装第k+1段，切换时刻按各段实际时长累加，不随调用时刻漂移
+ ****************************************************************************************************
+ */
+
+static struct
+{
+	const ad9959_chain_t *chain;
+	uint16_t k;					/* 下一个切换点：第k段开始，k == count时结束 */
+	uint16_t late;
+	uint32_t t0;				/* 第0段开始时刻 */
+	uint64_t sync;				/* 第0段开始到切换点k的SYNC_CLK周期数 */
+	uint32_t when;				/* 切换点k的时刻 */
+	uint32_t prev;				/* 已预装的最后一段的终点 */
+	uint8_t  srr[2];			/* SRR：FSRR、RSRR */
+	uint8_t  up;				/* 已预装的最后一段的方向 */
+	uint8_t  edge;				/* 切换点k需要翻转Profile引脚 */
+	uint8_t  running;
+} ad9959_chain_st;
+
+/**
+ * @brief       初始化扫频链
+ * @param       c: 扫频链
+ * @param       buf: 段缓冲区
+ * @param       size: 容量
+ * @param       ch: 通道
+ * @param       start_mhz: 起点频率
+ * @retval      无
+ */
+void ad9959_chain_init(ad9959_chain_t *c, ad9959_chain_seg_t *buf, uint16_t size, uint8_t ch, uint64_t start_mhz)
+{
+	c->seg = buf;
+	c->size = size;
+	c->count = 0;
+	c->start = ad9959_ftw_from_millihz(start_mhz);
+	c->end_mhz = start_mhz;
+	c->ch = ch;
+}
+
+/**
+ * @brief       按频率控制字添加一段
+ * @param       c: 扫频链
+ * @param       ftw: 终点频率控制字
+ * @param       sync: 期望时长(SYNC_CLK周期)
+ * @retval      0: 成功  1: 缓冲区已满、时长为0或斜率太小
+ */
+static uint8_t ad9959_chain_add_ftw(ad9959_chain_t *c, uint32_t ftw, uint64_t sync)
+{
+	ad9959_chain_seg_t *s;
+	uint32_t prev, d;
+	uint64_t actual;
+
+	if(c->count >= c->size || sync == 0 || sync > 0xFFFFFFFFULL)
+		return 1;
+
+	s = &c->seg[c->count];
+	prev = (c->count > 0) ? c->seg[c->count - 1].ftw : c->start;
+	d = (ftw > prev) ? ftw - prev : prev - ftw;
+
+	s->ftw = ftw;
+	s->delta = 0;
+	s->rate = 1;
+	s->sync = (uint32_t)sync;		// 保持段按期望时长
+
+	if(d != 0)
+	{
+		actual = ad9959_ramp_solve(d, sync, &s->delta, &s->rate);
+		if(actual == 0 || actual > 0xFFFFFFFFULL)
+			return 1;
+		s->sync = (uint32_t)actual;
+	}
+
+	c->count++;
+	return 0;
+}
+
+/**
+ * @brief       添加一段线性扫频
+ * @param       c: 扫频链
+ * @param       fre_mhz: 终点频率
+ * @param       time_ns: 时长(ns)
+ * @retval      0: 成功  1: 失败
+ */
+uint8_t ad9959_chain_add(ad9959_chain_t *c, uint64_t fre_mhz, uint32_t time_ns)
+{
+	if(ad9959_chain_add_ftw(c, ad9959_ftw_from_millihz(fre_mhz),
+							(uint64_t)time_ns * AD9959_SYNC_CLK / 1000000000ULL))
+		return 1;
+	c->end_mhz = fre_mhz;
+	return 0;
+}
+
+/**
+ * @brief       用若干线性段逼近对数扫频
+ * @param       c: 扫频链
+ * @param       fre_mhz: 终点频率
+ * @param       time_us: 总时长(us)
+ * @param       nseg: 段数
+ * @retval      0: 成功  1: 失败
+ */
+uint8_t ad9959_chain_add_log(ad9959_chain_t *c, uint64_t fre_mhz, uint32_t time_us, uint16_t nseg)
+{
+	ad9959_sweep_seg_t seg = {fre_mhz, nseg, AD9959_SWEEP_LOG};
+	ad9959_sweep_gen_t gen;
+	uint64_t total = (uint64_t)time_us * AD9959_SYNC_CLK / 1000000ULL;
+	uint32_t ftw[2];
+	uint16_t i, count = c->count;
+
+	if(nseg == 0 || (uint32_t)c->count + nseg > c->size ||
+	   ad9959_sweep_gen_init(&gen, c->end_mhz, &seg, 1))
+		return 1;
+
+	ad9959_sweep_gen_next(&gen, ftw, 1);		// 起点
+	for(i = 0; i < nseg; i++)
+	{
+		ad9959_sweep_gen_next(&gen, ftw, 1);
+		/* 按累计时长取整，各段时长之和等于总时长 */
+		if(ad9959_chain_add_ftw(c, ftw[0], total * (i + 1) / nseg - total * i / nseg))
+		{
+			c->count = count;
+			return 1;
+		}
+	}
+	c->end_mhz = fre_mhz;
+	return 0;
+}
+
+/**
+ * @brief       设置通道的Profile引脚(扫频方向)
+ * @param       up: 1向上  0向下
+ * @retval      无
+ */
+static void ad9959_chain_pin(uint8_t up)
+{
+	uint32_t pin = 1UL << (AD9959_PROFILE_PIN_SHIFT + ad9959_chain_st.chain->ch);
+
+	AD9959_BSRR_WRITE(AD9959_PROFILE_GPIO_Port, up ? pin : (pin << 16));
+}
+
+/**
+ * @brief       预装第k段
+ * @param       无
+ * @retval      无
+ * @note        同方向时写入I/O缓冲并预约切换点k的IO_update；
+ *              换向时立即生效(只改变另一方向的终点、步长和斜率)，由切换点k翻转Profile引脚
+ */
+static void ad9959_chain_prepare(void)
+{
+	const ad9959_chain_t *c = ad9959_chain_st.chain;
+	const ad9959_chain_seg_t *s;
+	uint8_t frame[13], up;
+
+	ad9959_chain_st.edge = 0;
+	if(ad9959_chain_st.k >= c->count)
+		return;
+	s = &c->seg[ad9959_chain_st.k];
+	if(s->delta == 0 || s->ftw == ad9959_chain_st.prev)
+		return;					// 保持：芯片停在上一段终点
+
+	up = s->ftw > ad9959_chain_st.prev;
+	ad9959_chain_st.srr[up] = s->rate;
+
+	/* 向上：E0(CW1)、RDW、RSRR；向下：S0(CFTW0)、FDW、FSRR */
+	frame[0] = up ? AD9959_CW(1) : CFTW0;
+	frame[1] = (uint8_t)(s->ftw >> 24);
+	frame[2] = (uint8_t)(s->ftw >> 16);
+	frame[3] = (uint8_t)(s->ftw >> 8);
+	frame[4] = (uint8_t)s->ftw;
+	frame[5] = up ? RDW : FDW;
+	frame[6] = (uint8_t)(s->delta >> 24);
+	frame[7] = (uint8_t)(s->delta >> 16);
+	frame[8] = (uint8_t)(s->delta >> 8);
+	frame[9] = (uint8_t)s->delta;
+	frame[10] = SRR;
+	frame[11] = ad9959_chain_st.srr[0];
+	frame[12] = ad9959_chain_st.srr[1];
+	AD9959_WriteFrame(frame, sizeof(frame));
+
+	if(up == ad9959_chain_st.up)
+	{
+		if(ad9959_update_at(ad9959_chain_st.when) && ad9959_chain_st.k > 0)
+			ad9959_chain_st.late++;
+	}
+	else
+	{
+		IO_update();
+		ad9959_chain_st.up = up;
+		ad9959_chain_st.edge = 1;
+	}
+	ad9959_chain_st.prev = s->ftw;
+}
+
+/**
+ * @brief       开始播放扫频链
+ * @param       c: 扫频链
+ * @retval      0: 成功  1: 正在播放或扫频链为空
+ */
+uint8_t ad9959_chain_play(const ad9959_chain_t *c)
+{
+	uint8_t FR1_Data[3] = {ad9959_fr1_clock(),0x00,0x00};		// 与ad9959_sweep_frequency()相同，2级模式
+	uint8_t CFR_Data[3] = {0x82,0x43,0x30};		// 频率线性扫描
+	uint8_t FTW_Data[4];
+	uint8_t Zero_Data[4] = {0x00,0x00,0x00,0x00};
+
+	if(ad9959_chain_st.running || c == NULL || c->count == 0)
+		return 1;
+
+	ad9959_chain_st.chain = c;
+	ad9959_mod_init();
+	ad9959_chain_pin(0);
+
+	/* 从起点开始：S0 = E0 = 起点 */
+	FTW_Data[0] = (uint8_t)(c->start >> 24);
+	FTW_Data[1] = (uint8_t)(c->start >> 16);
+	FTW_Data[2] = (uint8_t)(c->start >> 8);
+	FTW_Data[3] = (uint8_t)c->start;
+	ad9959_channel_sel_enable(c->ch);
+	AD9959_WriteData_Unified(FR1, 3, FR1_Data);
+	AD9959_WriteData_Unified(CFR, 3, CFR_Data);
+	AD9959_WriteData_Unified(CFTW0, 4, FTW_Data);
+	AD9959_WriteData_Unified(AD9959_CW(1), 4, FTW_Data);
+	AD9959_WriteData_Unified(RDW, 4, Zero_Data);
+	AD9959_WriteData_Unified(FDW, 4, Zero_Data);
+	IO_update();
+	ad9959_select_channel(c->ch);		// 分组可能同时选中数值相同的其他通道
+	ad9959_wait_idle();
+	ad9959_shadow_invalidate();		// 之后直接发送帧，影子寄存器不再跟踪芯片内容
+
+	ad9959_chain_st.k = 0;
+	ad9959_chain_st.late = 0;
+	ad9959_chain_st.sync = 0;
+	ad9959_chain_st.prev = c->start;
+	ad9959_chain_st.srr[0] = 1;
+	ad9959_chain_st.srr[1] = 1;
+	ad9959_chain_st.up = 0;
+	ad9959_chain_st.when = AD9959_TIMER_NOW();
+	ad9959_chain_st.running = 1;
+
+	/* 第0段立即开始，之后的切换时刻都以它的开始时刻为基准 */
+	ad9959_chain_prepare();
+	ad9959_chain_st.t0 = AD9959_TIMER_NOW();
+	ad9959_chain_st.when = ad9959_chain_st.t0;
+	ad9959_chain_poll();
+	return 0;
+}
+
+/**
+ * @brief       处理到期的段切换
+ * @param       无
+ * @retval      1: 仍在播放  0: 已结束
+ */
+uint8_t ad9959_chain_poll(void)
+{
+	const ad9959_chain_t *c = ad9959_chain_st.chain;
+
+	while(ad9959_chain_st.running && (int32_t)(AD9959_TIMER_NOW() - ad9959_chain_st.when) >= 0)
+	{
+		/* 切换点k：同方向的IO_update由定时器产生，可能比时间基准稍晚，等它结束再写下一段；换向在这里翻转引脚 */
+		while(ad9959_tim_busy())
+		{
+		}
+		if(ad9959_chain_st.edge)
+			ad9959_chain_pin(ad9959_chain_st.up);
+		if(ad9959_chain_st.k >= c->count)
+		{
+			ad9959_chain_st.running = 0;
+			break;
+		}
+
+		/* 第k段已开始，计算它的结束时刻并预装下一段 */
+		ad9959_chain_st.sync += c->seg[ad9959_chain_st.k].sync;
+		ad9959_chain_st.when = ad9959_chain_st.t0 +
+			(uint32_t)((ad9959_chain_st.sync * AD9959_TIMER_HZ + AD9959_SYNC_CLK - 1) / AD9959_SYNC_CLK);
+		ad9959_chain_st.k++;
+		ad9959_chain_prepare();
+	}
+	return ad9959_chain_st.running;
+}
+
+/**
+ * @brief       停止播放
+ * @param       无
+ * @retval      无
+ */
+void ad9959_chain_stop(void)
+{
+	ad9959_chain_st.running = 0;
+}
+
+/**
+ * @brief       查询是否正在播放
+ * @param       无
+ * @retval      1: 正在播放  0: 空闲
+ */
+uint8_t ad9959_chain_busy(void)
+{
+	return ad9959_chain_st.running;
+}
+
+/**
+ * @brief       查询迟到的段切换次数
+ * @param       无
+ * @retval      次数
+ */
+uint16_t ad9959_chain_late(void)
+{
+	return ad9959_chain_st.late;
+}
@@ -0,0 +1,292 @@
+#include "myad9959.h"
+#include "myad9959_hop.h"
+
+/**
+ ****************************************************************************************************
+ * @file        myad9959_hop.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       AD9959跳频表
+ *              生成时完成全部频率/相位/幅度换算，播放时只有IO_update和一次片选的SPI发送
+ ****************************************************************************************************
+ */
+
+static struct
+{
+	const ad9959_hop_table_t *table;
+	uint32_t next;				/* 下一跳(已预装)在表中的序号 */
+	uint32_t end;				/* 播放到该序号时停止 */
+	uint32_t done;				/* 已生效的跳数 */
+	uint8_t  loop;
+	uint8_t  ending;			/* 流式播放的数据已结束 */
+	uint8_t  running;
+} ad9959_hop;
+
+#define AD9959_HOP_NO_END	0xFFFFFFFFUL
+
+/**
+ * @brief       生成跳频表
+ * @param       table: 跳频表
+ * @param       ch: 通道
+ * @param       fre_mhz: 各跳频率
+ * @param       phase: 各跳相位，可为NULL
+ * @param       amp: 各跳幅度，可为NULL
+ * @param       count: 跳数
+ * @retval      0: 成功  1: 缓冲区不足
+ */
+uint8_t ad9959_hop_build(ad9959_hop_table_t *table, uint8_t ch, const uint64_t *fre_mhz,
+						 const uint16_t *phase, const uint16_t *amp, uint32_t count)
+{
+	uint8_t frame = AD9959_HOP_FRAME_BYTES(phase != NULL, amp != NULL);
+	uint8_t *p = table->buf;
+	uint32_t i, v;
+
+	if(table->buf == NULL || (uint64_t)count * frame > table->size)
+		return 1;
+
+	table->count = count;
+	table->frame = frame;
+	table->ch = ch;
+
+	/* 每跳的寄存器顺序固定：ACR、CPOW0、CFTW0，与ad9959_set_signal_out()一致 */
+	for(i = 0; i < count; i++)
+	{
+		if(amp != NULL)
+		{
+			p[0] = ACR;
+			p[1] = 0x00;
+			p[2] = (uint8_t)(0x10 | ((amp[i] >> 8) & 0x03));	// 使能幅度乘法器
+			p[3] = (uint8_t)amp[i];
+			p += 4;
+		}
+		if(phase != NULL)
+		{
+			v = AD9959_POW_FROM_DEG(phase[i]) & 0x3FFF;
+			p[0] = CPOW0;
+			p[1] = (uint8_t)(v >> 8);
+			p[2] = (uint8_t)v;
+			p += 3;
+		}
+		v = ad9959_ftw_from_millihz(fre_mhz[i]);
+		p[0] = CFTW0;
+		p[1] = (uint8_t)(v >> 24);
+		p[2] = (uint8_t)(v >> 16);
+		p[3] = (uint8_t)(v >> 8);
+		p[4] = (uint8_t)v;
+		p += 5;
+	}
+	return 0;
+}
+
+/**
+ * @brief       产生IO_update
+ * @param       无
+ * @retval      无
+ * @note        DMA队列模式下排在之前的传输之后
+ */
+static void ad9959_hop_pulse(void)
+{
+#ifdef AD9959_USE_SPI_DMA
+	ad9959_queue_io_update(NULL, NULL);
+#else
+	ad9959_io_update_pulse();
+#endif
+}
+
+#ifdef AD9959_USE_HOP_TIM
+
+/**
+ * @brief       启动跳频定时器
+ * @param       rate: 跳速(Hz)
+ * @retval      无
+ */
+static void ad9959_hop_tim_start(uint32_t rate)
+{
+	TIM_TypeDef *tim = AD9959_HOP_TIM;
+	uint32_t arr = ad9959_tim_get_clk() / rate;
+
+	AD9959_HOP_TIM_CLK_ENABLE();
+
+	tim->CR1 = 0;
+	tim->PSC = 0;
+	tim->ARR = (arr > 0) ? arr - 1 : 0;		// TIM5为32位定时器，不需要预分频
+	tim->CNT = 0;
+	tim->EGR = TIM_EGR_UG;
+	tim->SR = 0;
+	tim->DIER = TIM_DIER_UIE;
+
+	HAL_NVIC_SetPriority(AD9959_HOP_IRQn, AD9959_HOP_IRQ_PRIO, 0);
+	HAL_NVIC_EnableIRQ(AD9959_HOP_IRQn);
+	tim->CR1 = TIM_CR1_CEN;
+}
+
+/**
+ * @brief       停止跳频定时器
+ * @param       无
+ * @retval      无
+ */
+static void ad9959_hop_tim_stop(void)
+{
+	AD9959_HOP_TIM->CR1 = 0;
+	AD9959_HOP_TIM->DIER = 0;
+	AD9959_HOP_TIM->SR = 0;
+}
+
+/**
+ * @brief       跳频定时器中断
+ * @param       无
+ * @retval      无
+ */
+void AD9959_HOP_IRQHandler(void)
+{
+	AD9959_HOP_TIM->SR = 0;
+	ad9959_hop_tick();
+}
+
+#else
+
+/**
+ * @brief       软件模式：由调用者周期调用ad9959_hop_tick()
+ */
+static void ad9959_hop_tim_start(uint32_t rate)
+{
+	(void)rate;
+}
+
+static void ad9959_hop_tim_stop(void)
+{
+}
+
+#endif
+
+/**
+ * @brief       流式播放：重新填充半个表
+ * @param       half: 0前半，1后半
+ * @retval      无
+ * @note        数据不足半个表时记下结束位置，之后不再填充
+ */
+static void ad9959_hop_refill(uint8_t half)
+{
+	const ad9959_hop_table_t *t = ad9959_hop.table;
+	uint32_t len = t->count / 2, first = half * len, n;
+
+	if(ad9959_hop.ending)
+		return;
+
+	n = t->refill(&t->buf[first * t->frame], len, t->ctx);
+	if(n < len)
+	{
+		ad9959_hop.ending = 1;
+		ad9959_hop.end = first + n;
+	}
+}
+
+/**
+ * @brief       开始播放跳频表
+ * @param       table: 跳频表
+ * @param       rate: 跳速
+ * @param       loop: 是否循环
+ * @retval      0: 成功  1: 正在播放或表为空
+ */
+uint8_t ad9959_hop_play(const ad9959_hop_table_t *table, uint32_t rate, uint8_t loop)
+{
+	if(ad9959_hop.running || table == NULL || table->count == 0 || rate == 0)
+		return 1;
+	if(table->refill != NULL && (table->count & 1))
+		return 1;
+
+	/* 选中通道后影子寄存器不再跟踪芯片内容 */
+	ad9959_flush();
+	ad9959_select_channel(table->ch);
+	ad9959_wait_idle();
+	ad9959_shadow_invalidate();
+
+	ad9959_hop.table = table;
+	ad9959_hop.loop = loop;
+	ad9959_hop.done = 0;
+	ad9959_hop.next = 1;
+	ad9959_hop.end = loop ? AD9959_HOP_NO_END : table->count;
+	ad9959_hop.ending = 0;
+
+	if(table->refill != NULL)
+	{
+		ad9959_hop.loop = 1;
+		ad9959_hop.end = AD9959_HOP_NO_END;
+		ad9959_hop_refill(0);
+		ad9959_hop_refill(1);
+		if(ad9959_hop.end == 0)
+			return 1;		// 没有数据
+	}
+	ad9959_hop.running = 1;
+
+	AD9959_WriteFrame(table->buf, table->frame);	// 预装第一跳
+	ad9959_hop_tim_start(rate);
+	return 0;
+}
+
+/**
+ * @brief       播放一跳
+ * @param       无
+ * @retval      1: 仍在播放  0: 已停止
+ */
+uint8_t ad9959_hop_tick(void)
+{
+	const ad9959_hop_table_t *t = ad9959_hop.table;
+
+	if(!ad9959_hop.running)
+		return 0;
+
+	ad9959_hop_pulse();
+	ad9959_hop.done++;
+
+	if(ad9959_hop.next >= t->count && ad9959_hop.loop)
+		ad9959_hop.next = 0;
+	if(ad9959_hop.next == ad9959_hop.end)
+	{
+		ad9959_hop_stop();
+		return 0;
+	}
+	AD9959_WriteFrame(&t->buf[ad9959_hop.next * t->frame], t->frame);
+	ad9959_hop.next++;
+
+	/* 流式播放：半个表的帧都已发出，可以重新填充 */
+	if(t->refill != NULL)
+	{
+		if(ad9959_hop.next == t->count / 2)
+			ad9959_hop_refill(0);
+		else if(ad9959_hop.next == t->count)
+			ad9959_hop_refill(1);
+	}
+	return 1;
+}
+
+/**
+ * @brief       停止播放
+ * @param       无
+ * @retval      无
+ */
+void ad9959_hop_stop(void)
+{
+	ad9959_hop_tim_stop();
+	ad9959_hop.running = 0;
+}
+
+/**
+ * @brief       查询是否正在播放
+ * @param       无
+ * @retval      1: 正在播放  0: 空闲
+ */
+uint8_t ad9959_hop_busy(void)
+{
+	return ad9959_hop.running;
+}
+
+/**
+ * @brief       查询已生效的跳数
+ * @param       无
+ * @retval      跳数
+ */
+uint32_t ad9959_hop_count(void)
+{
+	return ad9959_hop.done;
+}
@@ -0,0 +1,212 @@
+#include "myad9959.h"
+#include "myad9959_mod.h"
+
+/**
+ ****************************************************************************************************
+ * @file        myad9959_mod.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       AD9959 Profile引脚多级调制(2/4/8/16级ASK/FSK/PSK)
+ *              FR1[9:8]选择调制级数，FR1[14:12]选择Profile引脚分配，CFR[23:22]选择调制参数，
+ *              调制字预先写入CFTW0/CPOW0/ACR和CW1-CW15，之后只切换P0-P3
+ ****************************************************************************************************
+ */
+
+#define AD9959_PROFILE_MASK		(0x0FU << AD9959_PROFILE_PIN_SHIFT)
+
+/* 4级调制：各通道使用的PPC配置和在P0-P3中的起始引脚 */
+static const uint8_t ad9959_mod_ppc4[AD9959_CH_COUNT] = {0, 3, 5, 2};	/* CH0/CH1, CH1/CH2, CH2/CH3, CH0/CH3 */
+static const uint8_t ad9959_mod_ofs4[AD9959_CH_COUNT] = {0, 0, 0, 2};
+
+/* 当前调制配置 */
+static struct
+{
+	uint8_t  bits;			/* 每符号位数 */
+	uint8_t  gray;			/* 1: 格雷码映射 */
+	uint32_t bsrr[16];		/* 各符号的BSRR值 */
+} ad9959_mod;
+
+/**
+ * @brief       初始化Profile引脚
+ * @param       无
+ * @retval      无
+ */
+void ad9959_mod_init(void)
+{
+	GPIO_InitTypeDef gpio = {0};
+
+	AD9959_PROFILE_CLK_ENABLE();
+	AD9959_BSRR_WRITE(AD9959_PROFILE_GPIO_Port, AD9959_PROFILE_MASK << 16);	// 符号0
+
+	gpio.Pin = AD9959_PROFILE_MASK;
+	gpio.Mode = GPIO_MODE_OUTPUT_PP;
+	gpio.Pull = GPIO_NOPULL;
+	gpio.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	HAL_GPIO_Init(AD9959_PROFILE_GPIO_Port, &gpio);
+}
+
+/**
+ * @brief       写入一个调制字
+ * @param       type: 调制类型
+ * @param       n: 调制字序号，0为CFTW0/CPOW0/ACR
+ * @param       word: 调制字
+ * @retval      无
+ * @note        CW1-CW15中相位和幅度按高位对齐
+ */
+static void ad9959_mod_write_word(uint8_t type, uint8_t n, uint32_t word)
+{
+	uint8_t data[4];
+
+	if(n == 0)
+	{
+		switch(type)
+		{
+			case AD9959_MOD_AMP:
+				data[0] = 0x00;
+				data[1] = (uint8_t)(0x10 | ((word >> 8) & 0x03));	// 使能幅度乘法器
+				data[2] = (uint8_t)word;
+				AD9959_WriteData_Unified(ACR, 3, data);
+				break;
+			case AD9959_MOD_PHASE:
+				data[0] = (uint8_t)((word >> 8) & 0x3F);
+				data[1] = (uint8_t)word;
+				AD9959_WriteData_Unified(CPOW0, 2, data);
+				break;
+			default:
+				data[0] = (uint8_t)(word >> 24);
+				data[1] = (uint8_t)(word >> 16);
+				data[2] = (uint8_t)(word >> 8);
+				data[3] = (uint8_t)word;
+				AD9959_WriteData_Unified(CFTW0, 4, data);
+				break;
+		}
+		return;
+	}
+
+	if(type == AD9959_MOD_AMP)
+		word = (word & 0x3FF) << 22;
+	else if(type == AD9959_MOD_PHASE)
+		word = (word & 0x3FFF) << 18;
+
+	data[0] = (uint8_t)(word >> 24);
+	data[1] = (uint8_t)(word >> 16);
+	data[2] = (uint8_t)(word >> 8);
+	data[3] = (uint8_t)word;
+	AD9959_WriteData_Unified(AD9959_CW(n), 4, data);
+}
+
+/**
+ * @brief       配置通道调制并装载调制字
+ * @param       ch: 通道 (0-3)
+ * @param       type: 调制类型
+ * @param       levels: 调制级数 2/4/8/16
+ * @param       words: 调制字
+ * @retval      0: 成功  1: 参数错误
+ */
+uint8_t ad9959_mod_config(uint8_t ch, uint8_t type, uint8_t levels, const uint32_t *words)
+{
+	uint8_t FR1_Data[3] = {ad9959_fr1_clock(),0x00,0x00};		// PLL倍频按当前器件的系统时钟，其余与ad9959_set_signal_out()相同
+	uint8_t CFR_Data[3] = {0x00,0x03,0x21};		// DAC满量程，相位累加器不清零，保证FSK/PSK相位连续
+	uint8_t lvl, ppc, ofs, n, sym;
+	uint32_t mask;
+
+	switch(levels)
+	{
+		case 2:  lvl = 0; ppc = 0; ofs = ch; break;
+		case 4:  lvl = 1; ppc = ad9959_mod_ppc4[ch & 3]; ofs = ad9959_mod_ofs4[ch & 3]; break;
+		case 8:  lvl = 2; ppc = ch; ofs = 0; break;
+		case 16: lvl = 3; ppc = ch; ofs = 0; break;
+		default: return 1;
+	}
+	if(ch >= AD9959_CH_COUNT || (type & 0x03) == 0 || words == NULL)
+		return 1;
+
+	ad9959_mod.gray = (type & AD9959_MOD_GRAY) != 0;
+	type &= 0x03;
+	ad9959_mod.bits = (uint8_t)(lvl + 1);
+
+	/* 预先计算各符号的BSRR值，只改变本通道使用的引脚 */
+	ofs = (uint8_t)(ofs + AD9959_PROFILE_PIN_SHIFT);
+	mask = ((1U << ad9959_mod.bits) - 1) << ofs;
+	for(sym = 0; sym < 16; sym++)
+		ad9959_mod.bsrr[sym] = (((uint32_t)sym << ofs) & mask) | ((~((uint32_t)sym << ofs) & mask) << 16);
+
+	FR1_Data[1] = (uint8_t)((ppc << 4) | lvl);
+	CFR_Data[0] = (uint8_t)(type << 6);
+
+	AD9959_WriteData_Unified(FR1, 3, FR1_Data);
+	ad9959_channel_sel_enable(ch);
+	AD9959_WriteData_Unified(CFR, 3, CFR_Data);
+	for(n = 0; n < levels; n++)
+		ad9959_mod_write_word(type, n, words[n]);
+
+	ad9959_mod_symbol(0);
+	IO_update();
+	return 0;
+}
+
+/**
+ * @brief       查询每个符号的比特数
+ * @param       无
+ * @retval      比特数
+ */
+uint8_t ad9959_mod_bits(void)
+{
+	return ad9959_mod.bits;
+}
+
+/**
+ * @brief       计算输出一个符号的BSRR值
+ * @param       sym: 符号
+ * @retval      BSRR值
+ */
+uint32_t ad9959_mod_bsrr(uint8_t sym)
+{
+	return ad9959_mod.bsrr[sym & 0x0F];
+}
+
+/**
+ * @brief       输出一个符号
+ * @param       sym: 符号
+ * @retval      无
+ */
+void ad9959_mod_symbol(uint8_t sym)
+{
+	AD9959_BSRR_WRITE(AD9959_PROFILE_GPIO_Port, ad9959_mod.bsrr[sym & 0x0F]);
+}
+
+/**
+ * @brief       把比特流编码为符号序列的BSRR值
+ * @param       data: 比特流
+ * @param       nbits: 比特数
+ * @param       out: 输出
+ * @param       max: 输出缓冲区容量
+ * @retval      编码的符号数
+ */
+uint32_t ad9959_mod_encode(const uint8_t *data, uint32_t nbits, uint32_t *out, uint32_t max)
+{
+	uint32_t pos, count = 0;
+	uint8_t i, v;
+
+	if(ad9959_mod.bits == 0)
+		return 0;
+
+	for(pos = 0; pos < nbits && count < max; count++)
+	{
+		/* 取出一个符号的比特，高位在前 */
+		v = 0;
+		for(i = 0; i < ad9959_mod.bits; i++, pos++)
+		{
+			v <<= 1;
+			if(pos < nbits && (data[pos >> 3] & (0x80 >> (pos & 7))))
+				v |= 1;
+		}
+
+		/* 格雷码：相邻符号只差一位，v为格雷码时对应的符号序号 */
+		if(ad9959_mod.gray)
+			v = (uint8_t)(v ^ (v >> 1) ^ (v >> 2) ^ (v >> 3));
+
+		out[count] = ad9959_mod.bsrr[v];
+	}
+	return count;
+}
@@ -0,0 +1,287 @@
+#include "main.h"
+#include "myad9959_queue.h"
+
+#include <string.h>
+
+/**
+ ****************************************************************************************************
+ * @file        myad9959_queue.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       AD9959非阻塞事务队列
+ *              调用者把寄存器写入和IO_update标记放入队列后立即返回，
+ *              由传输完成中断依次发送，队列本身不依赖HAL，便于在主机上用假SPI后端测试
+ ****************************************************************************************************
+ */
+
+#define AD9959_QUEUE_WRITE		0	/* 寄存器写入事务 */
+#define AD9959_QUEUE_UPDATE		1	/* IO_update标记 */
+
+/* 队列事务 */
+typedef struct
+{
+	uint8_t  type;			/* 事务类型 */
+	uint16_t ofs;			/* 数据在缓冲区中的偏移 */
+	uint16_t len;			/* 数据长度(含指令字节) */
+	uint16_t pad;			/* 为保持数据连续而跳过的缓冲区末尾字节数 */
+	ad9959_queue_cb_t cb;	/* IO_update完成回调 */
+	void    *ctx;
+} ad9959_queue_entry_t;
+
+/* 单生产者(主循环)单消费者(中断)队列，计数器只增不减，取模得到下标 */
+static struct
+{
+	const ad9959_queue_ops_t *ops;
+	ad9959_queue_entry_t entry[AD9959_QUEUE_DEPTH];
+	uint8_t  buf[AD9959_QUEUE_BUF_SIZE];
+	volatile uint32_t e_wr, e_rd;		/* 事务写/读计数 */
+	volatile uint32_t d_wr, d_rd;		/* 数据字节写/读计数 */
+	volatile uint8_t  busy;				/* 正在传输 */
+	volatile uint32_t errors;
+} ad9959_queue;
+
+/**
+ * @brief       初始化事务队列
+ * @param       ops: 底层传输接口
+ * @retval      无
+ */
+void ad9959_queue_init(const ad9959_queue_ops_t *ops)
+{
+	AD9959_QUEUE_LOCK();
+	memset(&ad9959_queue, 0, sizeof(ad9959_queue));
+	ad9959_queue.ops = ops;
+	AD9959_QUEUE_UNLOCK();
+}
+
+/**
+ * @brief       移除队首事务并释放其数据空间
+ * @param       无
+ * @retval      无
+ */
+static void ad9959_queue_pop(void)
+{
+	ad9959_queue_entry_t *e = &ad9959_queue.entry[ad9959_queue.e_rd % AD9959_QUEUE_DEPTH];
+
+	ad9959_queue.d_rd += e->pad + e->len;
+	ad9959_queue.e_rd++;
+}
+
+/**
+ * @brief       依次处理队首事务，直到启动一次传输或队列为空
+ * @param       无
+ * @retval      无
+ * @note        只能在关中断或传输完成中断中调用
+ */
+static void ad9959_queue_run(void)
+{
+	ad9959_queue_entry_t *e;
+	ad9959_queue_cb_t cb;
+	void *ctx;
+
+	while(ad9959_queue.e_rd != ad9959_queue.e_wr)
+	{
+		e = &ad9959_queue.entry[ad9959_queue.e_rd % AD9959_QUEUE_DEPTH];
+
+		if(e->type == AD9959_QUEUE_UPDATE)
+		{
+			cb = e->cb;
+			ctx = e->ctx;
+			ad9959_queue.ops->io_update();
+			ad9959_queue_pop();
+			if(cb != NULL)
+				cb(ctx);
+			continue;
+		}
+
+		ad9959_queue.busy = 1;
+		ad9959_queue.ops->cs(0);
+		if(ad9959_queue.ops->start(&ad9959_queue.buf[e->ofs], e->len) == 0)
+			return;		// 等待ad9959_queue_tx_done()
+
+		/* 启动失败，丢弃该事务 */
+		ad9959_queue.ops->cs(1);
+		ad9959_queue.errors++;
+		ad9959_queue_pop();
+	}
+	ad9959_queue.busy = 0;
+}
+
+/**
+ * @brief       空闲时启动队列处理
+ * @param       无
+ * @retval      无
+ */
+static void ad9959_queue_kick(void)
+{
+	AD9959_QUEUE_LOCK();
+	if(!ad9959_queue.busy)
+		ad9959_queue_run();
+	AD9959_QUEUE_UNLOCK();
+}
+
+/**
+ * @brief       尝试申请一个事务槽和连续的数据空间
+ * @param       len: 数据长度
+ * @retval      事务指针，空间不足时返回NULL
+ * @note        只能在关中断时调用；队列为空时把数据计数回绕到0，任何不超过缓冲区一半的数据都能放下
+ */
+static ad9959_queue_entry_t *ad9959_queue_try_alloc(uint16_t len)
+{
+	ad9959_queue_entry_t *e;
+	uint32_t pos, pad;
+
+	if(ad9959_queue.e_rd == ad9959_queue.e_wr)
+	{
+		ad9959_queue.d_wr = 0;		// 中断只在有事务时修改d_rd，此时可以安全回绕
+		ad9959_queue.d_rd = 0;
+	}
+
+	pos = ad9959_queue.d_wr % AD9959_QUEUE_BUF_SIZE;
+	pad = (pos + len > AD9959_QUEUE_BUF_SIZE) ? (AD9959_QUEUE_BUF_SIZE - pos) : 0;
+	if(ad9959_queue.e_wr - ad9959_queue.e_rd >= AD9959_QUEUE_DEPTH ||
+	   ad9959_queue.d_wr + pad + len - ad9959_queue.d_rd > AD9959_QUEUE_BUF_SIZE)
+		return NULL;
+
+	e = &ad9959_queue.entry[ad9959_queue.e_wr % AD9959_QUEUE_DEPTH];
+	e->ofs = (uint16_t)((pos + pad) % AD9959_QUEUE_BUF_SIZE);
+	e->len = len;
+	e->pad = (uint16_t)pad;
+	e->cb = NULL;
+	e->ctx = NULL;
+	return e;
+}
+
+/**
+ * @brief       事务入队
+ * @param       type: 事务类型
+ * @param       head: 数据前的指令字节，负数表示没有
+ * @param       data: 数据指针
+ * @param       len: 数据字节数(不含指令字节)
+ * @param       cb: IO_update完成回调
+ * @param       ctx: 回调参数
+ * @retval      0: 成功  1: 数据超过AD9959_QUEUE_MAX_FRAME，或在中断中调用时队列已满
+ * @note        申请、填写和提交在同一个临界区内完成，主循环和定时器中断都可以入队；
+ *              主循环中空间不足时等待SPI完成中断释放，中断中不等待(可能比SPI中断优先级高而死锁)，直接返回失败
+ */
+static uint8_t ad9959_queue_push(uint8_t type, int16_t head, const uint8_t *data, uint16_t len,
+								 ad9959_queue_cb_t cb, void *ctx)
+{
+	ad9959_queue_entry_t *e;
+	uint16_t total = (uint16_t)(len + (head >= 0 ? 1 : 0));
+
+	if(total > AD9959_QUEUE_MAX_FRAME)
+		return 1;
+
+	for(;;)
+	{
+		{
+			AD9959_QUEUE_LOCK();
+			e = ad9959_queue_try_alloc(total);
+			if(e != NULL)
+			{
+				e->type = type;
+				e->cb = cb;
+				e->ctx = ctx;
+				if(head >= 0)
+					ad9959_queue.buf[e->ofs] = (uint8_t)head;			// 指令字节
+				if(len != 0)
+					memcpy(&ad9959_queue.buf[e->ofs + total - len], data, len);
+				ad9959_queue.d_wr += e->pad + e->len;
+				ad9959_queue.e_wr++;
+			}
+			AD9959_QUEUE_UNLOCK();
+		}
+
+		if(e != NULL)
+			break;
+		if(AD9959_QUEUE_IN_ISR())
+		{
+			ad9959_queue.errors++;
+			return 1;
+		}
+		ad9959_queue_kick();	// 确保队列在运转，然后等待空间
+	}
+
+	ad9959_queue_kick();
+	return 0;
+}
+
+/**
+ * @brief       寄存器写入事务入队
+ * @param       reg: 寄存器地址
+ * @param       len: 数据字节数
+ * @param       data: 数据指针
+ * @retval      0: 成功  1: 失败
+ */
+uint8_t ad9959_queue_write(uint8_t reg, uint8_t len, const uint8_t *data)
+{
+	return ad9959_queue_push(AD9959_QUEUE_WRITE, reg, data, len, NULL, NULL);
+}
+
+/**
+ * @brief       一帧数据入队
+ * @param       buf: 数据指针
+ * @param       len: 字节数
+ * @retval      0: 成功  1: 失败
+ */
+uint8_t ad9959_queue_frame(const uint8_t *buf, uint16_t len)
+{
+	return ad9959_queue_push(AD9959_QUEUE_WRITE, -1, buf, len, NULL, NULL);
+}
+
+/**
+ * @brief       IO_update标记入队
+ * @param       cb: 完成回调，可以为NULL
+ * @param       ctx: 回调参数
+ * @retval      0: 成功  1: 失败
+ */
+uint8_t ad9959_queue_io_update(ad9959_queue_cb_t cb, void *ctx)
+{
+	return ad9959_queue_push(AD9959_QUEUE_UPDATE, -1, NULL, 0, cb, ctx);
+}
+
+/**
+ * @brief       当前传输完成通知
+ * @param       无
+ * @retval      无
+ */
+void ad9959_queue_tx_done(void)
+{
+	if(!ad9959_queue.busy)
+		return;
+
+	ad9959_queue.ops->cs(1);	// 结束本次片选
+	ad9959_queue_pop();
+	ad9959_queue_run();
+}
+
+/**
+ * @brief       查询队列是否忙
+ * @param       无
+ * @retval      1: 忙  0: 空闲
+ */
+uint8_t ad9959_queue_busy(void)
+{
+	return ad9959_queue.busy || ad9959_queue.e_rd != ad9959_queue.e_wr;
+}
+
+/**
+ * @brief       等待队列中所有事务完成
+ * @param       无
+ * @retval      无
+ */
+void ad9959_queue_wait(void)
+{
+	while(ad9959_queue_busy())
+		ad9959_queue_kick();
+}
+
+/**
+ * @brief       获取错误计数
+ * @param       无
+ * @retval      被丢弃的事务数
+ */
+uint32_t ad9959_queue_errors(void)
+{
+	return ad9959_queue.errors;
+}
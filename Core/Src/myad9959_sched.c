@@ -0,0 +1,192 @@
+#include "myad9959.h"
+#include "myad9959_sched.h"
+
+#include <string.h>
+
+/**
+ ****************************************************************************************************
+ * @file        myad9959_sched.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       AD9959定时更新调度器
+ *              事件按生效时刻存放在最小堆中，时间戳比较考虑32位回绕，
+ *              同一时刻的多个事件合并为一次IO_update，多个通道同时生效
+ ****************************************************************************************************
+ */
+
+static struct
+{
+	ad9959_sched_event_t heap[AD9959_SCHED_DEPTH];
+	uint16_t count;
+	uint32_t horizon;					/* 预装窗口(时间基准计数) */
+	ad9959_sched_stats_t stats;
+} ad9959_sched;
+
+/* a是否早于b，允许时间戳回绕 */
+#define AD9959_SCHED_BEFORE(a, b)	((int32_t)((a) - (b)) < 0)
+
+/**
+ * @brief       初始化调度器
+ * @param       无
+ * @retval      无
+ */
+void ad9959_sched_init(void)
+{
+	memset(&ad9959_sched, 0, sizeof(ad9959_sched));
+	ad9959_sched.horizon = (uint32_t)((uint64_t)AD9959_SCHED_HORIZON_US * AD9959_TIMER_HZ / 1000000U);
+}
+
+/**
+ * @brief       添加一个事件
+ * @param       ev: 事件
+ * @retval      0: 成功  1: 队列已满
+ */
+uint8_t ad9959_sched_add(const ad9959_sched_event_t *ev)
+{
+	ad9959_sched_event_t *h = ad9959_sched.heap;
+	uint16_t i, parent;
+
+	if(ad9959_sched.count >= AD9959_SCHED_DEPTH)
+	{
+		ad9959_sched.stats.rejected++;
+		return 1;
+	}
+
+	/* 上浮 */
+	i = ad9959_sched.count++;
+	while(i > 0)
+	{
+		parent = (uint16_t)((i - 1) / 2);
+		if(!AD9959_SCHED_BEFORE(ev->when, h[parent].when))
+			break;
+		h[i] = h[parent];
+		i = parent;
+	}
+	h[i] = *ev;
+	return 0;
+}
+
+/**
+ * @brief       取出最早的事件
+ * @param       ev: 输出
+ * @retval      无
+ */
+static void ad9959_sched_pop(ad9959_sched_event_t *ev)
+{
+	ad9959_sched_event_t *h = ad9959_sched.heap;
+	ad9959_sched_event_t last;
+	uint16_t i = 0, child, n;
+
+	*ev = h[0];
+	n = --ad9959_sched.count;
+	if(n == 0)
+		return;
+
+	/* 末尾元素放到堆顶后下沉 */
+	last = h[n];
+	for(;;)
+	{
+		child = (uint16_t)(2 * i + 1);
+		if(child >= n)
+			break;
+		if(child + 1 < n && AD9959_SCHED_BEFORE(h[child + 1].when, h[child].when))
+			child++;
+		if(!AD9959_SCHED_BEFORE(h[child].when, last.when))
+			break;
+		h[i] = h[child];
+		i = child;
+	}
+	h[i] = last;
+}
+
+/**
+ * @brief       把一个事件写入影子寄存器
+ * @param       ev: 事件
+ * @retval      无
+ */
+static void ad9959_sched_load(const ad9959_sched_event_t *ev)
+{
+	uint8_t data[4];
+	uint32_t v;
+
+	ad9959_channel_sel_enable(ev->ch);
+
+	if(ev->flags & AD9959_SCHED_AMP)
+	{
+		data[0] = 0x00;
+		data[1] = (uint8_t)(0x10 | ((ev->amp >> 8) & 0x03));	// 使能幅度乘法器
+		data[2] = (uint8_t)ev->amp;
+		AD9959_WriteData_Unified(ACR, 3, data);
+	}
+	if(ev->flags & AD9959_SCHED_PHASE)
+	{
+		v = AD9959_POW_FROM_DEG(ev->phase) & 0x3FFF;
+		data[0] = (uint8_t)(v >> 8);
+		data[1] = (uint8_t)v;
+		AD9959_WriteData_Unified(CPOW0, 2, data);
+	}
+	if(ev->flags & AD9959_SCHED_FRE)
+	{
+		v = ad9959_ftw_from_millihz(ev->fre_mhz);
+		data[0] = (uint8_t)(v >> 24);
+		data[1] = (uint8_t)(v >> 16);
+		data[2] = (uint8_t)(v >> 8);
+		data[3] = (uint8_t)v;
+		AD9959_WriteData_Unified(CFTW0, 4, data);
+	}
+}
+
+/**
+ * @brief       调度器处理
+ * @param       无
+ * @retval      无
+ */
+void ad9959_sched_poll(void)
+{
+	ad9959_sched_event_t ev;
+	uint32_t when, late;
+
+	if(ad9959_sched.count == 0 || ad9959_tim_busy())
+		return;		// 上一次IO_update还没产生，I/O缓冲不能改写
+
+	when = ad9959_sched.heap[0].when;
+	if(AD9959_SCHED_BEFORE(AD9959_TIMER_NOW() + ad9959_sched.horizon, when))
+		return;		// 还没进入预装窗口
+
+	/* 同一时刻的事件一起预装 */
+	while(ad9959_sched.count != 0 && ad9959_sched.heap[0].when == when)
+	{
+		ad9959_sched_pop(&ev);
+		ad9959_sched_load(&ev);
+		ad9959_sched.stats.events++;
+	}
+
+	if(ad9959_update_at(when))
+	{
+		late = AD9959_TIMER_NOW() - when;
+		ad9959_sched.stats.late++;
+		if(late > ad9959_sched.stats.max_late)
+			ad9959_sched.stats.max_late = late;
+	}
+	ad9959_sched.stats.updates++;
+}
+
+/**
+ * @brief       查询待执行事件数
+ * @param       无
+ * @retval      事件数
+ */
+uint16_t ad9959_sched_pending(void)
+{
+	return ad9959_sched.count;
+}
+
+/**
+ * @brief       获取执行统计
+ * @param       stats: 输出
+ * @retval      无
+ */
+void ad9959_sched_get_stats(ad9959_sched_stats_t *stats)
+{
+	*stats = ad9959_sched.stats;
+}
@@ -0,0 +1,252 @@
+#include "myad9959.h"
+#include "myad9959_stream.h"
+
+/**
+ ****************************************************************************************************
+ * @file        myad9959_stream.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       Profile引脚符号流
+ *              双缓冲区循环输出：一半在输出时填充另一半，
+ *              数据源不足时用符号0补齐并记下结束的一半，这一半输出完成后停止
+ ****************************************************************************************************
+ */
+
+static struct
+{
+	uint32_t buf[2 * AD9959_STREAM_HALF] __attribute__((aligned(32)));	/* BSRR值，DMA循环读取 */
+	uint8_t  data[AD9959_STREAM_HALF / 2];		/* 数据源比特缓存，每符号最多4位 */
+	ad9959_stream_src_t src;
+	void    *ctx;
+	uint32_t symbols;			/* 已从数据源取得的符号数 */
+	uint16_t pos;				/* 软件输出位置 */
+	uint8_t  running;
+	uint8_t  ending;			/* 数据源已结束 */
+	uint8_t  last_half;			/* 包含结束位置的一半 */
+} ad9959_stream;
+
+/**
+ * @brief       填充半个缓冲区
+ * @param       half: 0前半，1后半
+ * @retval      无
+ */
+static void ad9959_stream_fill(uint8_t half)
+{
+	uint32_t *out = &ad9959_stream.buf[half * AD9959_STREAM_HALF];
+	uint32_t nbits, got, count = 0;
+
+	if(!ad9959_stream.ending)
+	{
+		nbits = (uint32_t)AD9959_STREAM_HALF * ad9959_mod_bits();
+		got = ad9959_stream.src(ad9959_stream.ctx, ad9959_stream.data, nbits);
+		if(got > nbits)
+			got = nbits;
+		count = ad9959_mod_encode(ad9959_stream.data, got, out, AD9959_STREAM_HALF);
+		ad9959_stream.symbols += count;
+		if(got < nbits)
+		{
+			ad9959_stream.ending = 1;
+			ad9959_stream.last_half = half;
+		}
+	}
+
+	/* 数据结束后输出符号0 */
+	for(; count < AD9959_STREAM_HALF; count++)
+		out[count] = ad9959_mod_bsrr(0);
+}
+
+/**
+ * @brief       半个缓冲区输出完成
+ * @param       half: 0前半，1后半
+ * @retval      无
+ */
+void ad9959_stream_half_cplt(uint8_t half)
+{
+	if(!ad9959_stream.running)
+		return;
+
+	if(ad9959_stream.ending && ad9959_stream.last_half == half)
+	{
+		ad9959_stream_stop();
+		return;
+	}
+	ad9959_stream_fill(half);
+}
+
+#ifdef AD9959_USE_STREAM_DMA
+
+/**
+ * @brief       启动定时器和DMA
+ * @param       rate: 符号速率(Hz)
+ * @retval      无
+ */
+static void ad9959_stream_hw_start(uint32_t rate)
+{
+	TIM_TypeDef *tim = AD9959_STREAM_TIM;
+	DMA_Stream_TypeDef *dma = AD9959_STREAM_DMA;
+	uint32_t arr = ad9959_tim_get_clk() / rate;
+
+	AD9959_STREAM_TIM_CLK_ENABLE();
+	AD9959_STREAM_DMA_CLK_ENABLE();
+
+	/* DMA：内存到外设，32位，循环模式，半传输和传输完成中断 */
+	dma->CR &= ~DMA_SxCR_EN;
+	while(dma->CR & DMA_SxCR_EN)
+	{
+	}
+	AD9959_STREAM_DMA_IFCR = AD9959_STREAM_DMA_ALL;
+	dma->PAR = (uint32_t)&AD9959_PROFILE_GPIO_Port->BSRR;
+	dma->M0AR = (uint32_t)ad9959_stream.buf;
+	dma->NDTR = 2 * AD9959_STREAM_HALF;
+	dma->FCR = 0;															// 直接模式
+	dma->CR = DMA_SxCR_DIR_0 | DMA_SxCR_MINC | DMA_SxCR_PSIZE_1 | DMA_SxCR_MSIZE_1 |
+			  DMA_SxCR_CIRC | DMA_SxCR_PL_1 | DMA_SxCR_HTIE | DMA_SxCR_TCIE;
+	AD9959_STREAM_DMAMUX->CCR = AD9959_STREAM_DMA_REQ;
+
+	HAL_NVIC_SetPriority(AD9959_STREAM_IRQn, AD9959_STREAM_IRQ_PRIO, 0);
+	HAL_NVIC_EnableIRQ(AD9959_STREAM_IRQn);
+
+	/* 定时器：每个更新事件请求一次DMA */
+	tim->CR1 = 0;
+	tim->PSC = 0;
+	tim->ARR = (arr > 0) ? arr - 1 : 0;
+	tim->CNT = 0;
+	tim->EGR = TIM_EGR_UG;
+	tim->SR = 0;
+	tim->DIER = TIM_DIER_UDE;
+
+	dma->CR |= DMA_SxCR_EN;
+	tim->CR1 = TIM_CR1_CEN;
+}
+
+/**
+ * @brief       停止定时器和DMA
+ * @param       无
+ * @retval      无
+ */
+static void ad9959_stream_hw_stop(void)
+{
+	AD9959_STREAM_TIM->CR1 = 0;
+	AD9959_STREAM_TIM->DIER = 0;
+	AD9959_STREAM_DMA->CR &= ~DMA_SxCR_EN;
+	AD9959_STREAM_DMA_IFCR = AD9959_STREAM_DMA_ALL;
+}
+
+/**
+ * @brief       DMA中断
+ * @param       无
+ * @retval      无
+ */
+void AD9959_STREAM_IRQHandler(void)
+{
+	uint32_t isr = AD9959_STREAM_DMA_ISR;
+
+	AD9959_STREAM_DMA_IFCR = isr & AD9959_STREAM_DMA_ALL;
+	if(isr & AD9959_STREAM_DMA_HT)
+		ad9959_stream_half_cplt(0);
+	if(isr & AD9959_STREAM_DMA_TC)
+		ad9959_stream_half_cplt(1);
+}
+
+/**
+ * @brief       DMA模式下符号由硬件输出
+ */
+uint8_t ad9959_stream_tick(void)
+{
+	return ad9959_stream.running;
+}
+
+#else
+
+/**
+ * @brief       软件模式：由ad9959_stream_tick()输出
+ */
+static void ad9959_stream_hw_start(uint32_t rate)
+{
+	(void)rate;
+}
+
+static void ad9959_stream_hw_stop(void)
+{
+}
+
+/**
+ * @brief       软件输出下一个符号
+ * @param       无
+ * @retval      1: 仍在输出  0: 已停止
+ */
+uint8_t ad9959_stream_tick(void)
+{
+	if(!ad9959_stream.running)
+		return 0;
+
+	AD9959_BSRR_WRITE(AD9959_PROFILE_GPIO_Port, ad9959_stream.buf[ad9959_stream.pos]);
+	if(++ad9959_stream.pos == AD9959_STREAM_HALF)
+		ad9959_stream_half_cplt(0);
+	else if(ad9959_stream.pos == 2 * AD9959_STREAM_HALF)
+	{
+		ad9959_stream.pos = 0;
+		ad9959_stream_half_cplt(1);
+	}
+	return ad9959_stream.running;
+}
+
+#endif
+
+/**
+ * @brief       开始输出符号流
+ * @param       rate: 符号速率(Hz)
+ * @param       src: 符号数据源
+ * @param       ctx: 传给数据源的参数
+ * @retval      0: 成功  1: 正在输出或未配置调制
+ */
+uint8_t ad9959_stream_start(uint32_t rate, ad9959_stream_src_t src, void *ctx)
+{
+	if(ad9959_stream.running || ad9959_mod_bits() == 0 || src == NULL || rate == 0)
+		return 1;
+
+	ad9959_stream.src = src;
+	ad9959_stream.ctx = ctx;
+	ad9959_stream.symbols = 0;
+	ad9959_stream.pos = 0;
+	ad9959_stream.ending = 0;
+
+	/* 两半都填好再启动 */
+	ad9959_stream_fill(0);
+	ad9959_stream_fill(1);
+	ad9959_stream.running = 1;
+	ad9959_stream_hw_start(rate);
+	return 0;
+}
+
+/**
+ * @brief       立即停止输出
+ * @param       无
+ * @retval      无
+ */
+void ad9959_stream_stop(void)
+{
+	ad9959_stream_hw_stop();
+	ad9959_stream.running = 0;
+	ad9959_mod_symbol(0);
+}
+
+/**
+ * @brief       查询是否正在输出
+ * @param       无
+ * @retval      1: 正在输出  0: 空闲
+ */
+uint8_t ad9959_stream_busy(void)
+{
+	return ad9959_stream.running;
+}
+
+/**
+ * @brief       查询已从数据源取得的符号数
+ * @param       无
+ * @retval      符号数
+ */
+uint32_t ad9959_stream_symbols(void)
+{
+	return ad9959_stream.symbols;
+}
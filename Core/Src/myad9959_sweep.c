@@ -0,0 +1,260 @@
+#include "myad9959.h"
+#include "myad9959_sweep.h"
+
+/**
+ ****************************************************************************************************
+ * @file        myad9959_sweep.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       AD9959软件扫频
+ *              频率控制字按段递推生成，通过跳频表的流式播放边生成边输出
+ ****************************************************************************************************
+ */
+
+static struct
+{
+	ad9959_sweep_gen_t gen;
+	ad9959_hop_table_t table;
+	uint8_t  buf[AD9959_SWEEP_RING * 5];			/* 双缓冲区，每点一个CFTW0帧 */
+	uint32_t ftw[AD9959_SWEEP_RING / 2];
+} ad9959_sweep;
+
+/**
+ * @brief       计算自然对数
+ * @param       x: 真数 (>0)
+ * @retval      ln(x)
+ * @note        工程未链接libm：x = 2^e * y，y在[√½, √2)内，ln(y) = 2atanh((y-1)/(y+1))按级数展开
+ */
+static double ad9959_sweep_ln(double x)
+{
+	double z, z2, t, sum;
+	int16_t e = 0;
+	uint8_t k;
+
+	while(x >= 1.4142135623730951)
+	{
+		x *= 0.5;
+		e++;
+	}
+	while(x < 0.7071067811865476)
+	{
+		x *= 2.0;
+		e--;
+	}
+
+	z = (x - 1.0) / (x + 1.0);		// |z| < 0.172
+	z2 = z * z;
+	t = z;
+	sum = z;
+	for(k = 3; k < 40; k += 2)
+	{
+		t *= z2;
+		sum += t / k;
+	}
+	return e * 0.6931471805599453 + 2.0 * sum;
+}
+
+/**
+ * @brief       计算e^x - 1
+ * @param       x: 指数
+ * @retval      e^x - 1
+ * @note        |x|较小时直接按泰勒级数展开，避免e^x接近1时相减损失精度；
+ *              |x|较大时由e^x - 1 = y(y + 2)，y = e^(x/2) - 1递归缩小
+ */
+static double ad9959_sweep_expm1(double x)
+{
+	double y, t, sum;
+	uint8_t k;
+
+	if(x > 0.25 || x < -0.25)
+	{
+		y = ad9959_sweep_expm1(x * 0.5);
+		return y * (y + 2.0);
+	}
+
+	t = x;
+	sum = x;
+	for(k = 2; k < 24; k++)
+	{
+		t *= x / k;
+		sum += t;
+	}
+	return sum;
+}
+
+/**
+ * @brief       开始当前段
+ * @param       g: 生成器
+ * @retval      无
+ */
+static void ad9959_sweep_gen_load(ad9959_sweep_gen_t *g)
+{
+	const ad9959_sweep_seg_t *s = &g->seg[g->idx];
+	double m;
+
+	g->end = (uint64_t)ad9959_ftw_from_millihz(s->fre_mhz) << 32;
+	g->left = s->points;
+	g->down = g->end < g->acc;
+
+	if(s->shape == AD9959_SWEEP_LOG)
+	{
+		/* 每点比例r = (终点/起点)^(1/点数)，m = |r - 1| */
+		m = ad9959_sweep_expm1(ad9959_sweep_ln((double)g->end / (double)g->acc) / s->points);
+		if(m < 0)
+			m = -m;
+		m *= 4294967296.0;
+		g->m_hi = (m >= 4294967295.0) ? 0xFFFFFFFFUL : (uint32_t)m;
+		g->m_lo = (uint32_t)((m - g->m_hi) * 4294967296.0);
+	}
+	else
+	{
+		g->step = (g->down ? g->acc - g->end : g->end - g->acc) / s->points;
+	}
+}
+
+/**
+ * @brief       初始化扫频生成器
+ * @param       g: 生成器
+ * @param       start_mhz: 起始频率
+ * @param       seg: 扫频段
+ * @param       nseg: 段数
+ * @retval      0: 成功  1: 参数错误
+ */
+uint8_t ad9959_sweep_gen_init(ad9959_sweep_gen_t *g, uint64_t start_mhz,
+							  const ad9959_sweep_seg_t *seg, uint16_t nseg)
+{
+	uint32_t f0 = ad9959_ftw_from_millihz(start_mhz), f1;
+	uint16_t i;
+
+	if(seg == NULL || nseg == 0)
+		return 1;
+
+	for(i = 0; i < nseg; i++)
+	{
+		f1 = ad9959_ftw_from_millihz(seg[i].fre_mhz);
+		if(seg[i].points == 0)
+			return 1;
+		if(seg[i].shape == AD9959_SWEEP_LOG)
+		{
+			if(f0 == 0 || f1 == 0)
+				return 1;
+			/* 每点比例r-1以Q0.64存放，递增时r必须小于2 */
+			if(seg[i].points < 32 && f1 >= f0 && (uint64_t)f1 >= ((uint64_t)f0 << seg[i].points))
+				return 1;
+		}
+		else if(seg[i].shape != AD9959_SWEEP_LIN)
+			return 1;
+		f0 = f1;
+	}
+
+	g->seg = seg;
+	g->nseg = nseg;
+	g->idx = 0;
+	g->acc = (uint64_t)ad9959_ftw_from_millihz(start_mhz) << 32;
+	g->first = 1;
+	ad9959_sweep_gen_load(g);
+	return 0;
+}
+
+/**
+ * @brief       生成后续的频率控制字
+ * @param       g: 生成器
+ * @param       ftw: 输出
+ * @param       max: 输出容量
+ * @retval      生成的个数
+ */
+uint32_t ad9959_sweep_gen_next(ad9959_sweep_gen_t *g, uint32_t *ftw, uint32_t max)
+{
+	uint32_t n = 0, ah, al;
+	uint64_t d, p1, p2;
+
+	if(g->first && max > 0)
+	{
+		ftw[n++] = (uint32_t)((g->acc + 0x80000000ULL) >> 32);
+		g->first = 0;
+	}
+
+	while(n < max && g->idx < g->nseg)
+	{
+		if(g->left == 0)
+		{
+			if(++g->idx < g->nseg)
+				ad9959_sweep_gen_load(g);
+			continue;
+		}
+
+		if(--g->left == 0)
+			g->acc = g->end;			// 段终点取精确值
+		else
+		{
+			if(g->seg[g->idx].shape == AD9959_SWEEP_LOG)
+			{
+				/*
+				 * d = acc * m，Q32.32乘Q0.64，结果舍入到2^-32：
+				 * 早期的截断误差会随频率按比例放大，所以低位部分积也要带进位并四舍五入
+				 */
+				ah = (uint32_t)(g->acc >> 32);
+				al = (uint32_t)g->acc;
+				p1 = (uint64_t)al * g->m_hi;
+				p2 = (uint64_t)ah * g->m_lo;
+				d = (uint32_t)p1 + (uint64_t)(uint32_t)p2 + (((uint64_t)al * g->m_lo) >> 32) + 0x80000000ULL;
+				d = (uint64_t)ah * g->m_hi + (p1 >> 32) + (p2 >> 32) + (d >> 32);
+			}
+			else
+				d = g->step;
+			g->acc = g->down ? g->acc - d : g->acc + d;
+		}
+		ftw[n++] = (uint32_t)((g->acc + 0x80000000ULL) >> 32);
+	}
+	return n;
+}
+
+/**
+ * @brief       跳频表流式播放的填充回调
+ * @param       buf: 帧缓冲区
+ * @param       frames: 帧数
+ * @param       ctx: 生成器
+ * @retval      写入的帧数
+ */
+static uint32_t ad9959_sweep_refill(uint8_t *buf, uint32_t frames, void *ctx)
+{
+	uint32_t n = ad9959_sweep_gen_next((ad9959_sweep_gen_t *)ctx, ad9959_sweep.ftw, frames), i, v;
+
+	for(i = 0; i < n; i++, buf += 5)
+	{
+		v = ad9959_sweep.ftw[i];
+		buf[0] = CFTW0;
+		buf[1] = (uint8_t)(v >> 24);
+		buf[2] = (uint8_t)(v >> 16);
+		buf[3] = (uint8_t)(v >> 8);
+		buf[4] = (uint8_t)v;
+	}
+	return n;
+}
+
+/**
+ * @brief       播放软件扫频
+ * @param       ch: 通道
+ * @param       start_mhz: 起始频率
+ * @param       seg: 扫频段
+ * @param       nseg: 段数
+ * @param       rate: 每秒点数
+ * @retval      0: 成功  1: 参数错误或跳频表正在播放
+ */
+uint8_t ad9959_sweep_play(uint8_t ch, uint64_t start_mhz,
+						  const ad9959_sweep_seg_t *seg, uint16_t nseg, uint32_t rate)
+{
+	ad9959_hop_table_t *t = &ad9959_sweep.table;
+
+	if(ad9959_hop_busy() || ad9959_sweep_gen_init(&ad9959_sweep.gen, start_mhz, seg, nseg))
+		return 1;
+
+	t->buf = ad9959_sweep.buf;
+	t->size = sizeof(ad9959_sweep.buf);
+	t->count = AD9959_SWEEP_RING;
+	t->frame = 5;
+	t->ch = ch;
+	t->refill = ad9959_sweep_refill;
+	t->ctx = &ad9959_sweep.gen;
+	return ad9959_hop_play(t, rate, 1);
+}
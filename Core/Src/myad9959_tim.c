@@ -0,0 +1,170 @@
+#include "myad9959.h"
+
+/**
+ ****************************************************************************************************
+ * @file        myad9959_tim.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       定时器产生的IO_update脉冲
+ *              定时器工作在单脉冲+PWM模式2：计数到CCR4时UD拉高，计数到ARR后UD拉低并自动停止，
+ *              CCR4决定脉冲时刻，ARR-CCR4+1决定脉宽(按数据手册最小值AD9959_T_IO_UPDATE_NS)
+ ****************************************************************************************************
+ */
+
+#if defined(AD9959_USE_TIM_UPDATE) || defined(AD9959_USE_STREAM_DMA) || defined(AD9959_USE_HOP_TIM)
+
+/**
+ * @brief       计算APB1定时器计数时钟
+ * @param       无
+ * @retval      Hz
+ * @note        APB1分频系数不为1时定时器时钟为PCLK1的2倍
+ */
+uint32_t ad9959_tim_get_clk(void)
+{
+	uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+
+	return (RCC->D2CFGR & RCC_D2CFGR_D2PPRE1) ? pclk * 2 : pclk;
+}
+
+#endif
+
+#ifdef AD9959_USE_TIM_UPDATE
+
+/* 定时器计数时钟(Hz)和预分频为1时的脉宽计数 */
+static uint32_t ad9959_tim_clk;
+static uint32_t ad9959_tim_width;
+
+/**
+ * @brief       初始化IO_update定时器
+ * @param       无
+ * @retval      无
+ */
+void ad9959_tim_init(void)
+{
+	GPIO_InitTypeDef gpio = {0};
+	TIM_TypeDef *tim = AD9959_UPDATE_TIM;
+
+	AD9959_UPDATE_TIM_CLK_ENABLE();
+	ad9959_tim_clk = ad9959_tim_get_clk();
+	ad9959_tim_width = (uint32_t)(((uint64_t)AD9959_T_IO_UPDATE_NS * ad9959_tim_clk + 999999999ULL) / 1000000000ULL);
+	if(ad9959_tim_width == 0)
+		ad9959_tim_width = 1;
+
+	tim->CR1 = 0;
+	tim->CR1 = TIM_CR1_OPM;								// 单脉冲，向上计数，ARR无预装载
+	tim->CCMR2 = (7U << TIM_CCMR2_OC4M_Pos);			// PWM模式2：CNT>=CCR4时输出有效
+	tim->CCER = TIM_CCER_CC4E;							// 高电平有效
+	tim->PSC = 0;
+	tim->CCR4 = 1;
+	tim->ARR = 1;
+	tim->CNT = 0;
+	tim->EGR = TIM_EGR_UG;								// 装载PSC，输出为低
+
+	/* UD引脚切换为定时器输出 */
+	gpio.Pin = AD9959_UD_Pin;
+	gpio.Mode = GPIO_MODE_AF_PP;
+	gpio.Pull = GPIO_NOPULL;
+	gpio.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	gpio.Alternate = AD9959_UPDATE_TIM_AF;
+	HAL_GPIO_Init(AD9959_UD_GPIO_Port, &gpio);
+}
+
+/**
+ * @brief       查询定时器脉冲是否还未结束
+ * @param       无
+ * @retval      1: 未结束  0: 空闲
+ */
+uint8_t ad9959_tim_busy(void)
+{
+	return (AD9959_UPDATE_TIM->CR1 & TIM_CR1_CEN) != 0;
+}
+
+/**
+ * @brief       延时指定时间后产生IO_update脉冲
+ * @param       delay_ns: 距离现在的时间(ns)
+ * @retval      无
+ */
+void ad9959_tim_update_after(uint32_t delay_ns)
+{
+	TIM_TypeDef *tim = AD9959_UPDATE_TIM;
+	uint32_t psc = 0, ccr = 1, arr = ad9959_tim_width;	// CCR4=0时没有低电平阶段，最早在1个计数后拉高
+	uint64_t delay;
+
+	/* 立即产生(DMA完成中断中的常见情况)不需要任何除法 */
+	if(delay_ns != 0)
+	{
+		delay = (uint64_t)delay_ns * ad9959_tim_clk / 1000000000ULL;
+		psc = (uint32_t)((delay + ad9959_tim_width) >> 16);	// 预分频使计数值不超过16位
+		if(psc > 0xFFFF)
+		{
+			psc = 0xFFFF;
+			delay = (uint64_t)0xFFFF << 16;
+		}
+		ccr = (uint32_t)(delay / (psc + 1));
+		if(ccr == 0)
+			ccr = 1;
+		arr = ccr + (ad9959_tim_width + psc) / (psc + 1) - 1;
+		if(arr > 0xFFFF)
+			arr = 0xFFFF;
+	}
+
+	while(ad9959_tim_busy())
+	{
+	}
+
+	tim->PSC = psc;
+	tim->CCR4 = ccr;
+	tim->ARR = arr;
+	tim->EGR = TIM_EGR_UG;		// 装载预分频并清零计数器
+	tim->SR = 0;
+	tim->CR1 |= TIM_CR1_CEN;
+}
+
+#else
+
+/**
+ * @brief       软件模式：无需初始化
+ */
+void ad9959_tim_init(void)
+{
+}
+
+/**
+ * @brief       软件模式：始终空闲
+ */
+uint8_t ad9959_tim_busy(void)
+{
+	return 0;
+}
+
+/**
+ * @brief       软件模式：阻塞延时后用GPIO产生脉冲
+ * @param       delay_ns: 距离现在的时间(ns)
+ * @retval      无
+ */
+void ad9959_tim_update_after(uint32_t delay_ns)
+{
+	if(delay_ns != 0)
+		ad9959_delay_ns(delay_ns);
+	ad9959_io_update_pulse();
+}
+
+#endif
+
+/**
+ * @brief       在指定时刻产生IO_update脉冲
+ * @param       when: 时间戳
+ * @retval      0: 按时  1: 已迟到
+ */
+uint8_t ad9959_tim_update_at(uint32_t when)
+{
+	int32_t left = (int32_t)(when - AD9959_TIMER_NOW());
+
+	if(left <= 0)
+	{
+		ad9959_tim_update_after(0);
+		return 1;
+	}
+	ad9959_tim_update_after((uint32_t)((uint64_t)(uint32_t)left * 1000000000ULL / AD9959_TIMER_HZ));
+	return 0;
+}
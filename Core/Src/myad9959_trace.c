@@ -0,0 +1,156 @@
+#include "myad9959.h"
+
+#include <string.h>
+
+/**
+ ****************************************************************************************************
+ * @file        myad9959_trace.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       AD9959驱动性能统计
+ *              记录每次API调用发送的字节数、传输次数、IO_update次数和耗时，
+ *              嵌套调用(如IO_update内部的ad9959_flush)计入最外层调用
+ *              DMA队列模式下统计的是入队时间，不含实际传输时间
+ ****************************************************************************************************
+ */
+
+#ifdef AD9959_USE_TRACE
+
+static struct
+{
+	ad9959_trace_stats_t stats;
+	ad9959_trace_event_t ring[AD9959_TRACE_DEPTH];
+	ad9959_trace_event_t cur;		/* 正在进行的调用 */
+	uint8_t depth;					/* 调用嵌套深度 */
+} ad9959_trace;
+
+/**
+ * @brief       初始化统计
+ * @param       无
+ * @retval      无
+ */
+void ad9959_trace_init(void)
+{
+	AD9959_TIMER_INIT();
+	ad9959_trace_reset();
+}
+
+/**
+ * @brief       清零统计
+ * @param       无
+ * @retval      无
+ */
+void ad9959_trace_reset(void)
+{
+	memset(&ad9959_trace, 0, sizeof(ad9959_trace));
+}
+
+/**
+ * @brief       API调用开始
+ * @param       api: AD9959_TRACE_API_xxx
+ * @param       reg: 寄存器地址
+ * @retval      无
+ */
+void ad9959_trace_begin(uint8_t api, uint8_t reg)
+{
+	if(ad9959_trace.depth++ != 0)
+		return;		// 嵌套调用计入外层
+
+	memset(&ad9959_trace.cur, 0, sizeof(ad9959_trace.cur));
+	ad9959_trace.cur.api = api;
+	ad9959_trace.cur.reg = reg;
+	ad9959_trace.cur.start = AD9959_TIMER_NOW();
+}
+
+/**
+ * @brief       API调用结束，记录事件
+ * @param       无
+ * @retval      无
+ */
+void ad9959_trace_end(void)
+{
+	ad9959_trace_event_t *e = &ad9959_trace.cur;
+	ad9959_trace_stats_t *s = &ad9959_trace.stats;
+
+	if(ad9959_trace.depth == 0 || --ad9959_trace.depth != 0)
+		return;
+
+	e->ticks = AD9959_TIMER_NOW() - e->start;
+
+	s->calls[e->api]++;
+	s->ticks[e->api] += e->ticks;
+	if(e->ticks > s->max_ticks[e->api])
+		s->max_ticks[e->api] = e->ticks;
+
+	ad9959_trace.ring[s->events % AD9959_TRACE_DEPTH] = *e;
+	s->events++;
+}
+
+/**
+ * @brief       记录一次SPI传输
+ * @param       len: 字节数
+ * @retval      无
+ */
+void ad9959_trace_frame(uint16_t len)
+{
+	ad9959_trace.stats.bytes += len;
+	ad9959_trace.stats.frames++;
+	if(ad9959_trace.depth != 0)
+	{
+		ad9959_trace.cur.bytes += len;
+		ad9959_trace.cur.frames++;
+	}
+}
+
+/**
+ * @brief       记录一次IO_update
+ * @param       无
+ * @retval      无
+ */
+void ad9959_trace_update(void)
+{
+	ad9959_trace.stats.updates++;
+	if(ad9959_trace.depth != 0)
+		ad9959_trace.cur.updates++;
+}
+
+/**
+ * @brief       获取累计统计的快照
+ * @param       stats: 输出
+ * @retval      无
+ */
+void ad9959_trace_snapshot(ad9959_trace_stats_t *stats)
+{
+	*stats = ad9959_trace.stats;
+}
+
+/**
+ * @brief       读取最近的事件
+ * @param       events: 输出缓冲区
+ * @param       max: 容量
+ * @retval      读出的事件数
+ */
+uint16_t ad9959_trace_recent(ad9959_trace_event_t *events, uint16_t max)
+{
+	uint32_t total = ad9959_trace.stats.events;
+	uint32_t n = total < AD9959_TRACE_DEPTH ? total : AD9959_TRACE_DEPTH;
+	uint32_t i;
+
+	if(n > max)
+		n = max;
+	for(i = 0; i < n; i++)
+		events[i] = ad9959_trace.ring[(total - n + i) % AD9959_TRACE_DEPTH];
+	return (uint16_t)n;
+}
+
+/**
+ * @brief       时间戳计数换算为纳秒
+ * @param       ticks: 计数值
+ * @retval      纳秒
+ */
+uint32_t ad9959_trace_ns(uint32_t ticks)
+{
+	return (uint32_t)((uint64_t)ticks * 1000000000ULL / AD9959_TIMER_HZ);
+}
+
+#endif
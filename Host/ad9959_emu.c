@@ -0,0 +1,537 @@
+#include "ad9959_emu.h"
+
+#include <math.h>
+#include <string.h>
+
+/**
+ ****************************************************************************************************
+ * @file        ad9959_emu.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       AD9959寄存器级仿真模型(主机端)
+ ****************************************************************************************************
+ */
+
+#ifndef M_PI
+#define M_PI		3.14159265358979323846
+#endif
+
+#define EMU_CSR		0x00
+#define EMU_FR1		0x01
+#define EMU_FR2		0x02
+#define EMU_CFR		0x03
+#define EMU_CFTW0	0x04
+#define EMU_CPOW0	0x05
+#define EMU_ACR		0x06
+#define EMU_SRR		0x07
+#define EMU_RDW		0x08
+#define EMU_FDW		0x09
+#define EMU_CW1		0x0A
+
+/* 寄存器字节数和在寄存器数组中的偏移 */
+static const uint8_t emu_reg_len[AD9959_EMU_REG_COUNT] =
+{
+	1, 3, 2, 3, 4, 2, 3, 2, 4, 4,
+	4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4
+};
+
+static const uint8_t emu_reg_ofs[AD9959_EMU_REG_COUNT] =
+{
+	0, 1, 4, 6, 9, 13, 15, 18, 20, 24,
+	28, 32, 36, 40, 44, 48, 52, 56, 60, 64, 68, 72, 76, 80, 84
+};
+
+/* CSR/FR1/FR2为全局寄存器 */
+#define EMU_IS_GLOBAL(reg)	((reg) <= EMU_FR2)
+
+/**
+ * @brief       把若干字节按高字节在前写入寄存器数组
+ */
+static void emu_put(uint8_t *regs, uint8_t reg, uint32_t value)
+{
+	uint8_t i, len = emu_reg_len[reg];
+
+	for(i = 0; i < len; i++)
+		regs[emu_reg_ofs[reg] + i] = (uint8_t)(value >> (8 * (len - 1 - i)));
+}
+
+/**
+ * @brief       芯片复位
+ * @param       emu: 仿真对象
+ * @retval      无
+ */
+void ad9959_emu_reset(ad9959_emu_t *emu)
+{
+	uint8_t ch;
+
+	memset(emu->buf, 0, sizeof(emu->buf));
+	for(ch = 0; ch < AD9959_EMU_CH_COUNT; ch++)
+	{
+		emu_put(emu->buf[ch], EMU_CFR, 0x000302);	// DAC满量程，正弦输出
+		emu->acc[ch] = 0;
+		emu->sweeping[ch] = 0;
+	}
+	emu->csr = 0xF0;								// 所有通道使能，单线模式
+	emu_put(emu->buf[0], EMU_CSR, emu->csr);
+	memcpy(emu->act, emu->buf, sizeof(emu->act));
+
+	emu->mode = 0;
+	emu->nbits = 0;
+	emu->remain = 0;
+	emu->stats.resets++;
+}
+
+/**
+ * @brief       初始化仿真芯片
+ * @param       emu: 仿真对象
+ * @param       sys_clk: 系统时钟
+ * @retval      无
+ */
+void ad9959_emu_init(ad9959_emu_t *emu, uint32_t sys_clk)
+{
+	memset(emu, 0, sizeof(*emu));
+	emu->sys_clk = sys_clk;
+	emu->pins = AD9959_EMU_PIN_CS;
+	ad9959_emu_reset(emu);
+	ad9959_emu_clear_stats(emu);
+}
+
+/**
+ * @brief       清零统计计数
+ * @param       emu: 仿真对象
+ * @retval      无
+ */
+void ad9959_emu_clear_stats(ad9959_emu_t *emu)
+{
+	memset(&emu->stats, 0, sizeof(emu->stats));
+}
+
+/**
+ * @brief       一个寄存器的数据接收完成
+ * @param       emu: 仿真对象
+ * @retval      无
+ * @note        CSR立即生效，其它寄存器写入I/O缓冲，通道寄存器写入CSR选中的所有通道
+ */
+static void emu_commit(ad9959_emu_t *emu)
+{
+	uint8_t reg = emu->instr & 0x1F;
+	uint8_t len = emu_reg_len[reg];
+	uint8_t ch;
+
+	if(emu->instr & 0x80)
+		return;		// 读操作不改变寄存器
+
+	emu->stats.reg_writes[reg]++;
+
+	if(reg == EMU_CSR)
+	{
+		emu->csr = emu->data[0];
+		emu->mode = emu->csr & 0x06;		// 串行模式从下一个指令开始生效
+		emu->buf[0][0] = emu->csr;
+		emu->act[0][0] = emu->csr;
+		return;
+	}
+
+	if(EMU_IS_GLOBAL(reg))
+	{
+		memcpy(&emu->buf[0][emu_reg_ofs[reg]], emu->data, len);
+		return;
+	}
+
+	for(ch = 0; ch < AD9959_EMU_CH_COUNT; ch++)
+	{
+		if(emu->csr & (0x10 << ch))
+			memcpy(&emu->buf[ch][emu_reg_ofs[reg]], emu->data, len);
+	}
+}
+
+/**
+ * @brief       读指令：准备芯片输出的寄存器数据
+ * @param       emu: 仿真对象
+ * @param       reg: 寄存器地址
+ * @retval      无
+ * @note        通道寄存器取CSR选中的编号最小的通道，没有选中通道时输出0
+ */
+static void emu_load_read(ad9959_emu_t *emu, uint8_t reg)
+{
+	uint8_t ch = 0;
+
+	memset(emu->rdata, 0, sizeof(emu->rdata));
+	if(!EMU_IS_GLOBAL(reg))
+	{
+		while(ch < AD9959_EMU_CH_COUNT && !(emu->csr & (0x10 << ch)))
+			ch++;
+		if(ch >= AD9959_EMU_CH_COUNT)
+			return;
+	}
+	memcpy(emu->rdata, &emu->buf[ch][emu_reg_ofs[reg]], emu_reg_len[reg]);
+}
+
+/**
+ * @brief       接收一个完整字节
+ * @param       emu: 仿真对象
+ * @param       b: 字节
+ * @retval      无
+ */
+static void emu_byte(ad9959_emu_t *emu, uint8_t b)
+{
+	emu->stats.bytes++;
+	if(emu->log != NULL && emu->log_len < emu->log_size)
+		emu->log[emu->log_len++] = b;
+
+	if(emu->remain == 0)
+	{
+		/* 指令字节：bit7读写，bit4:0地址，无效地址被忽略 */
+		if((b & 0x1F) >= AD9959_EMU_REG_COUNT)
+			return;
+		emu->instr = b;
+		emu->remain = emu_reg_len[b & 0x1F];
+		emu->pos = 0;
+		if(b & 0x80)
+		{
+			emu->stats.reads++;
+			emu_load_read(emu, b & 0x1F);
+		}
+		return;
+	}
+
+	emu->data[emu->pos++] = b;
+	if(--emu->remain == 0)
+		emu_commit(emu);
+}
+
+/**
+ * @brief       IO_update
+ * @param       emu: 仿真对象
+ * @retval      无
+ * @note        CFR[2]或FR2[13]置位时清零相位累加器，CFR[1]或FR2[12]置位时保持清零
+ *              (FR2[13]按随本次IO_update生效的值判断，这是驱动采用的理解，数据手册没有明确说明)
+ */
+void ad9959_emu_io_update(ad9959_emu_t *emu)
+{
+	uint8_t ch;
+	uint8_t all_clear = (emu->buf[0][emu_reg_ofs[EMU_FR2]] & 0x30) != 0;
+
+	emu->stats.io_updates++;
+	memcpy(emu->act, emu->buf, sizeof(emu->act));
+
+	for(ch = 0; ch < AD9959_EMU_CH_COUNT; ch++)
+	{
+		uint8_t cfr_lo = emu->act[ch][emu_reg_ofs[EMU_CFR] + 2];
+
+		if(all_clear || (cfr_lo & 0x06))
+			emu->acc[ch] = 0;
+
+		/* 频率扫描：刚使能时从S0(CFTW0)开始 */
+		if((ad9959_emu_reg(emu, ch, EMU_CFR, 1) & 0xC04000) == 0x804000)
+		{
+			if(!emu->sweeping[ch])
+			{
+				emu->sweep[ch] = ad9959_emu_reg(emu, ch, EMU_CFTW0, 1);
+				emu->sweep_div[ch] = 0;
+				emu->sweeping[ch] = 1;
+			}
+		}
+		else
+			emu->sweeping[ch] = 0;
+	}
+}
+
+/**
+ * @brief       引脚级输入
+ * @param       emu: 仿真对象
+ * @param       pins: 引脚新电平
+ * @retval      无
+ */
+void ad9959_emu_pins(ad9959_emu_t *emu, uint32_t pins)
+{
+	uint32_t rise = pins & ~emu->pins;
+	uint32_t fall = ~pins & emu->pins;
+	uint8_t v;
+
+	emu->pins = pins;
+
+	if(pins & AD9959_EMU_PIN_RST)
+	{
+		if(rise & AD9959_EMU_PIN_RST)
+			ad9959_emu_reset(emu);
+		return;
+	}
+
+	/* 片选拉高复位串口状态机 */
+	if(rise & AD9959_EMU_PIN_CS)
+	{
+		emu->nbits = 0;
+		emu->remain = 0;
+	}
+	if(fall & AD9959_EMU_PIN_CS)
+		emu->stats.frames++;
+
+	if(rise & AD9959_EMU_PIN_UD)
+		ad9959_emu_io_update(emu);
+
+	if(!(rise & AD9959_EMU_PIN_CLK) || (pins & AD9959_EMU_PIN_CS))
+		return;
+
+	emu->stats.sclk++;
+	switch(emu->mode)
+	{
+		case 0x06:		// 4位：SDIO_3为最高位
+			v = (uint8_t)(((pins & AD9959_EMU_PIN_SDIO3) ? 8 : 0) | ((pins & AD9959_EMU_PIN_SDIO2) ? 4 : 0) |
+						  ((pins & AD9959_EMU_PIN_SDIO1) ? 2 : 0) | ((pins & AD9959_EMU_PIN_SDIO0) ? 1 : 0));
+			emu->shift = (uint8_t)((emu->shift << 4) | v);
+			emu->nbits += 4;
+			break;
+		case 0x04:		// 2位：SDIO_1为高位
+			v = (uint8_t)(((pins & AD9959_EMU_PIN_SDIO1) ? 2 : 0) | ((pins & AD9959_EMU_PIN_SDIO0) ? 1 : 0));
+			emu->shift = (uint8_t)((emu->shift << 2) | v);
+			emu->nbits += 2;
+			break;
+		default:		// 单线：SDIO_0输入
+			emu->shift = (uint8_t)((emu->shift << 1) | ((pins & AD9959_EMU_PIN_SDIO0) ? 1 : 0));
+			emu->nbits += 1;
+			break;
+	}
+
+	if(emu->nbits >= 8)
+	{
+		emu->nbits = 0;
+		emu_byte(emu, emu->shift);
+	}
+}
+
+/**
+ * @brief       字节级输入
+ * @param       emu: 仿真对象
+ * @param       buf: 数据
+ * @param       len: 字节数
+ * @retval      无
+ */
+void ad9959_emu_spi(ad9959_emu_t *emu, const uint8_t *buf, uint32_t len)
+{
+	uint32_t i;
+
+	if(emu->pins & (AD9959_EMU_PIN_CS | AD9959_EMU_PIN_RST))
+		return;		// 片选无效，芯片忽略总线
+
+	emu->stats.sclk += len * 8;
+	for(i = 0; i < len; i++)
+		emu_byte(emu, buf[i]);
+}
+
+/**
+ * @brief       字节级收发
+ * @param       emu: 仿真对象
+ * @param       tx: 发送的数据
+ * @param       rx: 输出，芯片在line上输出的数据
+ * @param       len: 字节数
+ * @param       line: 接收数据线
+ * @retval      无
+ */
+void ad9959_emu_spi_xfer(ad9959_emu_t *emu, const uint8_t *tx, uint8_t *rx, uint32_t len, uint32_t line)
+{
+	uint32_t i, oe;
+
+	for(i = 0; i < len; i++)
+	{
+		ad9959_emu_output(emu, &oe);
+		rx[i] = (oe & line) ? emu->rdata[emu->pos] : 0xFF;
+		ad9959_emu_spi(emu, &tx[i], 1);
+	}
+}
+
+/**
+ * @brief       查询芯片正在驱动的数据线
+ * @param       emu: 仿真对象
+ * @param       oe: 输出，芯片驱动的引脚
+ * @retval      驱动为高的引脚
+ */
+uint32_t ad9959_emu_output(const ad9959_emu_t *emu, uint32_t *oe)
+{
+	uint32_t line;
+
+	*oe = 0;
+	if(emu->pins & (AD9959_EMU_PIN_CS | AD9959_EMU_PIN_RST))
+		return 0;
+	if(emu->remain == 0 || !(emu->instr & 0x80))
+		return 0;
+	if(emu->mode == 0x00)
+		line = AD9959_EMU_PIN_SDIO0;
+	else if(emu->mode == 0x02)
+		line = AD9959_EMU_PIN_SDIO2;
+	else
+		return 0;		// 2位/4位模式不支持读取
+
+	*oe = line;
+	return ((emu->rdata[emu->pos] >> (7 - emu->nbits)) & 1) ? line : 0;
+}
+
+/**
+ * @brief       读取寄存器
+ * @param       emu: 仿真对象
+ * @param       ch: 通道
+ * @param       reg: 寄存器地址
+ * @param       active: 1生效值，0 I/O缓冲
+ * @retval      寄存器值
+ */
+uint32_t ad9959_emu_reg(const ad9959_emu_t *emu, uint8_t ch, uint8_t reg, uint8_t active)
+{
+	const uint8_t *regs;
+	uint32_t value = 0;
+	uint8_t i;
+
+	if(reg >= AD9959_EMU_REG_COUNT || ch >= AD9959_EMU_CH_COUNT)
+		return 0;
+	if(EMU_IS_GLOBAL(reg))
+		ch = 0;
+
+	regs = active ? emu->act[ch] : emu->buf[ch];
+	for(i = 0; i < emu_reg_len[reg]; i++)
+		value = (value << 8) | regs[emu_reg_ofs[reg] + i];
+	return value;
+}
+
+/* 4级调制：PPC配置对应的两个通道，前一个使用P0/P1，后一个使用P2/P3 */
+static const uint8_t emu_ppc4[8][2] =
+{
+	{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}, {0xFF, 0xFF}, {0xFF, 0xFF}
+};
+
+/**
+ * @brief       查询通道当前的调制符号
+ * @param       emu: 仿真对象
+ * @param       ch: 通道
+ * @retval      符号
+ */
+uint8_t ad9959_emu_symbol(const ad9959_emu_t *emu, uint8_t ch)
+{
+	uint32_t fr1 = ad9959_emu_reg(emu, 0, EMU_FR1, 1);
+	uint32_t cfr = ad9959_emu_reg(emu, ch, EMU_CFR, 1);
+	uint8_t p = (uint8_t)((emu->pins >> AD9959_EMU_PIN_P_SHIFT) & 0x0F);
+	uint8_t ppc = (uint8_t)((fr1 >> 12) & 0x07);
+
+	if((cfr >> 22) == 0)
+		return 0;
+
+	switch((fr1 >> 8) & 0x03)
+	{
+		case 0:
+			return (uint8_t)((p >> ch) & 1);
+		case 1:
+			if(emu_ppc4[ppc][0] == ch)
+				return (uint8_t)(p & 3);
+			if(emu_ppc4[ppc][1] == ch)
+				return (uint8_t)((p >> 2) & 3);
+			return 0;
+		case 2:
+			return (ppc == ch) ? (uint8_t)(p & 7) : 0;
+		default:
+			return (ppc == ch) ? p : 0;
+	}
+}
+
+/**
+ * @brief       推进时间，运行线性扫频
+ * @param       emu: 仿真对象
+ * @param       cycles: SYNC_CLK周期数
+ * @retval      无
+ */
+void ad9959_emu_run(ad9959_emu_t *emu, uint32_t cycles)
+{
+	uint32_t srr, rate, delta, limit;
+	uint64_t t, steps, v;
+	uint8_t ch, up;
+
+	for(ch = 0; ch < AD9959_EMU_CH_COUNT; ch++)
+	{
+		if(!emu->sweeping[ch])
+			continue;
+
+		srr = ad9959_emu_reg(emu, ch, EMU_SRR, 1);
+		up = (emu->pins >> (AD9959_EMU_PIN_P_SHIFT + ch)) & 1;
+		rate = up ? (srr & 0xFF) : (srr >> 8);
+		delta = ad9959_emu_reg(emu, ch, up ? EMU_RDW : EMU_FDW, 1);
+		limit = ad9959_emu_reg(emu, ch, up ? EMU_CW1 : EMU_CFTW0, 1);
+		if(rate == 0)
+			continue;
+
+		t = (uint64_t)emu->sweep_div[ch] + cycles;
+		steps = t / rate;
+		emu->sweep_div[ch] = (uint32_t)(t % rate);
+
+		/* 到达终点后停在终点 */
+		v = emu->sweep[ch];
+		if(up && v < limit)
+		{
+			v += steps * delta;
+			emu->sweep[ch] = (v > limit) ? limit : (uint32_t)v;
+		}
+		else if(!up && v > limit)
+		{
+			v = (steps * delta >= v - limit) ? limit : v - steps * delta;
+			emu->sweep[ch] = (uint32_t)v;
+		}
+	}
+}
+
+/**
+ * @brief       查询通道当前输出的频率控制字
+ * @param       emu: 仿真对象
+ * @param       ch: 通道
+ * @retval      频率控制字
+ */
+uint32_t ad9959_emu_ftw(const ad9959_emu_t *emu, uint8_t ch)
+{
+	uint8_t sym;
+
+	if(ch >= AD9959_EMU_CH_COUNT)
+		return 0;
+	if(emu->sweeping[ch])
+		return emu->sweep[ch];
+
+	sym = ad9959_emu_symbol(emu, ch);
+	if(sym != 0 && (ad9959_emu_reg(emu, ch, EMU_CFR, 1) >> 22) == 2)
+		return ad9959_emu_reg(emu, ch, (uint8_t)(0x09 + sym), 1);
+	return ad9959_emu_reg(emu, ch, EMU_CFTW0, 1);
+}
+
+/**
+ * @brief       生成输出波形
+ * @param       emu: 仿真对象
+ * @param       ch: 通道
+ * @param       out: 输出采样
+ * @param       n: 采样点数
+ * @param       step: 每点推进的系统时钟周期数
+ * @retval      无
+ */
+void ad9959_emu_render(ad9959_emu_t *emu, uint8_t ch, float *out, uint32_t n, uint32_t step)
+{
+	uint32_t ftw = ad9959_emu_ftw(emu, ch);
+	uint32_t pow = ad9959_emu_reg(emu, ch, EMU_CPOW0, 1) & 0x3FFF;
+	uint32_t acr = ad9959_emu_reg(emu, ch, EMU_ACR, 1);
+	uint32_t cfr = ad9959_emu_reg(emu, ch, EMU_CFR, 1);
+	double amp = (acr & 0x1000) ? (double)(acr & 0x3FF) / 1023.0 : 1.0;
+	uint8_t sym = ad9959_emu_symbol(emu, ch);
+	uint8_t hold = (cfr & 0x02) || (ad9959_emu_reg(emu, 0, EMU_FR2, 1) & 0x1000);
+	uint32_t i, phase, cw;
+
+	/* 调制：符号n使用CWn，相位和幅度在CW中高位对齐 */
+	if(sym != 0)
+	{
+		cw = ad9959_emu_reg(emu, ch, (uint8_t)(0x09 + sym), 1);
+		switch(cfr >> 22)
+		{
+			case 1:  amp = (double)(cw >> 22) / 1023.0; break;
+			case 2:  break;		// 已由ad9959_emu_ftw()选择
+			default: pow = cw >> 18; break;
+		}
+	}
+
+	for(i = 0; i < n; i++)
+	{
+		phase = emu->acc[ch] + (pow << 18);
+		out[i] = (float)(amp * sin(2.0 * M_PI * (double)phase / 4294967296.0));
+		if(!hold)		// CFR[1]或FR2[12]保持清零
+			emu->acc[ch] += ftw * step;
+	}
+}
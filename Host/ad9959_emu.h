@@ -0,0 +1,218 @@
+#ifndef AD9959_EMU_H
+#define AD9959_EMU_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ ****************************************************************************************************
+ * @file        ad9959_emu.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       AD9959寄存器级仿真模型(主机端)
+ *              解码串行时序(引脚级或字节级)，按通道维护I/O缓冲与生效寄存器，
+ *              模拟IO_update、复位和寄存器回读，并按相位累加器生成输出波形
+ *              不依赖HAL，驱动通过ad9959_host.c接入
+ ****************************************************************************************************
+ */
+
+#define AD9959_EMU_REG_COUNT	0x19	/* 寄存器地址总数 */
+#define AD9959_EMU_CH_COUNT		4		/* 通道数 */
+#define AD9959_EMU_REG_BYTES	88		/* 所有寄存器字节数之和 */
+
+/* 引脚位，用于ad9959_emu_pins() */
+#define AD9959_EMU_PIN_CS		0x001	/* 片选(低有效) */
+#define AD9959_EMU_PIN_CLK		0x002	/* SCLK */
+#define AD9959_EMU_PIN_SDIO0	0x004
+#define AD9959_EMU_PIN_SDIO1	0x008
+#define AD9959_EMU_PIN_SDIO2	0x010
+#define AD9959_EMU_PIN_SDIO3	0x020
+#define AD9959_EMU_PIN_UD		0x040	/* I/O UPDATE */
+#define AD9959_EMU_PIN_RST		0x080	/* 复位(高有效) */
+#define AD9959_EMU_PIN_PDC		0x100	/* 掉电控制 */
+#define AD9959_EMU_PIN_P0		0x200	/* Profile引脚P0-P3 */
+#define AD9959_EMU_PIN_P1		0x400
+#define AD9959_EMU_PIN_P2		0x800
+#define AD9959_EMU_PIN_P3		0x1000
+#define AD9959_EMU_PIN_P_SHIFT	9
+
+/* 统计计数，用于衡量每次API调用的总线开销 */
+typedef struct
+{
+	uint32_t frames;						/* 片选拉低次数 */
+	uint32_t bytes;							/* 收到的字节数(含指令字节) */
+	uint32_t sclk;							/* SCLK上升沿数 */
+	uint32_t io_updates;					/* IO_update次数 */
+	uint32_t resets;						/* 复位次数 */
+	uint32_t reads;							/* 读指令数 */
+	uint32_t reg_writes[AD9959_EMU_REG_COUNT];	/* 各寄存器写入次数 */
+} ad9959_emu_stats_t;
+
+/* 仿真芯片状态 */
+typedef struct
+{
+	uint32_t sys_clk;						/* 系统时钟(Hz) */
+
+	/* 寄存器：全局寄存器存放在通道0的位置，与驱动影子寄存器布局相同 */
+	uint8_t  csr;							/* CSR写入后立即生效 */
+	uint8_t  buf[AD9959_EMU_CH_COUNT][AD9959_EMU_REG_BYTES];	/* I/O缓冲 */
+	uint8_t  act[AD9959_EMU_CH_COUNT][AD9959_EMU_REG_BYTES];	/* 生效寄存器 */
+
+	/* 串行接口 */
+	uint32_t pins;							/* 当前引脚电平 */
+	uint8_t  mode;							/* 当前串行模式CSR[2:1] */
+	uint8_t  shift;							/* 移位寄存器 */
+	uint8_t  nbits;							/* 已移入位数 */
+	uint8_t  instr;							/* 当前指令字节 */
+	uint8_t  remain;						/* 当前指令剩余数据字节，0表示等待指令 */
+	uint8_t  pos;							/* 已收到的数据字节数 */
+	uint8_t  data[4];						/* 当前寄存器数据 */
+	uint8_t  rdata[4];						/* 读指令：芯片输出的寄存器数据 */
+
+	/* 输出 */
+	uint32_t acc[AD9959_EMU_CH_COUNT];		/* 相位累加器 */
+
+	/* 线性扫频 */
+	uint8_t  sweeping[AD9959_EMU_CH_COUNT];	/* 扫频已使能 */
+	uint32_t sweep[AD9959_EMU_CH_COUNT];	/* 扫描累加器(频率控制字) */
+	uint32_t sweep_div[AD9959_EMU_CH_COUNT];	/* 当前一步已经过的SYNC_CLK周期 */
+
+	ad9959_emu_stats_t stats;
+
+	/* 可选的字节记录：非NULL时依次保存解码出的每个字节(含指令字节)，满后不再记录 */
+	uint8_t *log;
+	uint32_t log_size;
+	uint32_t log_len;
+} ad9959_emu_t;
+
+/**
+ * @brief       初始化仿真芯片
+ * @param       emu: 仿真对象
+ * @param       sys_clk: 系统时钟(Hz)，一般为500000000
+ * @retval      无
+ * @note        相当于上电并复位，统计计数清零
+ */
+void ad9959_emu_init(ad9959_emu_t *emu, uint32_t sys_clk);
+
+/**
+ * @brief       芯片复位，所有寄存器恢复默认值
+ * @param       emu: 仿真对象
+ * @retval      无
+ */
+void ad9959_emu_reset(ad9959_emu_t *emu);
+
+/**
+ * @brief       引脚级输入
+ * @param       emu: 仿真对象
+ * @param       pins: 所有引脚的新电平(AD9959_EMU_PIN_xxx组合)
+ * @retval      无
+ * @note        片选低时在SCLK上升沿按当前串行模式采样SDIO，UD上升沿产生IO_update，RST高电平复位
+ */
+void ad9959_emu_pins(ad9959_emu_t *emu, uint32_t pins);
+
+/**
+ * @brief       字节级输入(硬件SPI，单线高位在前)
+ * @param       emu: 仿真对象
+ * @param       buf: 数据
+ * @param       len: 字节数
+ * @retval      无
+ * @note        片选必须已经拉低
+ */
+void ad9959_emu_spi(ad9959_emu_t *emu, const uint8_t *buf, uint32_t len);
+
+/**
+ * @brief       字节级收发(硬件SPI，单线高位在前)
+ * @param       emu: 仿真对象
+ * @param       tx: 发送的数据
+ * @param       rx: 输出，每个字节期间芯片在line上输出的数据，没有输出时为0xFF
+ * @param       len: 字节数
+ * @param       line: 接收数据线，AD9959_EMU_PIN_SDIO0或AD9959_EMU_PIN_SDIO2
+ * @retval      无
+ * @note        与ad9959_emu_spi()相同，另外按ad9959_emu_output()记录读指令之后芯片输出的数据
+ */
+void ad9959_emu_spi_xfer(ad9959_emu_t *emu, const uint8_t *tx, uint8_t *rx, uint32_t len, uint32_t line);
+
+/**
+ * @brief       查询芯片正在驱动的数据线
+ * @param       emu: 仿真对象
+ * @param       oe: 输出，芯片驱动的引脚(AD9959_EMU_PIN_SDIO0或AD9959_EMU_PIN_SDIO2)，0表示不驱动
+ * @retval      驱动为高的引脚
+ * @note        读指令之后的数据阶段芯片在SCLK下降沿输出下一位：2线模式由SDIO_0输出，3线模式由SDIO_2输出；
+ *              通道寄存器读取CSR选中的编号最小的通道，读到的是I/O缓冲的内容
+ */
+uint32_t ad9959_emu_output(const ad9959_emu_t *emu, uint32_t *oe);
+
+/**
+ * @brief       IO_update：把I/O缓冲复制到生效寄存器
+ * @param       emu: 仿真对象
+ * @retval      无
+ */
+void ad9959_emu_io_update(ad9959_emu_t *emu);
+
+/**
+ * @brief       读取寄存器
+ * @param       emu: 仿真对象
+ * @param       ch: 通道(全局寄存器忽略)
+ * @param       reg: 寄存器地址
+ * @param       active: 1读生效值，0读I/O缓冲
+ * @retval      寄存器值(高字节在前拼接)
+ */
+uint32_t ad9959_emu_reg(const ad9959_emu_t *emu, uint8_t ch, uint8_t reg, uint8_t active);
+
+/**
+ * @brief       查询通道当前的调制符号
+ * @param       emu: 仿真对象
+ * @param       ch: 通道
+ * @retval      符号(0-15)，0表示使用CFTW0/CPOW0/ACR
+ * @note        按FR1[9:8]调制级数、FR1[14:12]引脚分配和P0-P3电平计算；CFR[23:22]为0时始终为0
+ */
+uint8_t ad9959_emu_symbol(const ad9959_emu_t *emu, uint8_t ch);
+
+/**
+ * @brief       推进时间，运行线性扫频
+ * @param       emu: 仿真对象
+ * @param       cycles: SYNC_CLK(系统时钟/4)周期数
+ * @retval      无
+ * @note        CFR[14]置位且CFR[23:22]为频率时扫频：通道的Profile引脚为高时每RSRR个周期加RDW直到CW1，
+ *              为低时每FSRR个周期减FDW直到CFTW0；扫频使能后的第一次IO_update把累加器置为CFTW0
+ */
+void ad9959_emu_run(ad9959_emu_t *emu, uint32_t cycles);
+
+/**
+ * @brief       查询通道当前输出的频率控制字
+ * @param       emu: 仿真对象
+ * @param       ch: 通道
+ * @retval      扫频时为扫描累加器，调制时为当前符号的CWn，否则为CFTW0
+ */
+uint32_t ad9959_emu_ftw(const ad9959_emu_t *emu, uint8_t ch);
+
+/**
+ * @brief       生成输出波形
+ * @param       emu: 仿真对象
+ * @param       ch: 通道
+ * @param       out: 输出采样，范围[-1, 1]
+ * @param       n: 采样点数
+ * @param       step: 每个采样点推进的系统时钟周期数(1为全速率)
+ * @retval      无
+ * @note        单频模式：相位累加器按CFTW0累加，加上CPOW0偏移后取正弦，
+ *              ACR使能幅度乘法器时按ASF缩放；
+ *              调制模式按当前Profile引脚选择的符号用CWn替换频率/相位/幅度；
+ *              扫频模式使用扫描累加器的当前值，渲染期间不推进扫频(由ad9959_emu_run()推进)
+ */
+void ad9959_emu_render(ad9959_emu_t *emu, uint8_t ch, float *out, uint32_t n, uint32_t step);
+
+/**
+ * @brief       清零统计计数
+ * @param       emu: 仿真对象
+ * @retval      无
+ */
+void ad9959_emu_clear_stats(ad9959_emu_t *emu);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //AD9959_EMU_H
@@ -0,0 +1,362 @@
+#include "myad9959.h"
+
+#include <string.h>
+#include <time.h>
+
+/**
+ ****************************************************************************************************
+ * @file        ad9959_host.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       驱动主机构建的替身HAL
+ *              GPIO端口用输出数据寄存器副本模拟，SPI发送直接交给仿真芯片，GPIO和SPI读取返回仿真芯片的输出，
+ *              DMA发送同步完成并调用完成回调，因此事务队列在主机上按顺序立即执行
+ ****************************************************************************************************
+ */
+
+ad9959_emu_t ad9959_host_emu;
+volatile uint8_t ad9959_host_in_isr;
+uint32_t ad9959_host_update_time;
+uint32_t ad9959_host_dma_fail;
+uint32_t ad9959_host_contention;
+void (*ad9959_host_pin_hook)(uint32_t pins, uint32_t changed);
+
+SPI_HandleTypeDef hspi2;
+SPI_HandleTypeDef hspi3;
+
+/* AD9959各信号所在的端口、引脚及对应的仿真引脚位 */
+typedef struct
+{
+	const void *port;
+	uint16_t    pin;
+	uint32_t    emu_pin;
+} ad9959_host_line_t;
+
+static const ad9959_host_line_t ad9959_host_lines[] =
+{
+	{AD9959_CLK_GPIO_Port, AD9959_CLK_Pin, AD9959_EMU_PIN_CLK},
+	{AD9959_SD0_GPIO_Port, AD9959_SD0_Pin, AD9959_EMU_PIN_SDIO0},
+	{AD9959_SD1_GPIO_Port, AD9959_SD1_Pin, AD9959_EMU_PIN_SDIO1},
+	{AD9959_SD2_GPIO_Port, AD9959_SD2_Pin, AD9959_EMU_PIN_SDIO2},
+	{AD9959_SD3_GPIO_Port, AD9959_SD3_Pin, AD9959_EMU_PIN_SDIO3},
+	{AD9959_UD_GPIO_Port,  AD9959_UD_Pin,  AD9959_EMU_PIN_UD},
+	{AD9959_RST_GPIO_Port, AD9959_RST_Pin, AD9959_EMU_PIN_RST},
+	{AD9959_PDC_GPIO_Port, AD9959_PDC_Pin, AD9959_EMU_PIN_PDC},
+	{AD9959_PROFILE_GPIO_Port, 1U << (AD9959_PROFILE_PIN_SHIFT + 0), AD9959_EMU_PIN_P0},
+	{AD9959_PROFILE_GPIO_Port, 1U << (AD9959_PROFILE_PIN_SHIFT + 1), AD9959_EMU_PIN_P1},
+	{AD9959_PROFILE_GPIO_Port, 1U << (AD9959_PROFILE_PIN_SHIFT + 2), AD9959_EMU_PIN_P2},
+	{AD9959_PROFILE_GPIO_Port, 1U << (AD9959_PROFILE_PIN_SHIFT + 3), AD9959_EMU_PIN_P3},
+};
+
+#define AD9959_HOST_LINES	(sizeof(ad9959_host_lines) / sizeof(ad9959_host_lines[0]))
+#define AD9959_HOST_PORTS	8
+#define AD9959_HOST_CHIPS	8
+
+/* 端口输出数据寄存器副本和输入模式的引脚 */
+typedef struct
+{
+	const void *port;
+	uint32_t    odr;
+	uint32_t    input;		/* HAL_GPIO_Init()配置为输入的引脚，不驱动信号 */
+} ad9959_host_port_t;
+
+static ad9959_host_port_t ad9959_host_ports[AD9959_HOST_PORTS];
+
+/* 上一次写入后的共用信号电平，用于ad9959_host_pin_hook */
+static uint32_t ad9959_host_pins;
+
+/**
+ * @brief       查找(或分配)端口的副本
+ */
+static ad9959_host_port_t *ad9959_host_port(const void *port)
+{
+	uint8_t i;
+
+	for(i = 0; i < AD9959_HOST_PORTS; i++)
+	{
+		if(ad9959_host_ports[i].port == port)
+			return &ad9959_host_ports[i];
+		if(ad9959_host_ports[i].port == NULL)
+		{
+			ad9959_host_ports[i].port = port;
+			return &ad9959_host_ports[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief       查找(或分配)端口的ODR副本
+ */
+static uint32_t *ad9959_host_odr(const void *port)
+{
+	ad9959_host_port_t *p = ad9959_host_port(port);
+
+	return p != NULL ? &p->odr : NULL;
+}
+
+/* 总线上的仿真芯片，除片选外共用所有信号 */
+static struct
+{
+	ad9959_emu_t *emu;
+	const void   *cs_port;
+	uint16_t      cs_pin;
+	uint64_t      cycles;		/* 已推进的SYNC_CLK周期数 */
+} ad9959_host_chips[AD9959_HOST_CHIPS];
+
+static uint8_t ad9959_host_nchips;
+
+/* 仿真芯片时间：已推进的纳秒数 */
+static struct
+{
+	uint32_t last;
+	uint64_t ns;
+} ad9959_host_time;
+
+/**
+ * @brief       初始化替身HAL和仿真芯片
+ * @param       无
+ * @retval      无
+ */
+void ad9959_host_init(void)
+{
+	memset(ad9959_host_ports, 0, sizeof(ad9959_host_ports));
+	memset(&ad9959_host_time, 0, sizeof(ad9959_host_time));
+	memset(ad9959_host_chips, 0, sizeof(ad9959_host_chips));
+	ad9959_host_time.last = ad9959_host_now();
+	ad9959_host_nchips = 0;
+	ad9959_host_attach(&ad9959_host_emu, AD9959_CS_GPIO_Port, AD9959_CS_Pin, AD9959_System_Clk);
+}
+
+/**
+ * @brief       在总线上增加一片仿真芯片
+ * @param       emu: 仿真对象
+ * @param       cs_port: 片选端口
+ * @param       cs_pin: 片选引脚
+ * @param       sys_clk: 系统时钟(Hz)
+ * @retval      0: 成功  1: 芯片数已满
+ */
+uint8_t ad9959_host_attach(ad9959_emu_t *emu, const void *cs_port, uint16_t cs_pin, uint32_t sys_clk)
+{
+	if(ad9959_host_nchips >= AD9959_HOST_CHIPS)
+		return 1;
+
+	ad9959_host_sync();
+	ad9959_emu_init(emu, sys_clk);
+	ad9959_host_chips[ad9959_host_nchips].emu = emu;
+	ad9959_host_chips[ad9959_host_nchips].cs_port = cs_port;
+	ad9959_host_chips[ad9959_host_nchips].cs_pin = cs_pin;
+	ad9959_host_chips[ad9959_host_nchips].cycles = 0;
+	ad9959_host_nchips++;
+	ad9959_host_bsrr(cs_port, cs_pin);		// 片选拉高
+	return 0;
+}
+
+/**
+ * @brief       把仿真芯片的时间推进到当前时刻
+ * @param       无
+ * @retval      无
+ */
+void ad9959_host_sync(void)
+{
+	uint32_t now = ad9959_host_now();
+	uint64_t cycles;
+	uint8_t i;
+
+	ad9959_host_time.ns += now - ad9959_host_time.last;
+	ad9959_host_time.last = now;
+	for(i = 0; i < ad9959_host_nchips; i++)
+	{
+		cycles = ad9959_host_time.ns * (ad9959_host_chips[i].emu->sys_clk / 4) / 1000000000ULL;
+		ad9959_emu_run(ad9959_host_chips[i].emu, (uint32_t)(cycles - ad9959_host_chips[i].cycles));
+		ad9959_host_chips[i].cycles = cycles;
+	}
+}
+
+/**
+ * @brief       GPIO BSRR写入
+ * @param       port: GPIO端口
+ * @param       word: BSRR值
+ * @retval      无
+ * @note        与硬件一致，同一位同时置位和复位时置位优先
+ */
+void ad9959_host_bsrr(const void *port, uint32_t word)
+{
+	uint32_t *odr = ad9959_host_odr(port);
+	ad9959_host_port_t *p;
+	uint32_t pins = 0, changed;
+	uint8_t i;
+
+	if(odr == NULL)
+		return;
+	ad9959_host_sync();
+	if(odr == ad9959_host_odr(AD9959_UD_GPIO_Port) && !(*odr & AD9959_UD_Pin) && (word & AD9959_UD_Pin))
+		ad9959_host_update_time = ad9959_host_now();		// IO_update上升沿
+	*odr = (*odr & ~(word >> 16)) | (word & 0xFFFF);
+
+	/* 配置为输入的引脚不驱动信号，按低电平给仿真芯片 */
+	for(i = 0; i < AD9959_HOST_LINES; i++)
+	{
+		p = ad9959_host_port(ad9959_host_lines[i].port);
+		if(p != NULL && (p->odr & ~p->input & ad9959_host_lines[i].pin))
+			pins |= ad9959_host_lines[i].emu_pin;
+	}
+
+	/* 共用信号加上各自的片选 */
+	for(i = 0; i < ad9959_host_nchips; i++)
+	{
+		odr = ad9959_host_odr(ad9959_host_chips[i].cs_port);
+		ad9959_emu_pins(ad9959_host_chips[i].emu,
+						(odr != NULL && (*odr & ad9959_host_chips[i].cs_pin)) ? (pins | AD9959_EMU_PIN_CS) : pins);
+	}
+
+	changed = ad9959_host_pins ^ pins;
+	ad9959_host_pins = pins;
+	if(ad9959_host_pin_hook != NULL && changed != 0)
+		ad9959_host_pin_hook(pins, changed);
+}
+
+/**
+ * @brief       SPI数据送给片选为低的芯片
+ */
+static void ad9959_host_spi(const uint8_t *buf, uint16_t len)
+{
+	uint8_t i;
+
+	ad9959_host_sync();
+	for(i = 0; i < ad9959_host_nchips; i++)
+	{
+		if(!(ad9959_host_chips[i].emu->pins & AD9959_EMU_PIN_CS))
+			ad9959_emu_spi(ad9959_host_chips[i].emu, buf, len);
+	}
+}
+
+/**
+ * @brief       SPI收发，接收芯片在line上输出的数据
+ */
+static void ad9959_host_xfer(const uint8_t *tx, uint8_t *rx, uint16_t len, uint32_t line)
+{
+	uint16_t k;
+	uint8_t i, v;
+
+	ad9959_host_sync();
+	for(k = 0; k < len; k++)
+	{
+		rx[k] = 0xFF;		// 没有芯片驱动时为上拉电平
+		for(i = 0; i < ad9959_host_nchips; i++)
+		{
+			if(!(ad9959_host_chips[i].emu->pins & AD9959_EMU_PIN_CS))
+			{
+				ad9959_emu_spi_xfer(ad9959_host_chips[i].emu, &tx[k], &v, 1, line);
+				rx[k] &= v;
+			}
+		}
+	}
+}
+
+/**
+ * @brief       GPIO输入
+ * @param       port: GPIO端口
+ * @param       pin: 引脚
+ * @retval      芯片驱动该引脚时为芯片的输出，否则为输出数据寄存器的值
+ * @note        芯片驱动的引脚仍配置为输出时两边冲突，计入ad9959_host_contention，读到的是输出数据寄存器的值
+ */
+uint8_t ad9959_host_read(const void *port, uint16_t pin)
+{
+	ad9959_host_port_t *p = ad9959_host_port(port);
+	uint32_t out, oe;
+	uint8_t i, k;
+
+	ad9959_host_sync();
+	for(i = 0; i < AD9959_HOST_LINES; i++)
+	{
+		if(ad9959_host_lines[i].port != port || !(ad9959_host_lines[i].pin & pin))
+			continue;
+		for(k = 0; k < ad9959_host_nchips; k++)
+		{
+			out = ad9959_emu_output(ad9959_host_chips[k].emu, &oe);
+			if(!(oe & ad9959_host_lines[i].emu_pin))
+				continue;
+			if(p != NULL && (p->input & pin))
+				return (out & ad9959_host_lines[i].emu_pin) != 0;
+			ad9959_host_contention++;
+		}
+	}
+	return (p != NULL && (p->odr & pin)) ? 1 : 0;
+}
+
+/* 只记录引脚是否为输入，其它配置由仿真模型忽略 */
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, const GPIO_InitTypeDef *GPIO_Init)
+{
+	ad9959_host_port_t *p = ad9959_host_port(GPIOx);
+
+	if(p == NULL)
+		return;
+	if(GPIO_Init->Mode == GPIO_MODE_INPUT)
+		p->input |= GPIO_Init->Pin;
+	else
+		p->input &= ~GPIO_Init->Pin;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, const uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	(void)hspi;
+	(void)Timeout;
+	ad9959_host_spi(pData, Size);
+	return HAL_OK;
+}
+
+/* 接收：半双工时数据线为MOSI所接的SDIO_0，全双工时为MISO所接的SDIO_2 */
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	uint32_t line = (hspi->Init.Direction == SPI_DIRECTION_1LINE) ? AD9959_EMU_PIN_SDIO0 : AD9959_EMU_PIN_SDIO2;
+	uint16_t k;
+	uint8_t dummy = 0;
+
+	(void)Timeout;
+	for(k = 0; k < Size; k++)
+		ad9959_host_xfer(&dummy, &pData[k], 1, line);
+	return HAL_OK;
+}
+
+/* 全双工：MISO接SDIO_2 */
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, const uint8_t *pTxData, uint8_t *pRxData,
+										  uint16_t Size, uint32_t Timeout)
+{
+	(void)hspi;
+	(void)Timeout;
+	ad9959_host_xfer(pTxData, pRxData, Size, AD9959_EMU_PIN_SDIO2);
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, const uint8_t *pData, uint16_t Size)
+{
+	uint32_t fail = ad9959_host_dma_fail & 1;
+
+	ad9959_host_dma_fail >>= 1;
+	if(fail)
+		return HAL_ERROR;
+	ad9959_host_spi(pData, Size);
+	HAL_SPI_TxCpltCallback(hspi);
+	return HAL_OK;
+}
+
+/* 与HAL一致的弱定义，未启用DMA队列时使用 */
+__attribute__((weak)) void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+	(void)hspi;
+}
+
+/**
+ * @brief       主机时钟
+ * @param       无
+ * @retval      纳秒
+ * @note        使用本线程的CPU时间：进程被抢占时时间不前进，仿真芯片和定时测试不受主机负载影响
+ */
+uint32_t ad9959_host_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
@@ -0,0 +1,118 @@
+#ifndef AD9959_HOST_H
+#define AD9959_HOST_H
+
+#include <stdint.h>
+
+#include "ad9959_emu.h"
+
+/**
+ ****************************************************************************************************
+ * @file        ad9959_host.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       驱动主机构建的替身HAL
+ *              主机构建时用-include强制包含本文件，驱动的GPIO和SPI操作全部转给仿真芯片ad9959_host_emu，
+ *              多器件时再用ad9959_host_attach()增加按片选区分的仿真芯片
+ ****************************************************************************************************
+ */
+
+/* 驱动的引脚写入转给仿真模型，不访问真实的GPIO寄存器 */
+#define AD9959_BSRR_WRITE(port, word)	ad9959_host_bsrr((const void *)(port), (uint32_t)(word))
+/* 引脚读取返回仿真芯片驱动的电平(寄存器回读) */
+#define AD9959_PIN_READ(port, pin)		ad9959_host_read((const void *)(port), (uint16_t)(pin))
+
+/* 主机上没有PRIMASK，DMA完成回调在发送函数中同步执行，不需要临界区 */
+#define AD9959_QUEUE_LOCK()
+#define AD9959_QUEUE_UNLOCK()
+/* ad9959_host_in_isr非0时模拟在中断中调用(队列满时不等待) */
+#define AD9959_QUEUE_IN_ISR()	(ad9959_host_in_isr != 0)
+
+/* 时间基准(延时和性能统计)使用本线程的CPU时间，单位纳秒 */
+#define AD9959_TIMER_NOW()		ad9959_host_now()
+#define AD9959_TIMER_HZ			1000000000UL
+#define AD9959_TIMER_INIT()		do { } while(0)
+
+/* Profile引脚不需要开时钟 */
+#define AD9959_PROFILE_CLK_ENABLE()	do { } while(0)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 与驱动相连的仿真芯片 */
+extern ad9959_emu_t ad9959_host_emu;
+
+/* 非0时驱动认为当前在中断中执行 */
+extern volatile uint8_t ad9959_host_in_isr;
+
+/* 最近一次IO_update上升沿的时刻(ad9959_host_now()) */
+extern uint32_t ad9959_host_update_time;
+
+/* 模拟DMA启动失败：每次HAL_SPI_Transmit_DMA()取出最低位后右移，该位为1时不发送并返回HAL_ERROR */
+extern uint32_t ad9959_host_dma_fail;
+
+/* 芯片输出读取数据时MCU的该引脚仍为输出(两边同时驱动)的次数，ad9959_host_read()中统计 */
+extern uint32_t ad9959_host_contention;
+
+/* 非NULL时每次引脚写入后调用：默认仿真芯片的引脚电平(AD9959_EMU_PIN_xx，不含片选)和本次改变的引脚 */
+extern void (*ad9959_host_pin_hook)(uint32_t pins, uint32_t changed);
+
+/**
+ * @brief       初始化替身HAL和仿真芯片
+ * @param       无
+ * @retval      无
+ * @note        在ad9959_init()之前调用
+ */
+void ad9959_host_init(void);
+
+/**
+ * @brief       在总线上增加一片仿真芯片
+ * @param       emu: 仿真对象
+ * @param       cs_port: 片选端口
+ * @param       cs_pin: 片选引脚
+ * @param       sys_clk: 系统时钟(Hz)
+ * @retval      0: 成功  1: 芯片数已满(最多8片)
+ * @note        在ad9959_host_init()之后调用，新芯片与ad9959_host_emu共用除片选外的所有信号，
+ *              对应驱动中用ad9959_dev_init()初始化的器件
+ */
+uint8_t ad9959_host_attach(ad9959_emu_t *emu, const void *cs_port, uint16_t cs_pin, uint32_t sys_clk);
+
+/**
+ * @brief       GPIO BSRR写入
+ * @param       port: GPIO端口
+ * @param       word: BSRR值，低16位置位，高16位复位
+ * @retval      无
+ */
+void ad9959_host_bsrr(const void *port, uint32_t word);
+
+/**
+ * @brief       GPIO输入
+ * @param       port: GPIO端口
+ * @param       pin: 引脚
+ * @retval      引脚电平
+ * @note        片选为低的仿真芯片正在输出读取数据、且该引脚已用HAL_GPIO_Init()配置为输入时返回芯片驱动的电平，
+ *              否则返回最后写入的输出电平；配置为输入的引脚在ad9959_host_bsrr()中不驱动信号
+ */
+uint8_t ad9959_host_read(const void *port, uint16_t pin);
+
+/**
+ * @brief       把仿真芯片的时间推进到当前时刻
+ * @param       无
+ * @retval      无
+ * @note        引脚和SPI操作前自动调用，使仿真芯片的扫频与主机时钟同步；读取扫频状态前也可以手动调用
+ */
+void ad9959_host_sync(void);
+
+/**
+ * @brief       主机时钟
+ * @param       无
+ * @retval      纳秒，32位回绕
+ * @note        本线程的CPU时间，进程被抢占时不前进
+ */
+uint32_t ad9959_host_now(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //AD9959_HOST_H
@@ -0,0 +1,26 @@
+#ifndef __SPI_H__
+#define __SPI_H__
+
+/**
+ ****************************************************************************************************
+ * @file        spi.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机构建用的spi.h，代替CubeMX生成的同名文件，句柄由ad9959_host.c定义
+ ****************************************************************************************************
+ */
+
+#include "main.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern SPI_HandleTypeDef hspi2;
+extern SPI_HandleTypeDef hspi3;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__SPI_H__
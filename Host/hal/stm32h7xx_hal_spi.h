@@ -0,0 +1,48 @@
+#ifndef STM32H7XX_HAL_SPI_H
+#define STM32H7XX_HAL_SPI_H
+
+/**
+ ****************************************************************************************************
+ * @file        stm32h7xx_hal_spi.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机构建用的最小SPI HAL头文件
+ *              仓库中的HAL驱动没有SPI模块，主机构建时代替CubeMX生成的同名文件，
+ *              只包含驱动用到的类型和函数，函数由ad9959_host.c实现
+ ****************************************************************************************************
+ */
+
+#include "stm32h7xx_hal_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SPI_DIRECTION_2LINES		(0x00000000UL)
+#define SPI_DIRECTION_1LINE			(0x00180000UL)
+
+typedef struct
+{
+	uint32_t Direction;				/* 全双工或半双工 */
+} SPI_InitTypeDef;
+
+typedef struct __SPI_HandleTypeDef
+{
+	void              *Instance;
+	SPI_InitTypeDef    Init;
+	DMA_HandleTypeDef *hdmatx;
+	DMA_HandleTypeDef *hdmarx;
+} SPI_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, const uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, const uint8_t *pTxData, uint8_t *pRxData,
+										  uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, const uint8_t *pData, uint16_t Size);
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //STM32H7XX_HAL_SPI_H
@@ -0,0 +1,53 @@
+#ifndef AD9959_TEST_H
+#define AD9959_TEST_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+/**
+ ****************************************************************************************************
+ * @file        ad9959_test.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机测试的断言宏和性能测试计时
+ *              每个测试程序用TEST_CHECK检查条件，失败时打印位置并计数，main返回TEST_RESULT()
+ ****************************************************************************************************
+ */
+
+static unsigned test_failures;
+static unsigned test_checks;
+
+/* 检查条件，失败时打印格式化的说明 */
+#define TEST_CHECK(cond, ...)	do { test_checks++; if(!(cond)) { test_failures++; \
+									printf("%s:%d: 失败: %s: ", __FILE__, __LINE__, #cond); \
+									printf(__VA_ARGS__); printf("\n"); } } while(0)
+
+/* 检查两个整数相等 */
+#define TEST_EQ(a, b)			do { unsigned long long test_a_ = (unsigned long long)(a); \
+									unsigned long long test_b_ = (unsigned long long)(b); \
+									TEST_CHECK(test_a_ == test_b_, "%s=0x%llx %s=0x%llx", #a, test_a_, #b, test_b_); } while(0)
+
+/* 打印结果，返回值用作main的退出码 */
+#define TEST_RESULT()			(printf("%s: %u项检查，%u项失败\n", __FILE__, test_checks, test_failures), \
+								 test_failures != 0)
+
+/* 性能测试计时：x86返回TSC周期，其他平台返回ns */
+#if defined(__x86_64__) || defined(__i386__)
+#define TEST_TICK_UNIT			"周期"
+static inline uint64_t test_ticks(void)
+{
+	return __builtin_ia32_rdtsc();		// x86intrin.h与CMSIS的__I/__O宏冲突，直接用内建函数
+}
+#else
+#define TEST_TICK_UNIT			"ns"
+static inline uint64_t test_ticks(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+#endif //AD9959_TEST_H
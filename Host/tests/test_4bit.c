@@ -0,0 +1,79 @@
+#include <string.h>
+#include "myad9959.h"
+#include "ad9959_test.h"
+
+/**
+ ****************************************************************************************************
+ * @file        test_4bit.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       4位串行模式测试：仿真芯片按引脚电平解码出的字节与驱动发送的帧逐字节相同
+ *              每个数据字节高低半字节不同，半字节顺序或数据线顺序错误都会被发现
+ ****************************************************************************************************
+ */
+
+int main(void)
+{
+	static const uint8_t frame[] =
+	{
+		0x00, 0x20 | AD9959_CSR_MODE_4BIT,		// CSR：选中通道1，保持4位模式
+		CFTW0, 0x12, 0x34, 0xA5, 0x0F,
+		CPOW0, 0x3C, 0xC3 & 0x3F,
+	};
+	const uint16_t sd_pin[4] = {0x0001, 0x0010, 0x0100, 0x1000};
+	uint32_t table[16];
+	uint8_t log[64];
+	uint32_t sclk, n, k;
+
+	/* 半字节表：第n位输出到SDIO_n，同时拉低时钟 */
+	ad9959_nibble_bsrr_table(table, sd_pin, 0x0002);
+	for(n = 0; n < 16; n++)
+	{
+		uint32_t set = 0, reset = 0x0002;
+
+		for(k = 0; k < 4; k++)
+		{
+			if(n & (1U << k))
+				set |= sd_pin[k];
+			else
+				reset |= sd_pin[k];
+		}
+		TEST_CHECK(table[n] == (set | (reset << 16)), "nibble=%u table=0x%08x", (unsigned)n, (unsigned)table[n]);
+	}
+
+	ad9959_host_init();
+	ad9959_init();
+	TEST_EQ(ad9959_host_emu.mode, AD9959_CSR_MODE_4BIT);
+
+	/* 原始帧：每字节2个SCLK，解码结果与输入相同 */
+	ad9959_host_emu.log = log;
+	ad9959_host_emu.log_size = sizeof(log);
+	ad9959_host_emu.log_len = 0;
+	sclk = ad9959_host_emu.stats.sclk;
+	AD9959_WriteFrame(frame, sizeof(frame));
+	TEST_EQ(ad9959_host_emu.log_len, sizeof(frame));
+	TEST_EQ(ad9959_host_emu.stats.sclk - sclk, 2 * sizeof(frame));
+	for(n = 0; n < sizeof(frame) && n < ad9959_host_emu.log_len; n++)
+		TEST_CHECK(log[n] == frame[n], "byte %u: 0x%02x != 0x%02x", (unsigned)n, log[n], frame[n]);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, CFTW0, 0), 0x1234A50F);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, CPOW0, 0), 0x3C03);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 0, CSR, 0) & AD9959_CSR_MODE_MASK, AD9959_CSR_MODE_4BIT);
+
+	/* 驱动API生成的帧：其中包含CFTW0指令和频率字 */
+	ad9959_shadow_invalidate();
+	ad9959_host_emu.log_len = 0;
+	ad9959_set_signal_out(2, 1000000, 0, 1023);
+	{
+		static const uint8_t ftw[5] = {CFTW0, 0x00, 0x83, 0x12, 0x6F};
+		uint8_t found = 0;
+
+		for(n = 0; n + 5 <= ad9959_host_emu.log_len; n++)
+			if(memcmp(&log[n], ftw, 5) == 0)
+				found = 1;
+		TEST_CHECK(found, "log_len=%u", (unsigned)ad9959_host_emu.log_len);
+	}
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 2, CFTW0, 1), 0x0083126F);
+
+	ad9959_host_emu.log = NULL;
+	return TEST_RESULT();
+}
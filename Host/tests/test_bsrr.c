@@ -0,0 +1,78 @@
+#include "myad9959.h"
+#include "ad9959_test.h"
+
+/**
+ ****************************************************************************************************
+ * @file        test_bsrr.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       软件SPI BSRR表测试：把表中的字依次写入模拟的输出寄存器，在时钟上升沿采样SD0，
+ *              还原出的字节与输入相同；再用驱动发送覆盖0x00-0xFF的帧，仿真芯片逐字节解码比较
+ ****************************************************************************************************
+ */
+
+#define SD0		0x2000
+#define CLK		0x0004
+
+/* 按BSRR语义写入：高16位清零，低16位置位，置位优先 */
+static uint32_t bsrr(uint32_t odr, uint32_t word)
+{
+	odr &= ~(word >> 16);
+	return odr | (word & 0xFFFF);
+}
+
+int main(void)
+{
+	uint32_t out[8];
+	uint8_t frame[64 * 5], log[sizeof(frame)];
+	uint32_t v, i, odr, sclk, bad;
+
+	/* 每个字拉低时钟并设置数据，随后单独拉高时钟，采样得到原字节 */
+	bad = 0;
+	odr = CLK | SD0;
+	for(v = 0; v < 256; v++)
+	{
+		uint8_t byte = 0;
+
+		ad9959_byte_bsrr_table(out, (uint8_t)v, SD0, CLK);
+		for(i = 0; i < 8; i++)
+		{
+			odr = bsrr(odr, out[i]);
+			if(odr & CLK)
+				bad++;
+			odr = bsrr(odr, CLK);
+			byte = (uint8_t)((byte << 1) | ((odr & SD0) ? 1 : 0));
+			if((out[i] & 0xFFFF & ~SD0) || ((out[i] >> 16) & ~(SD0 | CLK)))
+				bad++;						// 不能改变其他引脚
+		}
+		TEST_CHECK(byte == v, "value=0x%02x decoded=0x%02x", (unsigned)v, byte);
+	}
+	TEST_EQ(bad, 0);
+
+	/* 驱动软件SPI：64次CFTW0写入覆盖全部256个字节值 */
+	for(i = 0; i < 64; i++)
+	{
+		frame[i * 5] = CFTW0;
+		for(v = 0; v < 4; v++)
+			frame[i * 5 + 1 + v] = (uint8_t)(i * 4 + v);
+	}
+
+	ad9959_host_init();
+	ad9959_init();
+	ad9959_host_emu.log = log;
+	ad9959_host_emu.log_size = sizeof(log);
+	ad9959_host_emu.log_len = 0;
+	sclk = ad9959_host_emu.stats.sclk;
+	AD9959_WriteFrame(frame, sizeof(frame));
+	TEST_EQ(ad9959_host_emu.log_len, sizeof(frame));
+	TEST_EQ(ad9959_host_emu.stats.sclk - sclk, 8 * sizeof(frame));
+	bad = 0;
+	for(i = 0; i < sizeof(frame) && i < ad9959_host_emu.log_len; i++)
+		if(log[i] != frame[i])
+			bad++;
+	TEST_EQ(bad, 0);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 0, CFTW0, 0), 0xFCFDFEFF);
+
+	ad9959_host_emu.log = NULL;
+	return TEST_RESULT();
+}
@@ -0,0 +1,225 @@
+#include "myad9959.h"
+#include "myad9959_bus.h"
+#include "spi.h"
+#include "ad9959_test.h"
+
+/**
+ ****************************************************************************************************
+ * @file        test_bus.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       多总线并行发送测试：四片仿真芯片分在两个SPI外设上，一次ad9959_bus_update()后全部生效；
+ *              某个器件的帧启动DMA失败时返回2、该器件不变，下一次更新只重发它的寄存器；
+ *              ad9959_bus_balance()的最忙总线字节数等于独立穷举的最优值，每条总线不超过AD9959_BUS_DEVS个器件
+ ****************************************************************************************************
+ */
+
+#define DEVS		4
+#define RUNS		2000
+
+static ad9959_emu_t emu[DEVS - 1];
+static ad9959_dev_t dev[DEVS - 1];
+
+/* 器件d通道ch的频率(0.001Hz)，round区分两次设置 */
+static uint64_t fre_of(uint8_t d, uint8_t ch, uint8_t round)
+{
+	return 1000000000ULL * (1 + d) + 100000000ULL * ch + 7000000ULL * round;
+}
+
+/* 给每个器件写入本轮的频率，只写影子寄存器 */
+static void load(ad9959_dev_t *const *devs, uint8_t round)
+{
+	ad9959_channel_cfg_t cfg[AD9959_CH_COUNT];
+	ad9959_dev_t *prev;
+	uint8_t d, ch;
+
+	for(d = 0; d < DEVS; d++)
+	{
+		for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+		{
+			cfg[ch].ch = ch;
+			cfg[ch].phase = 0;
+			cfg[ch].amp = 1023;
+			cfg[ch].fre_mhz = fre_of(d, ch, round);
+		}
+		prev = ad9959_dev_select(devs[d]);
+		ad9959_load_all(cfg, AD9959_CH_COUNT);
+		ad9959_dev_select(prev);
+	}
+}
+
+/* 器件d的四个通道是否都是第round轮的频率 */
+static uint8_t has_round(ad9959_emu_t *e, uint8_t d, uint8_t round)
+{
+	uint8_t ch;
+
+	for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+	{
+		if(ad9959_emu_reg(e, ch, CFTW0, 1) != ad9959_ftw_from_millihz(fre_of(d, ch, round)))
+			return 0;
+	}
+	return 1;
+}
+
+/* 穷举所有分配(每条总线不超过AD9959_BUS_DEVS个器件)的最忙总线字节数最小值 */
+static uint32_t best_makespan(const uint16_t *bytes, uint8_t count, uint8_t nbus)
+{
+	uint32_t load[AD9959_BUS_MAX], num[AD9959_BUS_MAX], best = UINT32_MAX, span, code, total = 1, c;
+	uint8_t i;
+
+	for(i = 0; i < count; i++)
+		total *= nbus;
+	for(code = 0; code < total; code++)
+	{
+		for(i = 0; i < nbus; i++)
+			load[i] = num[i] = 0;
+		for(i = 0, c = code; i < count; i++, c /= nbus)
+		{
+			load[c % nbus] += bytes[i];
+			num[c % nbus]++;
+		}
+		span = 0;
+		for(i = 0; i < nbus; i++)
+		{
+			if(num[i] > AD9959_BUS_DEVS)
+				span = UINT32_MAX;
+			else if(load[i] > span)
+				span = load[i];
+		}
+		if(span < best)
+			best = span;
+	}
+	return best;
+}
+
+int main(void)
+{
+	ad9959_dev_t *devs[DEVS] = {&ad9959_dev_default, &dev[0], &dev[1], &dev[2]};
+	ad9959_emu_t *emus[DEVS] = {&ad9959_host_emu, &emu[0], &emu[1], &emu[2]};
+	uint32_t frames[DEVS];
+	uint8_t d;
+
+	ad9959_host_init();
+	ad9959_init();
+	/* 默认器件和dev[0]在SPI3上，dev[1]、dev[2]在SPI2上 */
+	for(d = 0; d < DEVS - 1; d++)
+	{
+		TEST_EQ(ad9959_host_attach(&emu[d], GPIOC, (uint16_t)(GPIO_PIN_7 << d), AD9959_System_Clk), 0);
+		ad9959_dev_init(&dev[d], GPIOC, (uint16_t)(GPIO_PIN_7 << d), d == 0 ? &hspi3 : &hspi2, AD9959_System_Clk);
+	}
+
+	/* 全部器件同一个IO_update生效 */
+	load(devs, 0);
+#ifdef AD9959_USE_SPI_DMA
+	TEST_EQ(ad9959_bus_update(devs, DEVS), 0);
+#else
+	TEST_EQ(ad9959_bus_update(devs, DEVS), 1);		// 阻塞SPI按顺序发送
+#endif
+	for(d = 0; d < DEVS; d++)
+		TEST_CHECK(has_round(emus[d], d, 0), "dev%u", d);
+
+#ifdef AD9959_USE_SPI_DMA
+	/* SPI3上第二个器件(dev[0])的DMA启动失败：其余器件更新，它保持上一轮 */
+	load(devs, 1);
+	ad9959_host_dma_fail = 0x2;
+	TEST_EQ(ad9959_bus_update(devs, DEVS), 2);
+	TEST_EQ(ad9959_host_dma_fail, 0);
+	TEST_CHECK(has_round(emus[0], 0, 1), "dev0");
+	TEST_CHECK(has_round(emus[1], 1, 0), "dev1");
+	TEST_CHECK(has_round(emus[2], 2, 1), "dev2");
+	TEST_CHECK(has_round(emus[3], 3, 1), "dev3");
+
+	/* 下一次更新不需要重新设置，只有失败的器件发送 */
+	for(d = 0; d < DEVS; d++)
+		frames[d] = emus[d]->stats.frames;
+	TEST_EQ(ad9959_bus_update(devs, DEVS), 0);
+	for(d = 0; d < DEVS; d++)
+	{
+		TEST_CHECK(has_round(emus[d], d, 1), "dev%u", d);
+		TEST_EQ(emus[d]->stats.frames - frames[d], d == 1 ? 1 : 0);
+	}
+
+	/* 之后正常更新 */
+	load(devs, 2);
+	TEST_EQ(ad9959_bus_update(devs, DEVS), 0);
+	for(d = 0; d < DEVS; d++)
+		TEST_CHECK(has_round(emus[d], d, 2), "dev%u", d);
+#else
+	(void)frames;
+#endif
+
+	/* 最长处理时间优先得到7的例子：{3,3,2,2,2}在两条总线上最优为6(3+3和2+2+2) */
+	{
+		static const uint16_t bytes[5] = {3, 3, 2, 2, 2};
+		uint8_t bus[5];
+
+		TEST_EQ(ad9959_bus_balance(bytes, 5, 2, bus), 6);
+		TEST_EQ(bus[0], bus[1]);
+		TEST_CHECK(bus[2] != bus[0] && bus[3] == bus[2] && bus[4] == bus[2], "%u %u %u %u %u",
+				   bus[0], bus[1], bus[2], bus[3], bus[4]);
+		TEST_EQ(ad9959_bus_balance(bytes, 5, AD9959_BUS_MAX + 1, bus), 6);	// 按AD9959_BUS_MAX条
+		TEST_EQ(ad9959_bus_balance(bytes, 4, 1, bus), 10);
+		TEST_EQ(ad9959_bus_balance(bytes, 4, 0, bus), 10);					// 按1条总线
+		TEST_EQ(ad9959_bus_balance(bytes, 5, 1, bus), 0);					// 一条总线最多AD9959_BUS_DEVS个
+	}
+
+	/* 每条总线的器件数有上限：{9,1,1,1,1,1}两条总线时9不能和其余五个分开 */
+	{
+		static const uint16_t bytes[6] = {9, 1, 1, 1, 1, 1};
+		uint8_t bus[6], i, n = 0;
+
+		TEST_EQ(ad9959_bus_balance(bytes, 6, 2, bus), 10);
+		for(i = 0; i < 6; i++)
+			n += (bus[i] == bus[0]);
+		TEST_EQ(n, 2);
+	}
+
+	/* 随机例子：分配与返回值一致，等于穷举的最优值 */
+	{
+		uint16_t bytes[AD9959_BUS_MAX * AD9959_BUS_DEVS];
+		uint32_t load[AD9959_BUS_MAX], num[AD9959_BUS_MAX], seed = 12345, span, best, bad = 0, r;
+		uint8_t bus[AD9959_BUS_MAX * AD9959_BUS_DEVS], count, nbus, i;
+
+		for(r = 0; r < RUNS; r++)
+		{
+			seed = seed * 1664525U + 1013904223U;
+			nbus = (uint8_t)(1 + (seed >> 24) % AD9959_BUS_MAX);
+			count = (uint8_t)(1 + (seed >> 28) % (nbus * AD9959_BUS_DEVS));
+			for(i = 0; i < count; i++)
+			{
+				seed = seed * 1664525U + 1013904223U;
+				bytes[i] = (uint16_t)(1 + (seed >> 16) % AD9959_FLUSH_MAX_BYTES);
+			}
+
+			span = ad9959_bus_balance(bytes, count, nbus, bus);
+			best = best_makespan(bytes, count, nbus);
+
+			for(i = 0; i < nbus; i++)
+				load[i] = num[i] = 0;
+			for(i = 0; i < count; i++)
+			{
+				if(bus[i] >= nbus)
+					bad++;
+				else
+				{
+					load[bus[i]] += bytes[i];
+					num[bus[i]]++;
+				}
+			}
+			for(i = 1; i < nbus; i++)
+			{
+				if(load[i] > load[0])
+					load[0] = load[i];
+				if(num[i] > num[0])
+					num[0] = num[i];
+			}
+			if(load[0] != span || num[0] > AD9959_BUS_DEVS)
+				bad++;
+			if(span != best)
+				bad++;
+		}
+		TEST_EQ(bad, 0);
+	}
+
+	return TEST_RESULT();
+}
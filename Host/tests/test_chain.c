@@ -0,0 +1,210 @@
+#include "myad9959.h"
+#include "myad9959_chain.h"
+#include "myad9959_sweep.h"
+#include "ad9959_test.h"
+
+/**
+ ****************************************************************************************************
+ * @file        test_chain.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       分段硬件扫频测试：同方向、换向和保持段组成的扫频链，记录每个IO_update和Profile引脚翻转；
+ *              每次IO_update生效的是按顺序的下一段(向上CW1/RDW/RSRR，向下CFTW0/FDW/FSRR)，保持段不发送；
+ *              同方向的IO_update和换向的引脚翻转在各段实际时长累加的时刻，不随段数漂移；
+ *              ad9959_chain_add_log()各段的请求时长之和等于总时长；仿真芯片最后停在终点
+ ****************************************************************************************************
+ */
+
+#define CH			1
+#define MAX_SEG		32
+#define MAX_EV		64
+#define TOL_NS		5000		/* 切换时刻允许的误差，主机时钟为线程CPU时间 */
+
+/* IO_update上升沿：之后生效的寄存器 */
+typedef struct
+{
+	uint32_t t;					/* ad9959_host_now() */
+	uint32_t cw1, rdw, cftw0, fdw, srr;
+} update_t;
+
+/* 本通道Profile引脚的翻转 */
+typedef struct
+{
+	uint32_t t;
+	uint8_t  up;				/* 翻转后的电平 */
+} edge_t;
+
+static update_t ud[MAX_EV];
+static edge_t pin[MAX_EV];
+static uint32_t nud, npin;
+
+/* 记录IO_update上升沿和本通道Profile引脚的翻转 */
+static void pin_hook(uint32_t pins, uint32_t changed)
+{
+	const uint32_t p = AD9959_EMU_PIN_P0 << CH;
+	uint32_t t = ad9959_host_now();
+
+	if((changed & pins & AD9959_EMU_PIN_UD) && nud < MAX_EV)
+	{
+		ud[nud].t = t;
+		ud[nud].cw1 = ad9959_emu_reg(&ad9959_host_emu, CH, AD9959_CW(1), 1);
+		ud[nud].rdw = ad9959_emu_reg(&ad9959_host_emu, CH, RDW, 1);
+		ud[nud].cftw0 = ad9959_emu_reg(&ad9959_host_emu, CH, CFTW0, 1);
+		ud[nud].fdw = ad9959_emu_reg(&ad9959_host_emu, CH, FDW, 1);
+		ud[nud].srr = ad9959_emu_reg(&ad9959_host_emu, CH, SRR, 1);
+		nud++;
+	}
+	if((changed & p) && npin < MAX_EV)
+	{
+		pin[npin].t = t;
+		pin[npin].up = (pins & p) != 0;
+		npin++;
+	}
+}
+
+/* 第k段开始的时刻：此前各段实际时长之和(ns)，与播放时的取整相同 */
+static uint32_t start_ns(const ad9959_chain_t *c, uint16_t k)
+{
+	uint64_t sync = 0;
+	uint16_t i;
+
+	for(i = 0; i < k; i++)
+		sync += c->seg[i].sync;
+	return (uint32_t)((sync * 1000000000ULL + AD9959_SYNC_CLK - 1) / AD9959_SYNC_CLK);
+}
+
+/* 实际切换时刻与第k段开始时刻的偏差绝对值(ns) */
+static uint32_t skew(uint32_t t, uint32_t t0, const ad9959_chain_t *c, uint16_t k)
+{
+	int32_t e = (int32_t)(t - t0 - start_ns(c, k));
+
+	return (uint32_t)(e < 0 ? -e : e);
+}
+
+int main(void)
+{
+	static ad9959_chain_seg_t seg[MAX_SEG];
+	ad9959_chain_t c;
+	uint32_t total, prev, i, j, bad, t0;
+	uint16_t k, first_log;
+	uint32_t e, worst = 0;
+	uint8_t dir;
+
+	ad9959_host_init();
+	ad9959_init();
+
+	/* 向上两段(同方向)、保持、向下两段(换向后同方向)、向上(换向)，再接7段对数扫频 */
+	ad9959_chain_init(&c, seg, MAX_SEG, CH, 10000000000ULL);
+	TEST_EQ(ad9959_chain_add(&c, 12000000000ULL, 40000), 0);
+	TEST_EQ(ad9959_chain_add(&c, 15000000000ULL, 60000), 0);
+	TEST_EQ(ad9959_chain_add(&c, 15000000000ULL, 30000), 0);
+	TEST_EQ(ad9959_chain_add(&c, 11000000000ULL, 50000), 0);
+	TEST_EQ(ad9959_chain_add(&c, 10000000000ULL, 40000), 0);
+	TEST_EQ(ad9959_chain_add(&c, 13000000000ULL, 30000), 0);
+	first_log = c.count;
+	TEST_EQ(ad9959_chain_add_log(&c, 20000000000ULL, 200, 7), 0);
+	TEST_EQ(c.count, first_log + 7);
+	TEST_EQ(seg[2].delta, 0);
+	TEST_EQ(seg[2].sync, 30000ULL * AD9959_SYNC_CLK / 1000000000ULL);
+
+	/* 对数段：终点与扫频生成器相同，各段按累计时长取整的请求时长之和等于总时长 */
+	{
+		static const ad9959_sweep_seg_t log_seg[1] = {{20000000000ULL, 7, AD9959_SWEEP_LOG}};
+		ad9959_sweep_gen_t g;
+		uint32_t ftw[8], dw, req, sum = 0;
+		uint8_t rate;
+
+		total = 200ULL * AD9959_SYNC_CLK / 1000000ULL;
+		TEST_CHECK(total % 7 != 0, "total=%u", total);		// 不能整除时才有取整
+		TEST_EQ(ad9959_sweep_gen_init(&g, 13000000000ULL, log_seg, 1), 0);
+		TEST_EQ(ad9959_sweep_gen_next(&g, ftw, 8), 8);
+		bad = 0;
+		for(i = 0; i < 7; i++)
+		{
+			req = (uint32_t)((uint64_t)total * (i + 1) / 7 - (uint64_t)total * i / 7);
+			sum += req;
+			if(seg[first_log + i].ftw != ftw[i + 1]
+			   || seg[first_log + i].sync != ad9959_ramp_solve(ftw[i + 1] - ftw[i], req, &dw, &rate)
+			   || seg[first_log + i].delta != dw || seg[first_log + i].rate != rate)
+				bad++;
+		}
+		TEST_EQ(bad, 0);
+		TEST_EQ(sum, total);
+	}
+
+	/* 参数错误：段数为0、缓冲区不足时不改变扫频链 */
+	TEST_EQ(ad9959_chain_add_log(&c, 30000000000ULL, 100, 0), 1);
+	TEST_EQ(ad9959_chain_add_log(&c, 30000000000ULL, 100, MAX_SEG), 1);
+	TEST_EQ(c.count, first_log + 7);
+
+	/* 播放并记录全部引脚事件 */
+	ad9959_host_pin_hook = pin_hook;
+	TEST_EQ(ad9959_chain_play(&c), 0);
+	TEST_EQ(ad9959_chain_play(&c), 1);			// 正在播放
+	while(ad9959_chain_poll())
+	{
+	}
+	ad9959_host_pin_hook = NULL;
+	TEST_EQ(ad9959_chain_busy(), 0);
+	TEST_EQ(ad9959_chain_late(), 0);
+
+	/* 第一次IO_update是配置，第一次引脚翻转(向上)是第0段开始的时刻 */
+	TEST_CHECK(nud > 1 && npin > 0, "nud=%u npin=%u", nud, npin);
+	t0 = npin > 0 ? pin[0].t : 0;
+
+	/* 按段依次对照：每个非保持段一次IO_update，同方向在段开始时IO_update，换向在段开始时翻转引脚 */
+	i = 1;
+	j = 0;
+	bad = 0;
+	prev = c.start;
+	dir = 0;
+	for(k = 0; k < c.count; k++)
+	{
+		const ad9959_chain_seg_t *s = &seg[k];
+		uint8_t up;
+
+		if(s->delta == 0 || s->ftw == prev)
+			continue;		// 保持段什么都不发送
+		up = s->ftw > prev;
+
+		if(i >= nud)
+		{
+			bad++;
+			break;
+		}
+		if(up ? (ud[i].cw1 != s->ftw || ud[i].rdw != s->delta || (ud[i].srr & 0xFF) != s->rate)
+			  : (ud[i].cftw0 != s->ftw || ud[i].fdw != s->delta || (ud[i].srr >> 8) != s->rate))
+		{
+			bad++;
+			printf("段%u：生效的寄存器不对\n", k);
+		}
+		if(up == dir)
+			e = skew(ud[i].t, t0, &c, k);
+		else if(j < npin && pin[j].up == up)
+			e = skew(pin[j++].t, t0, &c, k);
+		else
+		{
+			bad++;
+			printf("段%u：缺少引脚翻转\n", k);
+			e = 0;
+		}
+		if(e > worst)
+			worst = e;
+		i++;
+		dir = up;
+		prev = s->ftw;
+	}
+	TEST_EQ(bad, 0);
+	TEST_EQ(nud, i);
+	TEST_EQ(npin, j);
+	TEST_EQ(npin, 3);		// 第0、3、5段换向
+	printf("切换时刻最大偏差%u ns\n", worst);
+	TEST_CHECK(worst < TOL_NS, "worst=%u", worst);
+
+	/* 仿真芯片按实际时长扫描，结束后停在终点 */
+	ad9959_host_sync();
+	TEST_EQ(ad9959_emu_ftw(&ad9959_host_emu, CH), seg[c.count - 1].ftw);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, CH, AD9959_CW(1), 1), seg[c.count - 1].ftw);
+
+	return TEST_RESULT();
+}
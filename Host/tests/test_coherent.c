@@ -0,0 +1,107 @@
+#include <math.h>
+#include "myad9959.h"
+#include "ad9959_test.h"
+
+/**
+ ****************************************************************************************************
+ * @file        test_coherent.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       相位相干启动测试：各通道累加器状态不同时调用ad9959_start_coherent()，
+ *              返回后所有通道从零相位开始，用ad9959_emu_render()的采样解调出的相位差等于设置值；
+ *              函数返回时芯片中的FR2已经恢复，之后的跳频不再清零相位
+ *              仿真芯片的FR2[12]/FR2[13]行为是按驱动对数据手册的理解建模的，不能代替硬件验证
+ ****************************************************************************************************
+ */
+
+#define SAMPLES		1000
+#define STEP		50		/* 每点50个系统时钟，1MHz时每点0.1周期 */
+#define PI			3.14159265358979323846
+
+/* 解调出通道相对零相位的角度(度)，范围[0, 360) */
+static double demod(uint8_t ch)
+{
+	static float out[SAMPLES];
+	uint32_t ftw = ad9959_emu_ftw(&ad9959_host_emu, ch);
+	double s = 0, c = 0, th, deg;
+	uint32_t i;
+
+	ad9959_emu_render(&ad9959_host_emu, ch, out, SAMPLES, STEP);
+	for(i = 0; i < SAMPLES; i++)
+	{
+		th = 2.0 * PI * (double)(uint32_t)(ftw * STEP * i) / 4294967296.0;
+		s += out[i] * sin(th);
+		c += out[i] * cos(th);
+	}
+	deg = atan2(c, s) * 180.0 / PI;
+	return deg < 0 ? deg + 360.0 : deg;
+}
+
+/* 角度差，范围(-180, 180] */
+static double angle_diff(double a, double b)
+{
+	double d = fmod(a - b + 540.0, 360.0) - 180.0;
+
+	return d;
+}
+
+int main(void)
+{
+	static const ad9959_channel_cfg_t cfg[4] =
+	{
+		{0, 0,   1023, 1000000000ULL},		// 1MHz
+		{1, 90,  1023, 1000000000ULL},
+		{2, 180, 1023, 1000000000ULL},
+		{3, 270, 1023, 1000000000ULL},
+	};
+	static float junk[SAMPLES];
+	ad9959_emu_stats_t before;
+	uint32_t bytes;
+	uint8_t ch;
+
+	ad9959_host_init();
+	ad9959_init();
+
+	/* 各通道以不同频率运行不同的时间，累加器互不相同 */
+	for(ch = 0; ch < 4; ch++)
+	{
+		ad9959_set_signal_out(ch, 1234567.0 * (ch + 1), 0, 1023);
+		ad9959_emu_render(&ad9959_host_emu, ch, junk, 100 + 37 * ch, 7);
+		TEST_CHECK(ad9959_host_emu.acc[ch] != 0, "ch%u", ch);
+	}
+
+	before = ad9959_host_emu.stats;
+	ad9959_start_coherent(cfg, 4);
+	TEST_EQ(ad9959_host_emu.stats.io_updates - before.io_updates, 2);
+	for(ch = 0; ch < 4; ch++)
+		TEST_EQ(ad9959_host_emu.acc[ch], 0);
+
+	/* 返回时FR2[12]已在芯片中生效为0，影子寄存器中没有待发送的FR2 */
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 0, FR2, 1) & 0x3000, 0);
+	bytes = ad9959_host_emu.stats.bytes;
+	ad9959_flush();
+	TEST_EQ(ad9959_host_emu.stats.bytes - bytes, 0);
+
+	/* 各通道相位差等于设置值 */
+	{
+		double p[4];
+
+		for(ch = 0; ch < 4; ch++)
+			p[ch] = demod(ch);
+		for(ch = 1; ch < 4; ch++)
+			TEST_CHECK(fabs(angle_diff(p[ch], p[0]) - angle_diff(cfg[ch].phase, 0)) < 0.1,
+					   "ch%u: %.3f度", ch, angle_diff(p[ch], p[0]));
+	}
+
+	/* 之后的跳频不清零相位累加器 */
+	{
+		uint32_t acc0 = ad9959_host_emu.acc[0];
+
+		TEST_CHECK(acc0 != 0, "acc0=0");
+		ad9959_set_frequency_millihz(1, 2000000000ULL);
+		TEST_EQ(ad9959_host_emu.acc[0], acc0);
+		TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, CFTW0, 1), ad9959_ftw_from_hz(2000000));
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,140 @@
+#include "myad9959.h"
+#include "spi.h"
+#include "ad9959_test.h"
+
+/**
+ ****************************************************************************************************
+ * @file        test_dev.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       多器件测试：三片仿真芯片共用SCLK/SDIO/IO_update，各有片选；
+ *              写入当前器件时只有它的片选拉低，其它芯片收不到任何帧，共用的IO_update同时到达所有芯片；
+ *              ad9959_dev_update()一个脉冲使所有器件同时生效；ad9959_dev_sync()只给devs[0]置位同步主器件，
+ *              各器件置位自动同步、清除屏蔽位并写入各自的时钟偏移，FR2的其它位保持
+ ****************************************************************************************************
+ */
+
+#define DEVS		3
+
+static ad9959_emu_t emu[DEVS - 1];
+static ad9959_dev_t dev[DEVS - 1];
+
+/* 器件d通道ch的频率(0.001Hz)，round区分两次设置 */
+static uint64_t fre_of(uint8_t d, uint8_t ch, uint8_t round)
+{
+	return 1000000000ULL * (1 + d) + 100000000ULL * ch + 7000000ULL * round;
+}
+
+int main(void)
+{
+	ad9959_dev_t *devs[DEVS] = {&ad9959_dev_default, &dev[0], &dev[1]};
+	ad9959_emu_t *emus[DEVS] = {&ad9959_host_emu, &emu[0], &emu[1]};
+	ad9959_emu_stats_t before[DEVS];
+	ad9959_dev_t *prev;
+	uint8_t d, o, ch;
+
+	ad9959_host_init();
+	ad9959_init();
+	for(d = 0; d < DEVS - 1; d++)
+	{
+		TEST_EQ(ad9959_host_attach(&emu[d], GPIOC, (uint16_t)(GPIO_PIN_7 << d), AD9959_System_Clk), 0);
+		ad9959_dev_init(&dev[d], GPIOC, (uint16_t)(GPIO_PIN_7 << d), &AD9959_SPI_HANDLE, AD9959_System_Clk);
+	}
+
+	/* 按器件设置：只有被选中的芯片收到帧，IO_update同时到达，其它芯片的寄存器不变 */
+	for(d = 0; d < DEVS; d++)
+	{
+		for(o = 0; o < DEVS; o++)
+			before[o] = emus[o]->stats;
+		prev = ad9959_dev_select(devs[d]);
+		TEST_CHECK(prev == &ad9959_dev_default, "d=%u", d);
+		ad9959_set_signal_out(1, (double)(fre_of(d, 1, 0) / 1000), 0, 1023);
+		ad9959_dev_select(prev);
+		for(o = 0; o < DEVS; o++)
+		{
+			TEST_CHECK((emus[o]->stats.frames != before[o].frames) == (o == d), "写器件%u时芯片%u收到%u帧",
+					   d, o, emus[o]->stats.frames - before[o].frames);
+			TEST_EQ(emus[o]->stats.io_updates - before[o].io_updates, 1);
+		}
+	}
+	for(d = 0; d < DEVS; d++)
+	{
+		TEST_EQ(ad9959_emu_reg(emus[d], 1, CFTW0, 1), ad9959_ftw_from_millihz(fre_of(d, 1, 0)));
+		TEST_EQ(ad9959_emu_reg(emus[d], 0, CFTW0, 1), 0);
+	}
+
+	/* ad9959_dev_update()：各器件只写入影子寄存器，一个共用脉冲同时生效 */
+	for(d = 0; d < DEVS; d++)
+	{
+		before[d] = emus[d]->stats;
+		prev = ad9959_dev_select(devs[d]);
+		for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+		{
+			uint32_t ftw = ad9959_ftw_from_millihz(fre_of(d, ch, 1));
+			uint8_t data[4] = {(uint8_t)(ftw >> 24), (uint8_t)(ftw >> 16), (uint8_t)(ftw >> 8), (uint8_t)ftw};
+
+			ad9959_channel_sel_enable(ch);
+			AD9959_WriteData_Unified(CFTW0, 4, data);
+		}
+		ad9959_dev_select(prev);
+	}
+	for(d = 0; d < DEVS; d++)
+		TEST_EQ(emus[d]->stats.bytes, before[d].bytes);		// 还没有发送
+	ad9959_dev_update(devs, DEVS);
+	TEST_CHECK(ad9959_dev_cur == &ad9959_dev_default, "当前器件未恢复");
+	for(d = 0; d < DEVS; d++)
+	{
+		TEST_EQ(emus[d]->stats.io_updates - before[d].io_updates, 1);
+		for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+			TEST_EQ(ad9959_emu_reg(emus[d], ch, CFTW0, 1), ad9959_ftw_from_millihz(fre_of(d, ch, 1)));
+	}
+
+	/* 多器件同步：先让主器件以外的顺序和FR2的其它位都不是默认值 */
+	{
+		uint8_t fr2[2] = {0xA0, (uint8_t)(AD9959_FR2_SYNC_MASTER | AD9959_FR2_SYNC_MASK | 0x03)};
+		ad9959_dev_t *order[DEVS] = {&dev[0], &ad9959_dev_default, &dev[1]};
+		ad9959_emu_t *order_emu[DEVS] = {&emu[0], &ad9959_host_emu, &emu[1]};
+		uint32_t v;
+
+		for(d = 0; d < DEVS; d++)
+		{
+			prev = ad9959_dev_select(devs[d]);
+			AD9959_WriteData_Unified(FR2, 2, fr2);
+			ad9959_dev_select(prev);
+		}
+		ad9959_dev_update(devs, DEVS);
+		for(d = 0; d < DEVS; d++)
+			TEST_EQ(ad9959_emu_reg(emus[d], 0, FR2, 1), 0xA053);
+
+		dev[0].sync_offset = 2;
+		ad9959_dev_default.sync_offset = 1;
+		dev[1].sync_offset = 0x07;		// 只取低2位
+		for(d = 0; d < DEVS; d++)
+			before[d] = emus[d]->stats;
+		ad9959_dev_sync(order, DEVS);
+		TEST_CHECK(ad9959_dev_cur == &ad9959_dev_default, "当前器件未恢复");
+
+		for(d = 0; d < DEVS; d++)
+		{
+			v = ad9959_emu_reg(order_emu[d], 0, FR2, 1);
+			TEST_EQ(v >> 8, 0xA0);													// 其它位保持
+			TEST_EQ(v & AD9959_FR2_AUTO_SYNC, AD9959_FR2_AUTO_SYNC);
+			TEST_EQ(v & AD9959_FR2_SYNC_MASTER, d == 0 ? AD9959_FR2_SYNC_MASTER : 0);	// 只有devs[0]是主器件
+			TEST_EQ(v & AD9959_FR2_SYNC_MASK, 0);
+			TEST_EQ(v & AD9959_FR2_CLK_OFFSET_MASK, order[d]->sync_offset & AD9959_FR2_CLK_OFFSET_MASK);
+			TEST_EQ(order_emu[d]->stats.frames - before[d].frames, 1);				// 只有FR2
+			TEST_EQ(order_emu[d]->stats.io_updates - before[d].io_updates, 1);		// 同一个脉冲
+		}
+
+		/* 同步后按器件写入仍然只到达该器件，同步位保持 */
+		prev = ad9959_dev_select(&dev[1]);
+		ad9959_set_signal_out(2, 3000000, 0, 1023);
+		ad9959_dev_select(prev);
+		TEST_EQ(ad9959_emu_reg(&emu[1], 2, CFTW0, 1), ad9959_ftw_from_millihz(3000000000ULL));
+		TEST_EQ(ad9959_emu_reg(&emu[0], 2, CFTW0, 1), ad9959_ftw_from_millihz(fre_of(1, 2, 1)));
+		TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 2, CFTW0, 1), ad9959_ftw_from_millihz(fre_of(0, 2, 1)));
+		TEST_EQ(ad9959_emu_reg(&emu[1], 0, FR2, 1) & 0xFF, AD9959_FR2_AUTO_SYNC | 0x03);
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,93 @@
+#include "ad9959_emu.h"
+#include "ad9959_test.h"
+
+#include <math.h>
+#include <string.h>
+
+/**
+ ****************************************************************************************************
+ * @file        test_emu.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       仿真芯片自身的测试：复位值、字节级/引脚级解码、IO_update和输出频率
+ ****************************************************************************************************
+ */
+
+/* 按引脚级时序(单线模式)发送一个字节 */
+static void pins_byte(ad9959_emu_t *emu, uint8_t b)
+{
+	uint8_t i;
+	uint32_t sd;
+
+	for(i = 0; i < 8; i++)
+	{
+		sd = (b & (0x80 >> i)) ? AD9959_EMU_PIN_SDIO0 : 0;
+		ad9959_emu_pins(emu, sd);
+		ad9959_emu_pins(emu, sd | AD9959_EMU_PIN_CLK);
+	}
+	ad9959_emu_pins(emu, 0);
+}
+
+int main(void)
+{
+	static ad9959_emu_t a, b;
+	static float out[4096];
+	const uint8_t frame[] = {0x00, 0x20, 0x04, 0x12, 0x34, 0x56, 0x78, 0x05, 0x10, 0x00};
+	uint32_t i;
+	int zc = 0;
+
+	/* 复位值 */
+	ad9959_emu_init(&a, 500000000);
+	TEST_EQ(ad9959_emu_reg(&a, 0, 0x00, 1), 0xF0);
+	TEST_EQ(ad9959_emu_reg(&a, 2, 0x03, 1), 0x000302);
+	TEST_EQ(ad9959_emu_reg(&a, 3, 0x04, 1), 0);
+
+	/* 字节级：CSR只选中通道1，写CFTW0/CPOW0 */
+	ad9959_emu_pins(&a, 0);
+	ad9959_emu_spi(&a, frame, sizeof(frame));
+	ad9959_emu_pins(&a, AD9959_EMU_PIN_CS);
+	TEST_EQ(a.stats.frames, 1);
+	TEST_EQ(a.stats.bytes, sizeof(frame));
+	TEST_EQ(ad9959_emu_reg(&a, 1, 0x04, 0), 0x12345678);
+	TEST_EQ(ad9959_emu_reg(&a, 1, 0x04, 1), 0);			// IO_update之前不生效
+	TEST_EQ(ad9959_emu_reg(&a, 0, 0x04, 0), 0);			// 未选中的通道不变
+	ad9959_emu_pins(&a, AD9959_EMU_PIN_CS | AD9959_EMU_PIN_UD);
+	ad9959_emu_pins(&a, AD9959_EMU_PIN_CS);
+	TEST_EQ(ad9959_emu_reg(&a, 1, 0x04, 1), 0x12345678);
+	TEST_EQ(ad9959_emu_reg(&a, 1, 0x05, 1), 0x1000);
+	TEST_EQ(a.stats.io_updates, 1);
+
+	/* 引脚级解码与字节级相同 */
+	ad9959_emu_init(&b, 500000000);
+	ad9959_emu_pins(&b, 0);
+	for(i = 0; i < sizeof(frame); i++)
+		pins_byte(&b, frame[i]);
+	ad9959_emu_pins(&b, AD9959_EMU_PIN_CS);
+	TEST_EQ(b.stats.sclk, sizeof(frame) * 8);
+	TEST_CHECK(memcmp(a.buf, b.buf, sizeof(a.buf)) == 0, "引脚级与字节级的I/O缓冲不同");
+
+	/* 片选为高时忽略总线 */
+	ad9959_emu_spi(&b, frame, sizeof(frame));
+	TEST_EQ(b.stats.bytes, sizeof(frame));
+
+	/* 复位 */
+	ad9959_emu_pins(&a, AD9959_EMU_PIN_CS | AD9959_EMU_PIN_RST);
+	ad9959_emu_pins(&a, AD9959_EMU_PIN_CS);
+	TEST_EQ(ad9959_emu_reg(&a, 1, 0x04, 1), 0);
+
+	/* 输出频率：CFTW0 = 2^32 * 10MHz / 500MHz，每个采样1个系统时钟，4096点内约82个周期 */
+	{
+		/* CFR复位值0x000302的bit1保持清零相位累加器，先改为0x000300 */
+		const uint8_t f[] = {0x00, 0xF0, 0x03, 0x00, 0x03, 0x00, 0x04, 0x05, 0x1E, 0xB8, 0x52};
+
+		ad9959_emu_pins(&a, 0);
+		ad9959_emu_spi(&a, f, sizeof(f));
+		ad9959_emu_pins(&a, AD9959_EMU_PIN_UD);
+		ad9959_emu_pins(&a, AD9959_EMU_PIN_CS);
+		ad9959_emu_render(&a, 0, out, 4096, 1);
+		for(i = 1; i < 4096; i++)
+			zc += (out[i - 1] < 0 && out[i] >= 0);
+		TEST_CHECK(zc >= 81 && zc <= 82, "上升过零次数%d", zc);
+	}
+	return TEST_RESULT();
+}
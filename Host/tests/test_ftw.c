@@ -0,0 +1,118 @@
+#include "myad9959.h"
+#include "ad9959_test.h"
+
+/**
+ ****************************************************************************************************
+ * @file        test_ftw.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       频率控制字测试：整数路径与128位整数参考值逐一比较
+ *              0-250MHz内每个整数Hz；每个频率控制字的舍入边界(毫赫兹)两侧；其他时钟和微赫兹输入随机抽样
+ *              最后打印每次计算的平均周期数(x86为TSC周期，其他平台为ns)，与原double公式对比；
+ *              两者都通过函数指针调用，排除内联和循环向量化只对其中一方生效的差别
+ ****************************************************************************************************
+ */
+
+#define FTW_MAX_HZ		250000000ULL
+
+/* 参考值：round(num * 2^32 / den)，取低32位 */
+static uint32_t ref_ratio(uint64_t num, uint64_t den)
+{
+	unsigned __int128 n = ((unsigned __int128)num << 32) + den / 2;
+
+	return (uint32_t)(n / den);
+}
+
+/* 满足 round(f * 2^32 / den) >= k 的最小f，即 ceil((k - 0.5) * den / 2^32) */
+static uint64_t ref_boundary(uint32_t k, uint64_t den)
+{
+	unsigned __int128 n = (unsigned __int128)(2ULL * k - 1) * den;
+	unsigned __int128 d = (unsigned __int128)1 << 33;
+
+	return (uint64_t)((n + d - 1) / d);
+}
+
+/* 原double公式(截断)，与整数路径相同的输入和时钟来源 */
+static uint32_t ftw_double(uint64_t fre_mhz)
+{
+	return (uint32_t)(4294967296.0 / (double)ad9959_dev_cur->sys_clk * ((double)fre_mhz / 1000.0));
+}
+
+/* 每次计算的平均周期数 */
+static double bench(uint32_t (*volatile fn)(uint64_t))
+{
+	volatile uint32_t sink = 0;
+	uint64_t t0, t1;
+	uint32_t i;
+
+	t0 = test_ticks();
+	for(i = 0; i < 10000000; i++)
+		sink += fn(i * 25000ULL);
+	t1 = test_ticks();
+	(void)sink;
+	return (double)(t1 - t0) / 10000000;
+}
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t rng(void)
+{
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 7;
+	rng_state ^= rng_state << 17;
+	return rng_state;
+}
+
+int main(void)
+{
+	static const uint32_t clocks[] = {500000000, 400000000, 100000000, 25000000};
+	uint64_t clk, hz, f, bad;
+	uint32_t k, kmax, i, c;
+
+	ad9959_host_init();
+	ad9959_init();
+	clk = ad9959_dev_cur->sys_clk;
+	TEST_EQ(clk, 500000000);
+
+	/* 每个整数Hz */
+	bad = 0;
+	for(hz = 0; hz <= FTW_MAX_HZ; hz++)
+		if(ad9959_ftw_from_hz((uint32_t)hz) != ref_ratio(hz, clk))
+			bad++;
+	TEST_EQ(bad, 0);
+
+	/* 每个频率控制字：边界上的毫赫兹值舍入到k，前一个舍入到k-1 */
+	bad = 0;
+	kmax = ref_ratio(FTW_MAX_HZ, clk);
+	for(k = 1; k <= kmax; k++)
+	{
+		f = ref_boundary(k, clk * 1000);
+		if(ad9959_ftw_from_millihz(f) != k || ad9959_ftw_from_millihz(f - 1) != k - 1)
+			bad++;
+	}
+	TEST_EQ(bad, 0);
+
+	/* 其他系统时钟，毫赫兹和微赫兹输入随机抽样 */
+	bad = 0;
+	for(c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+	{
+		ad9959_dev_cur->sys_clk = clocks[c];
+		for(i = 0; i < 1000000; i++)
+		{
+			f = rng() % (clocks[c] / 2 * 1000ULL + 1);
+			if(ad9959_ftw_from_millihz(f) != ref_ratio(f, clocks[c] * 1000ULL))
+				bad++;
+			f = rng() % (clocks[c] / 2 * 1000000ULL + 1);
+			if(ad9959_ftw_from_microhz(f) != ref_ratio(f, clocks[c] * 1000000ULL))
+				bad++;
+		}
+	}
+	ad9959_dev_cur->sys_clk = (uint32_t)clk;
+	TEST_EQ(bad, 0);
+
+	/* 性能：整数路径与原double公式(截断) */
+	printf("ad9959_ftw_from_millihz: %.2f %s/次\n", bench(ad9959_ftw_from_millihz), TEST_TICK_UNIT);
+	printf("double公式:              %.2f %s/次\n", bench(ftw_double), TEST_TICK_UNIT);
+
+	return TEST_RESULT();
+}
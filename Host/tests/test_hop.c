@@ -0,0 +1,163 @@
+#include "myad9959.h"
+#include "myad9959_hop.h"
+#include "ad9959_test.h"
+
+/**
+ ****************************************************************************************************
+ * @file        test_hop.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       跳频表测试：每一跳生效后仿真芯片的ACR/CPOW0/CFTW0与ad9959_set_signal_out()设置同样参数的结果相同；
+ *              每次ad9959_hop_tick()先产生IO_update使预装的一跳生效，再用一帧预装下一跳，
+ *              IO_update相对调用开始的延迟不随SPI发送变化；循环播放回到第一跳，不循环时停在最后一跳
+ ****************************************************************************************************
+ */
+
+#define HOPS		64
+#define CH			2
+
+static uint64_t fre[HOPS];
+static uint16_t phase[HOPS], amp[HOPS];
+static uint32_t ref[HOPS][3];
+static uint8_t buf[HOPS * AD9959_HOP_FRAME_BYTES(1, 1)];
+
+/* 读出仿真芯片中通道CH的ACR/CPOW0/CFTW0，active为0时读I/O缓冲 */
+static void read_regs(uint8_t active, uint32_t *r)
+{
+	r[0] = ad9959_emu_reg(&ad9959_host_emu, CH, ACR, active);
+	r[1] = ad9959_emu_reg(&ad9959_host_emu, CH, CPOW0, active);
+	r[2] = ad9959_emu_reg(&ad9959_host_emu, CH, CFTW0, active);
+}
+
+/* 寄存器与第k跳的参考值不同的个数 */
+static uint32_t diff(const uint32_t *r, uint32_t k)
+{
+	return (r[0] != ref[k][0]) + (r[1] != ref[k][1]) + (r[2] != ref[k][2]);
+}
+
+int main(void)
+{
+	ad9959_hop_table_t t = {0};
+	ad9959_emu_stats_t before;
+	uint32_t r[3], i, bad;
+
+	ad9959_host_init();
+	ad9959_init();
+
+	/* 参考值：逐跳用ad9959_set_signal_out()设置同样的参数 */
+	for(i = 0; i < HOPS; i++)
+	{
+		fre[i] = (1000000ULL + 1234567ULL * i) * 1000ULL;		// 整数Hz
+		phase[i] = (uint16_t)((i * 37) % 360);
+		amp[i] = (uint16_t)(1 + (i * 97) % 1023);
+		ad9959_set_signal_out(CH, (double)(fre[i] / 1000), phase[i], amp[i]);
+		read_regs(1, ref[i]);
+	}
+
+	/* 缓冲区不足 */
+	t.buf = buf;
+	t.size = sizeof(buf) - 1;
+	TEST_EQ(ad9959_hop_build(&t, CH, fre, phase, amp, HOPS), 1);
+	t.size = sizeof(buf);
+	TEST_EQ(ad9959_hop_build(&t, CH, fre, phase, amp, HOPS), 0);
+	TEST_EQ(t.frame, 12);
+
+	/* 不循环：每一跳先生效再预装下一跳 */
+	ad9959_set_signal_out(0, 1000000, 0, 1023);		// 选中其他通道，play应重新选中CH
+	TEST_EQ(ad9959_hop_play(&t, 1000, 0), 0);
+	TEST_EQ(ad9959_hop_play(&t, 1000, 0), 1);			// 正在播放
+	read_regs(0, r);
+	TEST_EQ(diff(r, 0), 0);								// 第一跳已预装
+	{
+		uint32_t lat, lat_min = UINT32_MAX, lat_max = 0, send, send_min = UINT32_MAX;
+		uint32_t t0, t1, frames, updates, bytes;
+		uint32_t order = 0, traffic = 0;
+
+		bad = 0;
+		for(i = 0; i < HOPS; i++)
+		{
+			frames = ad9959_host_emu.stats.frames;
+			updates = ad9959_host_emu.stats.io_updates;
+			bytes = ad9959_host_emu.stats.bytes;
+			t0 = ad9959_host_now();
+			TEST_EQ(ad9959_hop_tick(), i + 1 < HOPS);
+			t1 = ad9959_host_now();
+
+			read_regs(1, r);
+			bad += diff(r, i);
+			if(i + 1 < HOPS)
+			{
+				/* IO_update在前：生效的是第i跳，I/O缓冲中已是第i+1跳 */
+				read_regs(0, r);
+				order += diff(r, i + 1);
+				traffic += (ad9959_host_emu.stats.frames - frames != 1) + (ad9959_host_emu.stats.bytes - bytes != t.frame);
+			}
+			else
+				traffic += (ad9959_host_emu.stats.frames != frames);	// 最后一跳之后不再发送
+			traffic += (ad9959_host_emu.stats.io_updates - updates != 1);
+
+			lat = ad9959_host_update_time - t0;
+			send = t1 - ad9959_host_update_time;
+			if(lat < lat_min)
+				lat_min = lat;
+			if(lat > lat_max)
+				lat_max = lat;
+			if(i + 1 < HOPS && send < send_min)
+				send_min = send;
+		}
+		TEST_EQ(bad, 0);
+		TEST_EQ(order, 0);
+		TEST_EQ(traffic, 0);
+		TEST_EQ(ad9959_hop_count(), HOPS);
+		TEST_EQ(ad9959_hop_busy(), 0);
+		TEST_EQ(ad9959_hop_tick(), 0);
+		printf("IO_update延迟%u-%u ns，预装一跳至少%u ns\n", lat_min, lat_max, send_min);
+		TEST_CHECK(lat_max < send_min, "IO_update延迟%u ns 预装%u ns", lat_max, send_min);
+	}
+
+	/* 循环：最后一跳之后回到第一跳 */
+	TEST_EQ(ad9959_hop_play(&t, 1000, 1), 0);
+	bad = 0;
+	for(i = 0; i < 2 * HOPS + 3; i++)
+	{
+		TEST_EQ(ad9959_hop_tick(), 1);
+		read_regs(1, r);
+		bad += diff(r, i % HOPS);
+	}
+	TEST_EQ(bad, 0);
+	TEST_EQ(ad9959_hop_count(), 2 * HOPS + 3);
+	ad9959_hop_stop();
+	TEST_EQ(ad9959_hop_tick(), 0);
+
+	/* 只有频率：每跳一个5字节的帧，相位和幅度保持 */
+	TEST_EQ(ad9959_hop_build(&t, CH, fre, NULL, NULL, HOPS), 0);
+	TEST_EQ(t.frame, 5);
+	ad9959_set_signal_out(CH, 1000000, 45, 512);
+	read_regs(1, r);
+	TEST_EQ(ad9959_hop_play(&t, 1000, 0), 0);
+	before = ad9959_host_emu.stats;
+	bad = 0;
+	for(i = 0; i < HOPS; i++)
+	{
+		uint32_t h[3];
+
+		ad9959_hop_tick();
+		read_regs(1, h);
+		bad += (h[0] != r[0]) + (h[1] != r[1]) + (h[2] != ref[i][2]);
+	}
+	TEST_EQ(bad, 0);
+	TEST_EQ(ad9959_host_emu.stats.bytes - before.bytes, (HOPS - 1) * 5);
+
+	/* 播放后影子寄存器失效：之后的设置完整重发 */
+	{
+		uint32_t h[3];
+
+		ad9959_set_signal_out(CH, 1000000, 45, 512);
+		read_regs(1, h);
+		TEST_EQ(h[2], r[2]);
+		TEST_EQ(h[0], r[0]);
+		TEST_EQ(h[1], r[1]);
+	}
+
+	return TEST_RESULT();
+}
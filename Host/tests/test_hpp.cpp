@@ -0,0 +1,83 @@
+#include "myad9959.hpp"
+#include "ad9959_test.h"
+
+/**
+ ****************************************************************************************************
+ * @file        test_hpp.cpp
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       myad9959.hpp测试：编译期编码与C驱动的运行时函数逐位一致，
+ *              apply()整帧发送后芯片寄存器正确，影子寄存器中被帧改写的项重新发送
+ ****************************************************************************************************
+ */
+
+/* myad9959.c中的相位编码，头文件未声明 */
+extern "C" void AD9959_Get_CPOW0_Data(int phase, uint8_t *CPOW0_Data);
+
+int main(void)
+{
+	static constexpr ad9959::channel_config cfg[] =
+	{
+		{1, 1000000000ULL, 90, 512},
+		{3, 12345678901ULL, 360, 1023},
+	};
+	static constexpr auto plan = ad9959::make_plan(cfg);
+	static const uint32_t clocks[] = {500000000, 400000000, 255000000, 100000000, 25000000, 30000000};
+	uint32_t bad, c;
+	uint64_t f;
+
+	ad9959_host_init();
+	ad9959_init();
+
+	/* 相位：0-1440度与C函数的字节相同 */
+	bad = 0;
+	for(int phase = 0; phase <= 1440; phase++)
+	{
+		uint8_t b[2];
+		AD9959_Get_CPOW0_Data(phase, b);
+		if(b[0] != (uint8_t)(ad9959::pow_deg((uint16_t)phase) >> 8) || b[1] != (uint8_t)ad9959::pow_deg((uint16_t)phase))
+			bad++;
+	}
+	TEST_EQ(bad, 0);
+
+	/* FR1和频率控制字：不同系统时钟下与运行时函数相同 */
+	bad = 0;
+	for(c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+	{
+		ad9959_dev_cur->sys_clk = clocks[c];
+		if(ad9959::fr1_clock(clocks[c]) != ad9959_fr1_clock())
+			bad++;
+		for(f = 0; f < clocks[c] / 2 * 1000ULL; f += 1234567891ULL)
+			if(ad9959::ftw_millihz(f, clocks[c]) != ad9959_ftw_from_millihz(f))
+				bad++;
+	}
+	ad9959_dev_cur->sys_clk = AD9959_System_Clk;
+	TEST_EQ(bad, 0);
+
+	/* apply()：通道1先由C接口设为2MHz，影子寄存器记录了芯片内容 */
+	ad9959_set_signal_out(1, 2000000, 0, 1023);
+	{
+		const ad9959_emu_stats_t before = ad9959_host_emu.stats;
+
+		ad9959::apply(plan);
+		TEST_EQ(ad9959_host_emu.stats.frames - before.frames, 1);
+		TEST_EQ(ad9959_host_emu.stats.bytes - before.bytes, plan.size());
+		TEST_EQ(ad9959_host_emu.stats.io_updates - before.io_updates, 1);
+	}
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 0, FR1, 1), (uint32_t)ad9959_fr1_clock() << 16);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, CFTW0, 1), ad9959_ftw_from_millihz(1000000000ULL));
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, CPOW0, 1), 0x1000);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, ACR, 1), 0x001200);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 3, CFTW0, 1), ad9959_ftw_from_millihz(12345678901ULL));
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 3, CPOW0, 1), 0x4000);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 3, ACR, 1), 0x0013FF);
+
+	/* 再设回2MHz：影子寄存器已失效，必须重新发送 */
+	ad9959_set_signal_out(1, 2000000, 0, 1023);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, CFTW0, 1), ad9959_ftw_from_hz(2000000));
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, CPOW0, 1), 0);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, ACR, 1), 0x0013FF);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 3, CFTW0, 1), ad9959_ftw_from_millihz(12345678901ULL));
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,138 @@
+#include "myad9959.h"
+#include "myad9959_mod.h"
+#include "ad9959_test.h"
+
+/**
+ ****************************************************************************************************
+ * @file        test_mod.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       多级调制测试：各级数、各通道下每个符号输出后，仿真芯片按Profile引脚选出的调制字与装载的一致；
+ *              比特流编码的BSRR序列逐个写入端口，仿真芯片得到的符号序列与比特分组(含格雷码)一致
+ ****************************************************************************************************
+ */
+
+/* 写入编码结果，记录仿真芯片每一步的符号 */
+static void play(const uint32_t *bsrr, uint32_t n, uint8_t ch, uint8_t *sym)
+{
+	uint32_t i;
+
+	for(i = 0; i < n; i++)
+	{
+		AD9959_BSRR_WRITE(AD9959_PROFILE_GPIO_Port, bsrr[i]);
+		sym[i] = ad9959_emu_symbol(&ad9959_host_emu, ch);
+	}
+}
+
+int main(void)
+{
+	static const uint8_t level_list[4] = {2, 4, 8, 16};
+	uint32_t words[16], bsrr[64];
+	uint8_t sym[64];
+	uint8_t ch, l, s, levels, bad;
+	uint32_t n, i;
+
+	ad9959_host_init();
+	ad9959_init();
+	ad9959_mod_init();
+
+	/* 参数检查 */
+	TEST_EQ(ad9959_mod_config(0, AD9959_MOD_FRE, 3, words), 1);
+	TEST_EQ(ad9959_mod_config(4, AD9959_MOD_FRE, 2, words), 1);
+	TEST_EQ(ad9959_mod_config(0, 0, 2, words), 1);
+	TEST_EQ(ad9959_mod_config(0, AD9959_MOD_FRE, 2, NULL), 1);
+
+	/* FSK：每个级数、每个通道，符号n选出words[n] */
+	for(l = 0; l < 4; l++)
+	{
+		levels = level_list[l];
+		for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+		{
+			for(s = 0; s < levels; s++)
+				words[s] = ad9959_ftw_from_hz(1000000U + 10000U * s + 1000U * ch);
+			TEST_EQ(ad9959_mod_config(ch, AD9959_MOD_FRE, levels, words), 0);
+			TEST_EQ(ad9959_mod_bits(), l + 1);
+			bad = 0;
+			for(s = 0; s < levels; s++)
+			{
+				ad9959_mod_symbol(s);
+				if(ad9959_emu_symbol(&ad9959_host_emu, ch) != s || ad9959_emu_ftw(&ad9959_host_emu, ch) != words[s])
+					bad++;
+			}
+			TEST_CHECK(bad == 0, "levels=%u ch=%u: %u个符号错误", levels, ch, bad);
+		}
+	}
+
+	/* PSK和ASK：CWn中高位对齐 */
+	for(s = 0; s < 4; s++)
+		words[s] = 4096U * s;
+	TEST_EQ(ad9959_mod_config(1, AD9959_MOD_PHASE, 4, words), 0);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, CPOW0, 1), 0);
+	for(s = 1; s < 4; s++)
+		TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, AD9959_CW(s), 1), words[s] << 18);
+	for(s = 0; s < 2; s++)
+		words[s] = 1023U - 700U * s;
+	TEST_EQ(ad9959_mod_config(2, AD9959_MOD_AMP, 2, words), 0);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 2, ACR, 1) & 0x3FF, 1023);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 2, AD9959_CW(1), 1), 323UL << 22);
+
+	/* 编码：16级，0x01 0x23 0x45 0x67 0x89 0xAB 0xCD 0xEF -> 0,1,...,15 */
+	{
+		static const uint8_t data[8] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF};
+
+		for(s = 0; s < 16; s++)
+			words[s] = ad9959_ftw_from_hz(1000000U * (s + 1));
+		TEST_EQ(ad9959_mod_config(0, AD9959_MOD_FRE, 16, words), 0);
+		n = ad9959_mod_encode(data, 64, bsrr, 64);
+		TEST_EQ(n, 16);
+		play(bsrr, n, 0, sym);
+		bad = 0;
+		for(i = 0; i < n; i++)
+			if(sym[i] != i)
+				bad++;
+		TEST_EQ(bad, 0);
+
+		/* 输出缓冲区容量限制 */
+		TEST_EQ(ad9959_mod_encode(data, 64, bsrr, 5), 5);
+	}
+
+	/* 编码：4级格雷码，比特对00 01 11 10依次对应符号0 1 2 3；尾部不足一个符号补0 */
+	{
+		static const uint8_t data[2] = {0x1E, 0x80};	// 00 01 11 10 1
+		static const uint8_t expect[5] = {0, 1, 2, 3, 3};	// 最后的1补0成为10
+
+		for(s = 0; s < 4; s++)
+			words[s] = ad9959_ftw_from_hz(2000000U + 100000U * s);
+		TEST_EQ(ad9959_mod_config(3, AD9959_MOD_FRE | AD9959_MOD_GRAY, 4, words), 0);
+		n = ad9959_mod_encode(data, 9, bsrr, 64);
+		TEST_EQ(n, 5);
+		play(bsrr, n, 3, sym);
+		bad = 0;
+		for(i = 0; i < n; i++)
+			if(sym[i] != expect[i])
+				bad++;
+		TEST_EQ(bad, 0);
+		TEST_EQ(ad9959_emu_ftw(&ad9959_host_emu, 3), words[3]);
+	}
+
+	/* 2级：其他通道的引脚不受影响 */
+	{
+		static const uint8_t data[1] = {0xA5};
+
+		words[0] = ad9959_ftw_from_hz(1000000);
+		words[1] = ad9959_ftw_from_hz(1100000);
+		TEST_EQ(ad9959_mod_config(2, AD9959_MOD_FRE, 2, words), 0);
+		n = ad9959_mod_encode(data, 8, bsrr, 64);
+		TEST_EQ(n, 8);
+		bad = 0;
+		for(i = 0; i < n; i++)
+			if((bsrr[i] | (bsrr[i] >> 16)) & 0xFFFF & ~(1U << (AD9959_PROFILE_PIN_SHIFT + 2)))
+				bad++;
+		TEST_EQ(bad, 0);
+		play(bsrr, n, 2, sym);
+		for(i = 0; i < n; i++)
+			TEST_EQ(sym[i], (0xA5 >> (7 - i)) & 1);
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,190 @@
+#include "myad9959.h"
+#include "ad9959_test.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ ****************************************************************************************************
+ * @file        test_queue.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       DMA事务队列测试：用假SPI后端检查事务顺序、缓冲区回绕、回调和错误处理，
+ *              最后经过驱动检查超过队列容量的长帧
+ ****************************************************************************************************
+ */
+
+/* 假SPI后端：start只记录，测试调用ad9959_queue_tx_done()模拟DMA完成中断 */
+static struct
+{
+	char    log[256];			/* 事件序列：c片选拉低 C拉高 u IO_update 数字为回调参数 */
+	uint8_t rx[8192];			/* 依次收到的数据 */
+	uint32_t rx_len;
+	uint8_t  active;			/* 有一次传输正在进行 */
+	uint8_t  fail;				/* 非0时start返回失败 */
+} fake;
+
+static void fake_log(char c)
+{
+	size_t n = strlen(fake.log);
+
+	if(n + 1 < sizeof(fake.log))
+		fake.log[n] = c;
+}
+
+static void fake_cs(uint8_t level)
+{
+	fake_log(level ? 'C' : 'c');
+}
+
+static uint8_t fake_start(const uint8_t *buf, uint16_t len)
+{
+	if(fake.fail || fake.rx_len + len > sizeof(fake.rx))
+		return 1;
+	memcpy(&fake.rx[fake.rx_len], buf, len);
+	fake.rx_len += len;
+	fake.active = 1;
+	return 0;
+}
+
+static void fake_io_update(void)
+{
+	fake_log('u');
+}
+
+static const ad9959_queue_ops_t fake_ops = {fake_cs, fake_start, fake_io_update};
+
+static void fake_cb(void *ctx)
+{
+	fake_log((char)('0' + (int)(intptr_t)ctx));
+}
+
+/* 完成所有正在进行的传输 */
+static void fake_drain(void)
+{
+	while(fake.active)
+	{
+		fake.active = 0;
+		ad9959_queue_tx_done();
+	}
+}
+
+/* 完成正在进行的一次传输 */
+static void fake_step(void)
+{
+	if(fake.active)
+	{
+		fake.active = 0;
+		ad9959_queue_tx_done();
+	}
+}
+
+static void fake_reset(void)
+{
+	memset(&fake, 0, sizeof(fake));
+	ad9959_queue_init(&fake_ops);
+}
+
+int main(void)
+{
+	static uint8_t frame[AD9959_QUEUE_BUF_SIZE], sent[sizeof(fake.rx)];
+	uint32_t sent_len = 0, i, len;
+	const uint8_t d1[2] = {0x11, 0x22}, d2[4] = {0x33, 0x44, 0x55, 0x66};
+
+	/* 顺序：写入依次发送，IO_update在之前的写入完成后产生，然后回调，之后的写入继续 */
+	fake_reset();
+	TEST_EQ(ad9959_queue_write(0x05, 2, d1), 0);
+	TEST_EQ(ad9959_queue_write(0x04, 4, d2), 0);
+	TEST_EQ(ad9959_queue_io_update(fake_cb, (void *)1), 0);
+	TEST_EQ(ad9959_queue_write(0x05, 2, d1), 0);
+	TEST_EQ(ad9959_queue_io_update(fake_cb, (void *)2), 0);
+	TEST_CHECK(strcmp(fake.log, "c") == 0, "log=%s", fake.log);			// 只启动了第一个
+	TEST_EQ(fake.rx_len, 3);
+	TEST_EQ(ad9959_queue_busy(), 1);
+	fake_drain();
+	TEST_CHECK(strcmp(fake.log, "cCcCu1cCu2") == 0, "log=%s", fake.log);
+	{
+		const uint8_t expect[] = {0x05, 0x11, 0x22, 0x04, 0x33, 0x44, 0x55, 0x66, 0x05, 0x11, 0x22};
+
+		TEST_EQ(fake.rx_len, sizeof(expect));
+		TEST_CHECK(memcmp(fake.rx, expect, sizeof(expect)) == 0, "数据顺序错误");
+	}
+	TEST_EQ(ad9959_queue_busy(), 0);
+
+	/* 回绕：不同长度的帧反复入队，每次只完成一部分，队列始终有积压，
+	 * 数据在缓冲区末尾放不下时跳到开头(pad)；收到的数据与发送的完全相同 */
+	fake_reset();
+	ad9959_host_in_isr = 1;		// 队列满时返回失败而不是等待假后端
+	for(i = 0; i < 400; i++)
+	{
+		len = 1 + (i * 37) % AD9959_QUEUE_MAX_FRAME;
+		if(sent_len + len > sizeof(sent))
+			break;
+		memset(frame, (int)i, len);
+		if(ad9959_queue_frame(frame, (uint16_t)len) != 0)
+		{
+			fake_drain();
+			TEST_EQ(ad9959_queue_frame(frame, (uint16_t)len), 0);		// 队列为空时一定放得下
+		}
+		memcpy(&sent[sent_len], frame, len);
+		sent_len += len;
+		if(i % 2 == 0)
+			fake_step();
+	}
+	fake_drain();
+	TEST_EQ(fake.rx_len, sent_len);
+	TEST_CHECK(memcmp(fake.rx, sent, sent_len) == 0, "回绕后数据错误");
+
+	/* 原来的死锁：写位置200处申请256字节，队列为空时回绕到0 */
+	fake_reset();
+	TEST_EQ(ad9959_queue_frame(frame, 200), 0);
+	fake_drain();
+	TEST_EQ(ad9959_queue_frame(frame, AD9959_QUEUE_MAX_FRAME), 0);
+	fake_drain();
+	TEST_EQ(ad9959_queue_frame(frame, AD9959_QUEUE_MAX_FRAME + 1), 1);	// 超过一半缓冲区的帧拒绝
+	TEST_EQ(ad9959_queue_busy(), 0);
+
+	/* 中断中队列已满：返回失败并计入错误，不等待 */
+	fake_reset();
+	for(i = 0; i < AD9959_QUEUE_DEPTH; i++)
+		TEST_EQ(ad9959_queue_write(0x05, 2, d1), 0);
+	TEST_EQ(ad9959_queue_io_update(fake_cb, (void *)3), 1);
+	TEST_EQ(ad9959_queue_errors(), 1);
+	fake_drain();
+	TEST_EQ(ad9959_queue_io_update(fake_cb, (void *)3), 0);
+	TEST_EQ(fake.log[strlen(fake.log) - 1], '3');
+	ad9959_host_in_isr = 0;
+
+	/* 启动失败：事务被丢弃，后面的IO_update仍然执行 */
+	fake_reset();
+	fake.fail = 1;
+	TEST_EQ(ad9959_queue_write(0x05, 2, d1), 0);
+	TEST_EQ(ad9959_queue_io_update(fake_cb, (void *)4), 0);
+	TEST_EQ(ad9959_queue_errors(), 1);
+	TEST_CHECK(strcmp(fake.log, "cCu4") == 0, "log=%s", fake.log);
+
+	/* 经过驱动：超过队列容量的长帧等队列空后阻塞发送，仍然是一次片选 */
+	{
+		static uint8_t big[400];
+		ad9959_emu_stats_t s0;
+
+		ad9959_host_init();
+		ad9959_init();
+		for(i = 0; i + 5 <= sizeof(big); i += 5)
+		{
+			big[i] = CFTW0;
+			big[i + 1] = 0x01;
+			big[i + 2] = 0x02;
+			big[i + 3] = 0x03;
+			big[i + 4] = (uint8_t)i;
+		}
+		s0 = ad9959_host_emu.stats;
+		AD9959_WriteFrame(big, 20);
+		AD9959_WriteFrame(big, sizeof(big));
+		ad9959_wait_idle();
+		TEST_EQ(ad9959_host_emu.stats.frames - s0.frames, 2);
+		TEST_EQ(ad9959_host_emu.stats.bytes - s0.bytes, 20 + sizeof(big));
+		TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 0, CFTW0, 0), 0x0102038B);
+	}
+	return TEST_RESULT();
+}
@@ -0,0 +1,58 @@
+#include "myad9959.h"
+#include "ad9959_test.h"
+
+/**
+ ****************************************************************************************************
+ * @file        test_ramp.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       按时长扫描测试：ad9959_ramp_t中的实际时长与128位整数参考值(周期数x10^9/SYNC_CLK)一致，
+ *              覆盖步长为1、每步255周期的最长斜率(约2^40个周期，直接乘10^9会溢出64位)；
+ *              仿真芯片中的RDW/FDW/SRR与返回的步长和斜率一致
+ ****************************************************************************************************
+ */
+
+/* 实际时长的参考值(ns) */
+static uint64_t ref_ns(uint32_t dw, uint8_t rate, uint32_t span)
+{
+	unsigned __int128 sync = (unsigned __int128)((span + (uint64_t)dw - 1) / dw) * rate;
+
+	return (uint64_t)(sync * 1000000000U / (AD9959_System_Clk / 4));
+}
+
+int main(void)
+{
+	static const uint32_t time_us[6] = {1, 1000, 1000000, 100000000, 2000000000UL, 0xFFFFFFFFUL};
+	ad9959_ramp_t r;
+	uint32_t s0, e0, i;
+
+	ad9959_host_init();
+	ad9959_init();
+
+	/* 1MHz -> 200MHz扫频，上升和下降时间从1us到约71分钟 */
+	s0 = ad9959_ftw_from_millihz(1000000000ULL);
+	e0 = ad9959_ftw_from_millihz(200000000000ULL);
+	for(i = 0; i < 6; i++)
+	{
+		TEST_EQ(ad9959_sweep_frequency_time(1, 1000000000ULL, 200000000000ULL, time_us[i], time_us[5 - i], 0, 1023, &r), 0);
+		TEST_EQ(r.rise_ns, ref_ns(r.rdw, r.rsrr, e0 - s0));
+		TEST_EQ(r.fall_ns, ref_ns(r.fdw, r.fsrr, e0 - s0));
+		TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, RDW, 1), r.rdw);
+		TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, FDW, 1), r.fdw);
+		TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, SRR, 1), ((uint32_t)r.fsrr << 8) | r.rsrr);
+		TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, CFTW0, 1), s0);
+	}
+
+	/* 最长的斜率：步长1，每步255周期，约2^40个周期 */
+	TEST_EQ(ad9959_sweep_frequency_time(2, 1000000000ULL, 200000000000ULL, 0xFFFFFFFFUL, 0xFFFFFFFFUL, 0, 1023, &r), 0);
+	TEST_EQ(r.rdw, 1);
+	TEST_EQ(r.rsrr, 255);
+	TEST_CHECK(r.rise_ns > 1000000000000ULL, "rise_ns=%llu", (unsigned long long)r.rise_ns);
+	TEST_EQ(r.rise_ns, ref_ns(1, 255, e0 - s0));
+	printf("最长上升时间：%llu ns\n", (unsigned long long)r.rise_ns);
+
+	/* 斜率低于每255周期1个控制字时无法实现 */
+	TEST_EQ(ad9959_sweep_frequency_time(0, 1000000000ULL, 1000001000ULL, 0xFFFFFFFFUL, 1, 0, 1023, &r), 1);
+
+	return TEST_RESULT();
+}
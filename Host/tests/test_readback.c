@@ -0,0 +1,210 @@
+#include "myad9959.h"
+#include "spi.h"
+#include "ad9959_test.h"
+
+/**
+ ****************************************************************************************************
+ * @file        test_readback.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       寄存器回读测试：写入后用读指令回读全部寄存器，与仿真芯片的I/O缓冲相同，逻辑CSR不变；
+ *              2线模式由SDIO_0读取(软件SPI切换为输入，硬件SPI为半双工)，3线模式由SDIO_2读取(全双工)，
+ *              读取时没有两边同时驱动数据线，之后的写入仍然正确(数据线已恢复为输出)；
+ *              绕过驱动改写芯片寄存器(包括CSR的通道选择)后ad9959_verify_shadow()只报告被改写的寄存器，
+ *              下一次ad9959_flush()只重写它们；2位/4位模式不支持读取
+ ****************************************************************************************************
+ */
+
+#define ALL_REGS	((1UL << AD9959_REG_COUNT) - 1)
+
+#ifndef AD9959_USE_4BIT_SERIAL
+/* 寄存器字节数 */
+static uint8_t reg_len(uint8_t reg)
+{
+	static const uint8_t len[8] = {1, 3, 2, 3, 4, 2, 3, 2};
+
+	return reg < 8 ? len[reg] : 4;
+}
+
+/* 高字节在前拼接 */
+static uint32_t be(const uint8_t *d, uint8_t n)
+{
+	uint32_t v = 0;
+
+	while(n--)
+		v = (v << 8) | *d++;
+	return v;
+}
+
+/* 逐个回读全部寄存器(全局寄存器只读一次)，返回与仿真芯片I/O缓冲不同的个数，不支持读取时返回0xFFFF */
+static uint32_t readback_all(void)
+{
+	uint8_t d[4], ch, reg;
+	uint32_t bad = 0;
+
+	for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+	{
+		for(reg = FR1; reg < AD9959_REG_COUNT; reg++)
+		{
+			if(reg <= FR2 && ch != 0)
+				continue;
+			if(ad9959_read_reg(ch, reg, d))
+				return 0xFFFF;
+			if(be(d, reg_len(reg)) != ad9959_emu_reg(&ad9959_host_emu, ch, reg, 0))
+			{
+				printf("通道%u寄存器0x%02X：读到0x%08X，芯片为0x%08X\n", ch, reg,
+					   be(d, reg_len(reg)), ad9959_emu_reg(&ad9959_host_emu, ch, reg, 0));
+				bad++;
+			}
+		}
+	}
+	return bad;
+}
+
+/**
+ * 模拟干扰：绕过驱动把芯片通道ch的寄存器reg异或xor并生效，之后芯片CSR为csr(低位保持串行模式)
+ * 用字节级接口直接写仿真芯片，驱动的影子寄存器不知道这次改变
+ */
+static void disturb(uint8_t ch, uint8_t reg, uint32_t xor, uint8_t csr)
+{
+	ad9959_emu_t *emu = &ad9959_host_emu;
+	uint8_t mode = emu->csr & AD9959_CSR_MODE_MASK;
+	uint32_t v = ad9959_emu_reg(emu, ch, reg, 0) ^ xor;
+	uint8_t f[2 + 5 + 2], n = 0, i;
+
+	f[n++] = CSR;
+	f[n++] = (uint8_t)((0x10 << ch) | mode);
+	f[n++] = reg;
+	for(i = reg_len(reg); i > 0; i--)
+		f[n++] = (uint8_t)(v >> (8 * (i - 1)));
+	f[n++] = CSR;
+	f[n++] = (uint8_t)((csr & 0xF0) | mode);
+
+	ad9959_emu_pins(emu, emu->pins & ~AD9959_EMU_PIN_CS);
+	ad9959_emu_spi(emu, f, n);
+	ad9959_emu_pins(emu, emu->pins | AD9959_EMU_PIN_CS);
+	ad9959_emu_io_update(emu);
+}
+
+/* 自上次统计以来写入过的寄存器位图(不含CSR) */
+static uint32_t written(const ad9959_emu_stats_t *before)
+{
+	uint32_t m = 0;
+	uint8_t reg;
+
+	for(reg = FR1; reg < AD9959_REG_COUNT; reg++)
+	{
+		if(ad9959_host_emu.stats.reg_writes[reg] != before->reg_writes[reg])
+			m |= 1UL << reg;
+	}
+	return m;
+}
+#endif
+
+int main(void)
+{
+	uint8_t d[4] = {0}, ch;
+
+	ad9959_host_init();
+	ad9959_init();
+	for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+		ad9959_set_signal_out(ch, 1000000 + 250000 * ch, (uint16_t)(30 * ch), (uint16_t)(1023 - 100 * ch));
+
+#ifdef AD9959_USE_4BIT_SERIAL
+	/* 4位模式没有输出数据线 */
+	TEST_EQ(ad9959_read_reg(0, CFTW0, d), 1);
+	TEST_EQ(ad9959_verify_shadow(ALL_REGS, 0x0F, NULL), 0xFF);
+	TEST_EQ(ad9959_host_emu.stats.reads, 0);
+#else
+	{
+		uint8_t csr = ad9959_dev_cur->shadow.want[0][0];
+		uint32_t bad[AD9959_CH_COUNT], fr1;
+		ad9959_emu_stats_t before;
+
+		/* 2线模式：SDIO_0，软件SPI把数据线切换为输入，硬件SPI为半双工 */
+#ifdef AD9959_USE_HARDWARE_SPI
+		hspi3.Init.Direction = SPI_DIRECTION_1LINE;
+#endif
+		before = ad9959_host_emu.stats;
+		TEST_EQ(readback_all(), 0);
+		TEST_EQ(ad9959_host_emu.stats.reads - before.reads, 2 + (AD9959_REG_COUNT - CFR) * AD9959_CH_COUNT);
+		TEST_EQ(ad9959_host_contention, 0);
+		TEST_EQ(ad9959_dev_cur->shadow.want[0][0], csr);		// 逻辑CSR不变
+
+		/* 读取后数据线恢复为输出：之后的写入正确 */
+		ad9959_set_signal_out(1, 3000000, 90, 512);
+		TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, CFTW0, 1), ad9959_ftw_from_millihz(3000000000ULL));
+		TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, ACR, 1) & 0x3FF, 512);
+		TEST_EQ(readback_all(), 0);
+
+#ifdef AD9959_USE_HARDWARE_SPI
+		/* 2线模式下全双工的MISO(SDIO_2)上没有数据 */
+		hspi3.Init.Direction = SPI_DIRECTION_2LINES;
+		TEST_EQ(ad9959_read_reg(1, CFTW0, d), 0);
+		TEST_EQ(be(d, 4), 0xFFFFFFFF);
+#endif
+
+		/* 3线模式：SDIO_2，硬件SPI为全双工 */
+		ad9959_set_serial_mode(AD9959_CSR_MODE_3WIRE);
+		TEST_EQ(ad9959_host_emu.csr & AD9959_CSR_MODE_MASK, AD9959_CSR_MODE_3WIRE);
+		TEST_EQ(readback_all(), 0);
+		ad9959_set_signal_out(2, 4000000, 180, 256);
+		TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 2, CFTW0, 1), ad9959_ftw_from_millihz(4000000000ULL));
+		TEST_EQ(readback_all(), 0);
+		TEST_EQ(ad9959_host_contention, 0);
+
+		ad9959_set_serial_mode(AD9959_CSR_MODE_2WIRE);
+#ifdef AD9959_USE_HARDWARE_SPI
+		hspi3.Init.Direction = SPI_DIRECTION_1LINE;
+#endif
+		TEST_EQ(readback_all(), 0);
+
+		/* 芯片与影子寄存器一致 */
+		TEST_EQ(ad9959_verify_shadow(ALL_REGS, 0x0F, bad), 0);
+		TEST_EQ(bad[0] | bad[1] | bad[2] | bad[3], 0);
+
+		/* 改写一个通道寄存器：只报告它，下一次发送只重写它 */
+		disturb(1, CFTW0, 0x00100000, ad9959_host_emu.csr);
+		TEST_EQ(ad9959_verify_shadow(ALL_REGS, 0x0F, bad), 1);
+		TEST_EQ(bad[0], 0);
+		TEST_EQ(bad[1], 1UL << CFTW0);
+		TEST_EQ(bad[2] | bad[3], 0);
+		before = ad9959_host_emu.stats;
+		ad9959_flush();
+		TEST_EQ(written(&before), 1UL << CFTW0);
+		TEST_EQ(ad9959_host_emu.stats.frames - before.frames, 1);
+		TEST_CHECK(ad9959_host_emu.stats.bytes - before.bytes <= 2 + 5, "%u字节", ad9959_host_emu.stats.bytes - before.bytes);
+		IO_update();
+		TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, CFTW0, 1), ad9959_ftw_from_millihz(3000000000ULL));
+		TEST_EQ(ad9959_verify_shadow(ALL_REGS, 0x0F, NULL), 0);
+
+		/* 改写全局寄存器和另一个通道，驱动记录芯片选中通道0，实际CSR被改为只选中通道3：仍按正确的通道比较 */
+		fr1 = ad9959_emu_reg(&ad9959_host_emu, 0, FR1, 1);
+		TEST_EQ(ad9959_read_reg(0, CFTW0, d), 0);
+		disturb(2, ACR, 0x155, 0x80);
+		disturb(0, FR1, 0x000020, 0x80);
+		TEST_EQ(ad9959_verify_shadow(ALL_REGS, 0x0F, bad), 2);
+		TEST_EQ(bad[0], 1UL << FR1);
+		TEST_EQ(bad[1], 0);
+		TEST_EQ(bad[2], 1UL << ACR);
+		TEST_EQ(bad[3], 0);
+		before = ad9959_host_emu.stats;
+		IO_update();
+		TEST_EQ(written(&before), (1UL << FR1) | (1UL << ACR));
+		TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 0, FR1, 1), fr1);
+		TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 2, ACR, 1) & 0x3FF, 256);
+		TEST_EQ(readback_all(), 0);
+
+		/* 只比较ch_mask中的通道 */
+		disturb(3, CPOW0, 0x0100, ad9959_host_emu.csr);
+		TEST_EQ(ad9959_verify_shadow(1UL << CPOW0, 0x07, bad), 0);
+		TEST_EQ(ad9959_verify_shadow(1UL << CPOW0, 0x08, bad), 1);
+		TEST_EQ(bad[3], 1UL << CPOW0);
+		IO_update();
+		TEST_EQ(ad9959_verify_shadow(ALL_REGS, 0x0F, NULL), 0);
+		TEST_EQ(ad9959_host_contention, 0);
+	}
+#endif
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,129 @@
+#include "myad9959.h"
+#include "myad9959_sched.h"
+#include "ad9959_test.h"
+
+/**
+ ****************************************************************************************************
+ * @file        test_sched.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       定时更新调度器测试：乱序加入的事件按时刻顺序生效，同一时刻的事件合并为一次IO_update，
+ *              IO_update不早于生效时刻，提前加入的事件没有迟到且偏差小于SLIP_MAX_NS；迟到的事件计入统计
+ ****************************************************************************************************
+ */
+
+#define EVENTS		24
+#define SPACING_NS	300000		/* 相邻时刻间隔300us */
+#define START_NS	1000000		/* 第一个时刻在1ms之后 */
+/* 允许的最大偏差：主机上IO_update在忙等待到时刻后立即产生，实测为数百ns到数us(时间基准为CPU时间，不含抢占)；
+ * 上限取相邻时刻间隔的1/3，超过说明预装或等待的方式有问题，而不是计时抖动 */
+#define SLIP_MAX_NS	(SPACING_NS / 3)
+
+int main(void)
+{
+	static const uint8_t order[EVENTS] =
+	{
+		17, 3, 22, 9, 0, 14, 6, 20, 11, 1, 23, 8,
+		15, 4, 19, 12, 2, 21, 7, 16, 10, 5, 18, 13,
+	};
+	ad9959_sched_event_t ev = {0};
+	ad9959_sched_stats_t st;
+	uint32_t base, io, slip, max_slip, prev_time, i, k, bad_order, early, wrong;
+	uint32_t ftw[AD9959_CH_COUNT], expect[AD9959_CH_COUNT];
+
+	ad9959_host_init();
+	ad9959_init();
+	ad9959_sched_init();
+	for(k = 0; k < AD9959_CH_COUNT; k++)
+		expect[k] = ad9959_emu_reg(&ad9959_host_emu, (uint8_t)k, CFTW0, 1);
+
+	/* 事件i在时刻i/2生效(每个时刻两个通道)，按打乱的顺序加入 */
+	base = AD9959_TIMER_NOW() + START_NS;
+	for(i = 0; i < EVENTS; i++)
+	{
+		k = order[i];
+		ev.when = base + (k / 2) * SPACING_NS;
+		ev.ch = (uint8_t)(k % AD9959_CH_COUNT);
+		ev.flags = AD9959_SCHED_FRE;
+		ev.fre_mhz = 1000000000ULL + k * 1000000ULL;		// 1MHz + k kHz
+		TEST_EQ(ad9959_sched_add(&ev), 0);
+	}
+	TEST_EQ(ad9959_sched_pending(), EVENTS);
+
+	/* 每次产生IO_update后检查生效的寄存器 */
+	io = ad9959_host_emu.stats.io_updates;
+	prev_time = 0;
+	max_slip = 0;
+	bad_order = early = wrong = 0;
+	k = 0;
+	while(ad9959_sched_pending() != 0)
+	{
+		ad9959_sched_poll();
+		if(ad9959_host_emu.stats.io_updates == io)
+			continue;
+		io = ad9959_host_emu.stats.io_updates;
+
+		slip = ad9959_host_update_time - (base + k * SPACING_NS);
+		if((int32_t)slip < 0)
+			early++;
+		else if(slip > max_slip)
+			max_slip = slip;
+		if(k > 0 && (int32_t)(ad9959_host_update_time - prev_time) <= 0)
+			bad_order++;
+		prev_time = ad9959_host_update_time;
+
+		/* 时刻k的两个事件生效，其他通道保持之前的值 */
+		expect[(2 * k) % AD9959_CH_COUNT] = ad9959_ftw_from_millihz(1000000000ULL + 2 * k * 1000000ULL);
+		expect[(2 * k + 1) % AD9959_CH_COUNT] = ad9959_ftw_from_millihz(1000000000ULL + (2 * k + 1) * 1000000ULL);
+		for(i = 0; i < AD9959_CH_COUNT; i++)
+		{
+			ftw[i] = ad9959_emu_reg(&ad9959_host_emu, (uint8_t)i, CFTW0, 1);
+			if(ftw[i] != expect[i])
+				wrong++;
+		}
+		k++;
+	}
+	TEST_EQ(k, EVENTS / 2);
+	TEST_EQ(early, 0);
+	TEST_EQ(bad_order, 0);
+	TEST_EQ(wrong, 0);
+
+	ad9959_sched_get_stats(&st);
+	TEST_EQ(st.events, EVENTS);
+	TEST_EQ(st.updates, EVENTS / 2);
+	TEST_EQ(st.rejected, 0);
+	TEST_EQ(st.late, 0);			// 全部提前START_NS加入，不应迟到
+	TEST_CHECK(max_slip < SLIP_MAX_NS, "max_slip=%u ns", (unsigned)max_slip);
+	printf("调度偏差：最大%u ns，迟到%u次\n", (unsigned)max_slip, (unsigned)st.late);
+
+	/* 已经过去的时刻：立即执行并计为迟到 */
+	ev.when = AD9959_TIMER_NOW() - 1000;
+	ev.ch = 2;
+	ev.flags = AD9959_SCHED_FRE | AD9959_SCHED_AMP;
+	ev.amp = 300;
+	ev.fre_mhz = 7000000000ULL;
+	TEST_EQ(ad9959_sched_add(&ev), 0);
+	ad9959_sched_poll();
+	ad9959_sched_get_stats(&st);
+	TEST_EQ(ad9959_sched_pending(), 0);
+	TEST_EQ(st.late, 1);
+	TEST_EQ(st.max_late >= 1000, 1);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 2, CFTW0, 1), ad9959_ftw_from_millihz(7000000000ULL));
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 2, ACR, 1) & 0x3FF, 300);
+
+	/* 预装窗口之外的事件不处理；队列满时拒绝 */
+	ev.when = AD9959_TIMER_NOW() + 1000000000UL;
+	ev.flags = AD9959_SCHED_PHASE;
+	ev.phase = 90;
+	for(i = 0; i < AD9959_SCHED_DEPTH; i++)
+		TEST_EQ(ad9959_sched_add(&ev), 0);
+	TEST_EQ(ad9959_sched_add(&ev), 1);
+	io = ad9959_host_emu.stats.io_updates;
+	ad9959_sched_poll();
+	TEST_EQ(ad9959_host_emu.stats.io_updates, io);
+	TEST_EQ(ad9959_sched_pending(), AD9959_SCHED_DEPTH);
+	ad9959_sched_get_stats(&st);
+	TEST_EQ(st.rejected, 1);
+
+	return TEST_RESULT();
+}
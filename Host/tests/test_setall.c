@@ -0,0 +1,152 @@
+#include <string.h>
+#include "myad9959.h"
+#include "ad9959_test.h"
+
+/**
+ ****************************************************************************************************
+ * @file        test_setall.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       批量设置测试：通道号不小于AD9959_CH_COUNT时ad9959_load_all()/ad9959_set_all()拒绝且不写入；
+ *              相位0-65535逐个比较AD9959_POW_FROM_DEG()、AD9959_Get_CPOW0_Data()与原双精度公式截断的结果，
+ *              并比较set_all与set_channels在仿真芯片中的寄存器；
+ *              打印4通道全部改变时set_signal_out/set_channels/set_all每次更新的时间、帧数和字节数
+ ****************************************************************************************************
+ */
+
+#define BENCH_RUNS		20000
+
+/* 驱动内部的相位换算(原双精度实现)，头文件中没有声明 */
+extern void AD9959_Get_CPOW0_Data(int phase, uint8_t *CPOW0_Data);
+
+/* 读出仿真芯片中一个通道的单频寄存器 */
+static void read_regs(uint8_t ch, uint32_t *r)
+{
+	r[0] = ad9959_emu_reg(&ad9959_host_emu, ch, CFR, 1);
+	r[1] = ad9959_emu_reg(&ad9959_host_emu, ch, ACR, 1);
+	r[2] = ad9959_emu_reg(&ad9959_host_emu, ch, CPOW0, 1);
+	r[3] = ad9959_emu_reg(&ad9959_host_emu, ch, CFTW0, 1);
+}
+
+/* 第k次更新的参数，4个通道全部改变 */
+static void bench_cfg(uint32_t k, ad9959_channel_cfg_t *cfg)
+{
+	uint8_t ch;
+
+	for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+	{
+		cfg[ch].ch = ch;
+		cfg[ch].phase = (uint16_t)((k * 7 + ch * 90) % 360);
+		cfg[ch].amp = (uint16_t)(1 + (k * 13 + ch) % 1023);
+		cfg[ch].fre_mhz = 1000000000ULL + (k % 1000) * 1000000ULL + ch * 250000000ULL;
+	}
+}
+
+int main(void)
+{
+	ad9959_channel_cfg_t cfg[AD9959_CH_COUNT];
+	ad9959_emu_stats_t before;
+	uint32_t a[4], b[4], k, bad;
+	uint8_t ch;
+
+	ad9959_host_init();
+	ad9959_init();
+
+	/* 通道号错误：拒绝，不写入也不更新 */
+	bench_cfg(1, cfg);
+	TEST_EQ(ad9959_set_all(cfg, AD9959_CH_COUNT), 0);
+	read_regs(1, a);
+	bench_cfg(2, cfg);
+	cfg[2].ch = AD9959_CH_COUNT;		// 4不再被当作通道0
+	before = ad9959_host_emu.stats;
+	TEST_EQ(ad9959_load_all(cfg, AD9959_CH_COUNT), 1);
+	TEST_EQ(ad9959_set_all(cfg, AD9959_CH_COUNT), 1);
+	cfg[2].ch = 0xFF;
+	TEST_EQ(ad9959_set_all(cfg, AD9959_CH_COUNT), 1);
+	IO_update();
+	TEST_EQ(ad9959_host_emu.stats.bytes, before.bytes);
+	read_regs(1, b);
+	TEST_EQ(memcmp(a, b, sizeof(a)), 0);
+	TEST_EQ(ad9959_load_all(cfg, 0), 0);
+
+	/* 相位字：整数换算与原双精度公式截断逐个相同(uint16_t全部取值) */
+	{
+		uint8_t data[2];
+		uint32_t phase, v;
+
+		bad = 0;
+		for(phase = 0; phase <= 0xFFFF; phase++)
+		{
+			v = (uint32_t)(phase * (16384.0 / 360));
+			AD9959_Get_CPOW0_Data((int)phase, data);
+			if(AD9959_POW_FROM_DEG(phase) != v || data[0] != (uint8_t)(v >> 8) || data[1] != (uint8_t)v)
+				bad++;
+		}
+		TEST_EQ(bad, 0);
+	}
+
+	/* 经过驱动：相位0-1440度，set_all与set_channels在仿真芯片中的寄存器相同 */
+	bad = 0;
+	for(k = 0; k <= 1440; k++)
+	{
+		uint32_t ref[AD9959_CH_COUNT][4];
+
+		bench_cfg(k, cfg);
+		for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+			cfg[ch].phase = (uint16_t)k;
+		ad9959_set_channels(cfg, AD9959_CH_COUNT);
+		for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+			read_regs(ch, ref[ch]);
+
+		bench_cfg(k + 5000, cfg);
+		ad9959_set_all(cfg, AD9959_CH_COUNT);		// 先改成别的值，确保下面的set_all真正写入
+		bench_cfg(k, cfg);
+		for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+			cfg[ch].phase = (uint16_t)k;
+		TEST_EQ(ad9959_set_all(cfg, AD9959_CH_COUNT), 0);
+		for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+		{
+			read_regs(ch, b);
+			if(memcmp(ref[ch], b, sizeof(b)) != 0)
+				bad++;
+		}
+	}
+	TEST_EQ(bad, 0);
+
+	/* 性能：每次更新4个通道全部改变 */
+	{
+		static const char *const name[3] = {"4次set_signal_out", "set_channels", "set_all"};
+		uint64_t t0, t1;
+		uint32_t frames[3], bytes[3];
+		uint8_t m;
+
+		for(m = 0; m < 3; m++)
+		{
+			before = ad9959_host_emu.stats;
+			t0 = test_ticks();
+			for(k = 0; k < BENCH_RUNS; k++)
+			{
+				bench_cfg(k, cfg);
+				if(m == 0)
+				{
+					for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+						ad9959_set_signal_out(ch, (double)cfg[ch].fre_mhz / 1000.0, cfg[ch].phase, cfg[ch].amp);
+				}
+				else if(m == 1)
+					ad9959_set_channels(cfg, AD9959_CH_COUNT);
+				else
+					ad9959_set_all(cfg, AD9959_CH_COUNT);
+			}
+			t1 = test_ticks();
+			frames[m] = ad9959_host_emu.stats.frames - before.frames;
+			bytes[m] = ad9959_host_emu.stats.bytes - before.bytes;
+			printf("%-18s %9.1f %s/次  %.2f帧/次  %.1f字节/次\n", name[m], (double)(t1 - t0) / BENCH_RUNS,
+				   TEST_TICK_UNIT, (double)frames[m] / BENCH_RUNS, (double)bytes[m] / BENCH_RUNS);
+		}
+		TEST_EQ(frames[2], BENCH_RUNS);				// 每次更新一帧
+		TEST_CHECK(bytes[2] <= bytes[1], "set_all %u字节 set_channels %u字节", bytes[2], bytes[1]);
+		TEST_CHECK(frames[2] <= frames[1], "set_all %u帧 set_channels %u帧", frames[2], frames[1]);
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,127 @@
+#include "myad9959.h"
+#include "ad9959_test.h"
+
+/**
+ ****************************************************************************************************
+ * @file        test_shadow.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       影子寄存器测试：典型调用序列每次flush只有一次片选，字节数只包含改变的寄存器
+ ****************************************************************************************************
+ */
+
+static ad9959_emu_stats_t last;
+
+/* 自上次调用以来的片选次数和字节数 */
+static void delta(uint32_t *frames, uint32_t *bytes)
+{
+	*frames = ad9959_host_emu.stats.frames - last.frames;
+	*bytes = ad9959_host_emu.stats.bytes - last.bytes;
+	last = ad9959_host_emu.stats;
+}
+
+int main(void)
+{
+	uint32_t frames, bytes, i;
+
+	ad9959_host_init();
+	ad9959_init();
+	delta(&frames, &bytes);
+
+	/* 第一次配置通道0：CSR(2) FR1(4) CFR(4) ACR(4) CFTW0(5)，CPOW0与复位值相同不发送 */
+	ad9959_set_signal_out(0, 1000000, 0, 1023);
+	delta(&frames, &bytes);
+	TEST_EQ(frames, 1);
+	TEST_EQ(bytes, 2 + 4 + 4 + 4 + 5);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 0, CFTW0, 1), 0x0083126F);
+
+	/* 同一通道跳频：只有CFTW0 */
+	ad9959_set_signal_out(0, 2000000, 0, 1023);
+	delta(&frames, &bytes);
+	TEST_EQ(frames, 1);
+	TEST_EQ(bytes, 5);
+
+	/* 完全相同的调用：不发送 */
+	ad9959_set_signal_out(0, 2000000, 0, 1023);
+	delta(&frames, &bytes);
+	TEST_EQ(bytes, 0);
+	TEST_EQ(frames, 0);
+
+	/* 只改相位 */
+	ad9959_set_signal_out(0, 2000000, 90, 1023);
+	delta(&frames, &bytes);
+	TEST_EQ(frames, 1);
+	TEST_EQ(bytes, 3);
+
+	/* 换到通道1：CSR(2) CFR(4) ACR(4) CFTW0(5)，FR1已经相同 */
+	ad9959_set_signal_out(1, 2000000, 0, 1023);
+	delta(&frames, &bytes);
+	TEST_EQ(frames, 1);
+	TEST_EQ(bytes, 2 + 4 + 4 + 5);
+
+	/* 跳频循环：每跳5字节，原来每次重写CSR/FR1/CFR/ACR/CPOW0/CFTW0为21字节
+	 * (上一次两个通道频率相同，分组写入时芯片CSR同时选中了通道0和1，第一跳先切换CSR，不计入) */
+	ad9959_set_signal_out(1, 999000, 0, 1023);
+	delta(&frames, &bytes);
+	TEST_EQ(bytes, 2 + 5);
+	for(i = 0; i < 100; i++)
+		ad9959_set_signal_out(1, 1000000 + 1000 * i, 0, 1023);
+	delta(&frames, &bytes);
+	TEST_EQ(frames, 100);
+	TEST_EQ(bytes, 100 * 5);
+
+	/* 写入多个寄存器后一次flush：仍然只有一次片选 */
+	{
+		uint8_t ftw2[4] = {0x01, 0x89, 0x37, 0x4C};		// 3MHz
+		uint8_t ftw3[4] = {0x02, 0x0C, 0x49, 0xBA};		// 4MHz
+		uint8_t csr2[1] = {0x40}, csr3[1] = {0x80};
+
+		AD9959_WriteData_Unified(CSR, 1, csr2);
+		AD9959_WriteData_Unified(CFTW0, 4, ftw2);
+		AD9959_WriteData_Unified(CSR, 1, csr3);
+		AD9959_WriteData_Unified(CFTW0, 4, ftw3);
+		TEST_EQ(ad9959_host_emu.stats.bytes, last.bytes);	// 还没有发送
+		IO_update();
+	}
+	delta(&frames, &bytes);
+	TEST_EQ(frames, 1);
+	TEST_EQ(bytes, 2 + 5 + 2 + 5);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 2, CFTW0, 1), 0x0189374C);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 3, CFTW0, 1), 0x020C49BA);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, CFTW0, 1), ad9959_ftw_from_millihz(1099000000ULL));
+
+	/* 长度不符的写入被忽略：不发送，其他寄存器仍然有效 */
+	{
+		uint8_t bad[3] = {0x01, 0x02, 0x03};
+
+		AD9959_WriteData_Unified(CFTW0, 3, bad);
+		AD9959_WriteData_Unified(AD9959_REG_COUNT, 3, bad);
+		IO_update();
+		delta(&frames, &bytes);
+		TEST_EQ(bytes, 0);
+		TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 3, CFTW0, 1), 0x020C49BA);
+		ad9959_set_signal_out(0, 3000000, 90, 1023);		// CSR(2) CFTW0(5)
+		delta(&frames, &bytes);
+		TEST_EQ(frames, 1);
+		TEST_EQ(bytes, 2 + 5);
+	}
+
+	/* 部分寄存器失效：只重发该通道的该寄存器 */
+	ad9959_shadow_forget(0x02, 1UL << CFTW0);
+	ad9959_set_signal_out(0, 3000000, 90, 1023);
+	delta(&frames, &bytes);
+	TEST_EQ(bytes, 0);
+	ad9959_shadow_forget(0x01, (1UL << CFTW0) | (1UL << FR1));
+	ad9959_set_signal_out(0, 3000000, 90, 1023);
+	delta(&frames, &bytes);
+	TEST_EQ(frames, 1);
+	TEST_EQ(bytes, 4 + 5);
+
+	/* 影子寄存器失效后全部重发 */
+	ad9959_shadow_invalidate();
+	ad9959_set_signal_out(0, 2000000, 90, 1023);
+	delta(&frames, &bytes);
+	TEST_EQ(frames, 1);
+	TEST_EQ(bytes, 2 + 4 + 4 + 4 + 3 + 5);
+	return TEST_RESULT();
+}
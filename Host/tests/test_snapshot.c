@@ -0,0 +1,153 @@
+#include "myad9959.h"
+#include "myad9959_mod.h"
+#include "ad9959_test.h"
+
+#include <string.h>
+
+/**
+ ****************************************************************************************************
+ * @file        test_snapshot.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       状态快照测试：配置单频、调制和扫频后保存快照，ad9959_init()复位芯片再恢复，
+ *              仿真芯片的全部寄存器(I/O缓冲和生效值)与快照前相同，恢复只用一帧和一次IO_update；
+ *              芯片已经相同时(掉电唤醒)恢复不发送；损坏、截断、版本不符或系统时钟不同的快照返回1，
+ *              影子寄存器和芯片都不改变
+ ****************************************************************************************************
+ */
+
+static uint32_t ref[AD9959_CH_COUNT][AD9959_REG_COUNT][2];
+
+/* 仿真芯片全部寄存器(不含CSR)与ref不同的个数，save非0时保存到ref */
+static uint32_t chip_diff(uint8_t save)
+{
+	uint32_t v, bad = 0;
+	uint8_t ch, reg, active;
+
+	for(ch = 0; ch < AD9959_CH_COUNT; ch++)
+	{
+		for(reg = FR1; reg < AD9959_REG_COUNT; reg++)
+		{
+			for(active = 0; active < 2; active++)
+			{
+				v = ad9959_emu_reg(&ad9959_host_emu, ch, reg, active);
+				if(save)
+					ref[ch][reg][active] = v;
+				else if(v != ref[ch][reg][active])
+					bad++;
+			}
+		}
+	}
+	return bad;
+}
+
+/* 与驱动相同的CRC-16/CCITT，用于构造校验正确但内容不符的快照 */
+static void set_crc(uint8_t *buf, uint16_t len)
+{
+	uint16_t crc = 0xFFFF, i;
+	uint8_t bit;
+
+	for(i = 0; i < len - 2; i++)
+	{
+		crc ^= (uint16_t)(buf[i] << 8);
+		for(bit = 0; bit < 8; bit++)
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+	}
+	buf[len - 2] = (uint8_t)(crc >> 8);
+	buf[len - 1] = (uint8_t)crc;
+}
+
+/* 恢复应被拒绝：返回1，影子寄存器和芯片不变 */
+static void expect_reject(const uint8_t *buf, uint16_t len, const char *what)
+{
+	ad9959_shadow_t shadow = ad9959_dev_cur->shadow;
+	uint32_t frames = ad9959_host_emu.stats.frames, updates = ad9959_host_emu.stats.io_updates;
+
+	TEST_CHECK(ad9959_restore(buf, len) == 1, "%s没有被拒绝", what);
+	TEST_CHECK(memcmp(&shadow, &ad9959_dev_cur->shadow, sizeof(shadow)) == 0, "%s改变了影子寄存器", what);
+	TEST_CHECK(ad9959_host_emu.stats.frames == frames && ad9959_host_emu.stats.io_updates == updates,
+			   "%s访问了芯片", what);
+}
+
+int main(void)
+{
+	static const uint32_t words[4] = {0x10000000, 0x12000000, 0x14000000, 0x16000000};
+	uint8_t snap[AD9959_SNAPSHOT_MAX_BYTES], bad[AD9959_SNAPSHOT_MAX_BYTES], again[AD9959_SNAPSHOT_MAX_BYTES];
+	ad9959_emu_stats_t before;
+	uint16_t n, i;
+
+	ad9959_host_init();
+	ad9959_init();
+
+	/* 通道0/1单频，通道2四级FSK，通道3线性扫频 */
+	ad9959_set_signal_out(0, 1000000, 45, 1023);
+	ad9959_set_signal_out(1, 2500000, 270, 600);
+	TEST_EQ(ad9959_mod_config(2, AD9959_MOD_FRE, 4, words), 0);
+	TEST_EQ(ad9959_sweep_frequency_time(3, 10000000000ULL, 12000000000ULL, 100, 50, 90, 800, NULL), 0);
+	TEST_EQ(chip_diff(1), 0);
+
+	/* 保存：缓冲区不足时返回0 */
+	n = ad9959_snapshot(snap, sizeof(snap));
+	TEST_CHECK(n > 0 && n <= AD9959_SNAPSHOT_MAX_BYTES, "n=%u", n);
+	TEST_EQ(ad9959_snapshot(bad, (uint16_t)(n - 1)), 0);
+	printf("快照%u字节\n", n);
+
+	/* 损坏的快照：每一个字节翻转一位都被拒绝 */
+	for(i = 0; i < n; i++)
+	{
+		memcpy(bad, snap, n);
+		bad[i] ^= 0x10;
+		if(ad9959_restore(bad, n) != 1)
+			break;
+	}
+	TEST_EQ(i, n);
+	memcpy(bad, snap, n);
+	bad[n / 2] ^= 0x01;
+	expect_reject(bad, n, "损坏的快照");
+	expect_reject(snap, (uint16_t)(n - 1), "截断的快照");
+	expect_reject(snap, 0, "空快照");
+
+	/* CRC正确但版本或系统时钟不同 */
+	memcpy(bad, snap, n);
+	bad[2]++;
+	set_crc(bad, n);
+	expect_reject(bad, n, "版本不符的快照");
+	memcpy(bad, snap, n);
+	bad[6] ^= 0x01;
+	set_crc(bad, n);
+	expect_reject(bad, n, "系统时钟不同的快照");
+
+	/* 芯片复位后恢复：全部寄存器与保存前相同，一帧、一次IO_update */
+	ad9959_init();
+	TEST_CHECK(chip_diff(0) != 0, "复位后芯片仍是原来的内容");
+	before = ad9959_host_emu.stats;
+	TEST_EQ(ad9959_restore(snap, n), 0);
+	TEST_EQ(ad9959_host_emu.stats.frames - before.frames, 1);
+	TEST_EQ(ad9959_host_emu.stats.io_updates - before.io_updates, 1);
+	TEST_EQ(chip_diff(0), 0);
+	printf("恢复发送%u字节\n", ad9959_host_emu.stats.bytes - before.bytes);
+
+	/* 恢复后的快照与原快照相同 */
+	TEST_EQ(ad9959_snapshot(again, sizeof(again)), n);
+	TEST_EQ(memcmp(again, snap, n), 0);
+
+	/* 掉电期间寄存器保持：唤醒后恢复不需要发送 */
+	ad9959_power_down();
+	TEST_CHECK(ad9959_host_emu.pins & AD9959_EMU_PIN_PDC, "PWR_DWN_CTL没有拉高");
+	ad9959_power_up();
+	TEST_CHECK(!(ad9959_host_emu.pins & AD9959_EMU_PIN_PDC), "PWR_DWN_CTL没有拉低");
+	before = ad9959_host_emu.stats;
+	TEST_EQ(ad9959_restore(snap, n), 0);
+	TEST_EQ(ad9959_host_emu.stats.frames - before.frames, 0);
+	TEST_EQ(ad9959_host_emu.stats.bytes - before.bytes, 0);
+	TEST_EQ(chip_diff(0), 0);
+
+	/* 恢复后继续修改：只发送改变的寄存器 */
+	before = ad9959_host_emu.stats;
+	ad9959_set_signal_out(1, 3000000, 270, 600);
+	TEST_EQ(ad9959_host_emu.stats.reg_writes[CFTW0] - before.reg_writes[CFTW0], 1);
+	TEST_EQ(ad9959_host_emu.stats.reg_writes[ACR] - before.reg_writes[ACR], 0);
+	TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, CFTW0, 1), ad9959_ftw_from_millihz(3000000000ULL));
+
+	return TEST_RESULT();
+}
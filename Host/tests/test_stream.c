@@ -0,0 +1,132 @@
+#include "myad9959.h"
+#include "myad9959_mod.h"
+#include "myad9959_stream.h"
+#include "ad9959_test.h"
+
+/**
+ ****************************************************************************************************
+ * @file        test_stream.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       符号流测试(软件输出路径，与DMA半传输/传输完成中断使用同一个ad9959_stream_half_cplt())：
+ *              每输出完半个缓冲区正好补充一次且只补充刚输出完的一半，仿真芯片收到的符号序列与数据源一致，
+ *              数据源结束后补符号0，所在的一半输出完后停止
+ ****************************************************************************************************
+ */
+
+#define TOTAL_SYMBOLS	1300		/* 不是半缓冲区的整数倍 */
+#define MAX_CALLS		16
+
+/* 数据源：按伪随机序列给出比特，记录每次调用时已输出的符号数 */
+typedef struct
+{
+	uint32_t total_bits;
+	uint32_t sent_bits;
+	uint32_t calls;
+	uint32_t at_tick[MAX_CALLS];
+	uint32_t ticks;
+} source_t;
+
+static uint8_t bit_at(uint32_t n)
+{
+	uint32_t x = n * 2654435761U;
+
+	return (uint8_t)((x >> 29) & 1);
+}
+
+static uint32_t source(void *ctx, uint8_t *data, uint32_t nbits)
+{
+	source_t *s = (source_t *)ctx;
+	uint32_t i, n = s->total_bits - s->sent_bits;
+
+	if(s->calls < MAX_CALLS)
+		s->at_tick[s->calls] = s->ticks;
+	s->calls++;
+
+	if(n > nbits)
+		n = nbits;
+	for(i = 0; i < (n + 7) / 8; i++)
+		data[i] = 0;
+	for(i = 0; i < n; i++)
+		if(bit_at(s->sent_bits + i))
+			data[i >> 3] |= (uint8_t)(0x80 >> (i & 7));
+	s->sent_bits += n;
+	return n;
+}
+
+int main(void)
+{
+	static uint8_t played[8 * AD9959_STREAM_HALF];
+	source_t src = {0};
+	uint32_t words[4], i, n, bad, halves;
+	uint8_t s;
+
+	ad9959_host_init();
+	ad9959_init();
+	ad9959_mod_init();
+
+	/* 未配置调制时不能启动 */
+	TEST_EQ(ad9959_stream_start(1000000, source, &src), 1);
+
+	for(s = 0; s < 4; s++)
+		words[s] = ad9959_ftw_from_hz(1000000U + 250000U * s);
+	TEST_EQ(ad9959_mod_config(0, AD9959_MOD_FRE, 4, words), 0);
+	TEST_EQ(ad9959_stream_start(1000000, NULL, &src), 1);
+	TEST_EQ(ad9959_stream_start(0, source, &src), 1);
+
+	src.total_bits = TOTAL_SYMBOLS * 2;
+	TEST_EQ(ad9959_stream_start(1000000, source, &src), 0);
+	TEST_EQ(ad9959_stream_busy(), 1);
+	TEST_EQ(src.calls, 2);							// 启动前两半都已填好
+	TEST_EQ(ad9959_stream_start(1000000, source, &src), 1);	// 正在运行
+
+	/* 逐个符号输出，记录仿真芯片的符号 */
+	n = 0;
+	while(n < sizeof(played))
+	{
+		uint8_t more;
+
+		src.ticks++;
+		more = ad9959_stream_tick();
+		played[n++] = ad9959_emu_symbol(&ad9959_host_emu, 0);
+		if(!more)
+			break;
+	}
+	TEST_EQ(ad9959_stream_busy(), 0);
+
+	/* 符号序列：数据源的比特两两一组，之后为0 */
+	bad = 0;
+	for(i = 0; i < n; i++)
+	{
+		uint8_t expect = (i < TOTAL_SYMBOLS) ? (uint8_t)((bit_at(2 * i) << 1) | bit_at(2 * i + 1)) : 0;
+
+		if(played[i] != expect)
+			bad++;
+	}
+	TEST_EQ(bad, 0);
+	TEST_EQ(ad9959_stream_symbols(), TOTAL_SYMBOLS);
+
+	/* 结束符号所在的一半输出完后停止，停止后输出符号0 */
+	halves = (TOTAL_SYMBOLS + AD9959_STREAM_HALF - 1) / AD9959_STREAM_HALF;
+	TEST_EQ(n, halves * AD9959_STREAM_HALF);
+	TEST_EQ(ad9959_emu_symbol(&ad9959_host_emu, 0), 0);
+
+	/* 补充：第k次(k>=2)调用发生在输出完第k-1个半缓冲区时，此后不再调用 */
+	TEST_EQ(src.calls, halves);
+	for(i = 2; i < src.calls && i < MAX_CALLS; i++)
+		TEST_EQ(src.at_tick[i], (i - 1) * AD9959_STREAM_HALF);
+	TEST_EQ(src.sent_bits, src.total_bits);
+
+	/* 数据源在启动时就结束：只输出第一半 */
+	src.total_bits = 10;
+	src.sent_bits = 0;
+	src.calls = 0;
+	TEST_EQ(ad9959_stream_start(1000000, source, &src), 0);
+	for(n = 0; ad9959_stream_tick(); n++)
+	{
+	}
+	TEST_EQ(n + 1, AD9959_STREAM_HALF);
+	TEST_EQ(ad9959_stream_symbols(), 5);
+
+	return TEST_RESULT();
+}
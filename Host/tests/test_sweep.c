@@ -0,0 +1,176 @@
+#include <math.h>
+#include "myad9959.h"
+#include "myad9959_hop.h"
+#include "myad9959_sweep.h"
+#include "ad9959_test.h"
+
+/**
+ ****************************************************************************************************
+ * @file        test_sweep.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       扫频生成器测试：递推生成的频率控制字与参考扫频(long double逐点直接计算，对数段用powl)比较，
+ *              线性和对数扫频(含百万点)每点偏差不超过1 LSB(实测为取整的0.5 LSB)；分块生成与一次生成相同；播放时仿真芯片逐点收到同一序列
+ ****************************************************************************************************
+ */
+
+#define CHUNK		1000
+
+/* 参考扫频第k点(0为起点)，FTW单位，不取整 */
+static long double ref_point(long double f0, long double f1, uint32_t k, uint32_t points, uint8_t shape)
+{
+	if(shape == AD9959_SWEEP_LOG)
+		return f0 * powl(f1 / f0, (long double)k / points);
+	return f0 + (f1 - f0) * k / points;
+}
+
+/* 生成整个扫频并与参考比较，返回最大偏差(LSB) */
+static double compare(uint64_t start_mhz, const ad9959_sweep_seg_t *seg, uint16_t nseg, uint32_t *count)
+{
+	static uint32_t ftw[CHUNK];
+	ad9959_sweep_gen_t g;
+	long double f0 = ad9959_ftw_from_millihz(start_mhz), f1, ref, err, max_err = 0;
+	uint32_t n, i, k = 0;
+	uint16_t s = 0;
+
+	*count = 0;
+	if(ad9959_sweep_gen_init(&g, start_mhz, seg, nseg))
+		return -1;
+
+	f1 = ad9959_ftw_from_millihz(seg[0].fre_mhz);
+	do
+	{
+		n = ad9959_sweep_gen_next(&g, ftw, CHUNK);
+		for(i = 0; i < n; i++)
+		{
+			if(*count == 0)
+				ref = f0;				// 起点
+			else
+			{
+				if(k == seg[s].points)
+				{
+					s++;
+					k = 0;
+					f0 = f1;
+					f1 = ad9959_ftw_from_millihz(seg[s].fre_mhz);
+				}
+				k++;
+				ref = ref_point(f0, f1, k, seg[s].points, seg[s].shape);
+			}
+			err = fabsl((long double)ftw[i] - ref);
+			if(err > max_err)
+				max_err = err;
+			(*count)++;
+		}
+	} while(n == CHUNK);
+	return (double)max_err;
+}
+
+int main(void)
+{
+	static const ad9959_sweep_seg_t lin[1] = {{100000000000ULL, 1000000, AD9959_SWEEP_LIN}};		// 1kHz -> 100MHz
+	static const ad9959_sweep_seg_t log_up[1] = {{100000000000ULL, 1000000, AD9959_SWEEP_LOG}};
+	static const ad9959_sweep_seg_t log_down[1] = {{1000000ULL, 333333, AD9959_SWEEP_LOG}};		// 100MHz -> 1kHz
+	static const ad9959_sweep_seg_t multi[4] =
+	{
+		{10000000000ULL, 1000, AD9959_SWEEP_LOG},		// 1MHz -> 10MHz
+		{10000000000ULL, 10,   AD9959_SWEEP_LIN},		// 保持
+		{2000000000ULL,  777,  AD9959_SWEEP_LIN},		// -> 2MHz
+		{150000000000ULL, 5000, AD9959_SWEEP_LOG},		// -> 150MHz
+	};
+	uint32_t count;
+	double err;
+
+	ad9959_host_init();
+	ad9959_init();
+
+	err = compare(1000000ULL, lin, 1, &count);
+	printf("线性1kHz-100MHz 1e6点：最大偏差%.3f LSB\n", err);
+	TEST_EQ(count, 1000001);
+	TEST_CHECK(err >= 0 && err <= 1.0, "err=%.3f", err);
+
+	err = compare(1000000ULL, log_up, 1, &count);
+	printf("对数1kHz-100MHz 1e6点：最大偏差%.3f LSB\n", err);
+	TEST_EQ(count, 1000001);
+	TEST_CHECK(err >= 0 && err <= 1.0, "err=%.3f", err);
+
+	err = compare(100000000000ULL, log_down, 1, &count);
+	printf("对数100MHz-1kHz 333333点：最大偏差%.3f LSB\n", err);
+	TEST_EQ(count, 333334);
+	TEST_CHECK(err >= 0 && err <= 1.0, "err=%.3f", err);
+
+	err = compare(1000000000ULL, multi, 4, &count);
+	printf("多段扫频：最大偏差%.3f LSB\n", err);
+	TEST_EQ(count, 1 + 1000 + 10 + 777 + 5000);
+	TEST_CHECK(err >= 0 && err <= 1.0, "err=%.3f", err);
+
+	/* 分块大小不影响结果，每段终点为精确值 */
+	{
+		uint32_t a[64], b[8 * 1000], n = 0, m, i, bad = 0;
+		ad9959_sweep_gen_t g1, g2;
+
+		TEST_EQ(ad9959_sweep_gen_init(&g1, 1000000000ULL, multi, 4), 0);
+		TEST_EQ(ad9959_sweep_gen_init(&g2, 1000000000ULL, multi, 4), 0);
+		m = ad9959_sweep_gen_next(&g2, b, sizeof(b) / sizeof(b[0]));
+		TEST_EQ(m, count);
+		do
+		{
+			uint32_t k = ad9959_sweep_gen_next(&g1, a, 7);
+
+			for(i = 0; i < k; i++, n++)
+				if(n >= m || a[i] != b[n])
+					bad++;
+			if(k < 7)
+				break;
+		} while(1);
+		TEST_EQ(n, m);
+		TEST_EQ(bad, 0);
+		TEST_EQ(b[1000], ad9959_ftw_from_millihz(10000000000ULL));
+		TEST_EQ(b[1010], ad9959_ftw_from_millihz(10000000000ULL));
+		TEST_EQ(b[1787], ad9959_ftw_from_millihz(2000000000ULL));
+		TEST_EQ(b[m - 1], ad9959_ftw_from_millihz(150000000000ULL));
+	}
+
+	/* 参数检查：点数为0、对数段频率为0、每点比例超过2 */
+	{
+		ad9959_sweep_gen_t g;
+		const ad9959_sweep_seg_t zero_pts[1] = {{2000000000ULL, 0, AD9959_SWEEP_LIN}};
+		const ad9959_sweep_seg_t zero_fre[1] = {{0, 100, AD9959_SWEEP_LOG}};
+		const ad9959_sweep_seg_t too_fast[1] = {{5000000000ULL, 2, AD9959_SWEEP_LOG}};	// 1MHz -> 5MHz两点
+
+		TEST_EQ(ad9959_sweep_gen_init(&g, 1000000000ULL, zero_pts, 1), 1);
+		TEST_EQ(ad9959_sweep_gen_init(&g, 1000000000ULL, zero_fre, 1), 1);
+		TEST_EQ(ad9959_sweep_gen_init(&g, 1000000000ULL, too_fast, 1), 1);
+		TEST_EQ(ad9959_sweep_gen_init(&g, 1000000000ULL, NULL, 1), 1);
+	}
+
+	/* 播放：每一跳后仿真芯片生效的CFTW0与生成器的序列相同 */
+	{
+		static const ad9959_sweep_seg_t play[2] =
+		{
+			{20000000000ULL, 300, AD9959_SWEEP_LOG},
+			{5000000000ULL,  200, AD9959_SWEEP_LIN},
+		};
+		static uint32_t ref[501];
+		ad9959_sweep_gen_t g;
+		uint32_t n, i = 0, bad = 0;
+
+		TEST_EQ(ad9959_sweep_gen_init(&g, 1000000000ULL, play, 2), 0);
+		n = ad9959_sweep_gen_next(&g, ref, 501);
+		TEST_EQ(n, 501);
+
+		ad9959_set_signal_out(1, 1000000, 0, 1023);
+		TEST_EQ(ad9959_sweep_play(1, 1000000000ULL, play, 2, 100000), 0);
+		while(ad9959_hop_tick())
+		{
+			if(i >= n || ad9959_emu_reg(&ad9959_host_emu, 1, CFTW0, 1) != ref[i])
+				bad++;
+			i++;
+		}
+		TEST_EQ(bad, 0);
+		TEST_EQ(i + 1, n);
+		TEST_EQ(ad9959_emu_reg(&ad9959_host_emu, 1, CFTW0, 1), ref[n - 1]);
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,121 @@
+#include "myad9959.h"
+#include "myad9959_trace.h"
+#include "ad9959_test.h"
+
+/**
+ ****************************************************************************************************
+ * @file        test_trace.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       性能统计测试(AD9959_USE_TRACE)：累计的字节数、传输次数和IO_update次数与仿真芯片的统计一致；
+ *              每次调用的事件记录与仿真芯片在该调用中收到的帧和字节一致，环形缓冲区回绕后按顺序保留最近的事件
+ ****************************************************************************************************
+ */
+
+#define HOPS		40
+
+int main(void)
+{
+	ad9959_emu_stats_t before, mark;
+	ad9959_trace_stats_t st;
+	ad9959_trace_event_t ev[AD9959_TRACE_DEPTH + 8];
+	uint32_t i, bad;
+	uint16_t n;
+
+	ad9959_host_init();
+	ad9959_init();
+	ad9959_trace_init();
+	before = ad9959_host_emu.stats;
+
+	/* 一次set_signal_out：6次写入影子寄存器(不发送)，IO_update发送一帧 */
+	ad9959_set_signal_out(0, 1000000, 0, 1023);
+	ad9959_trace_snapshot(&st);
+	TEST_EQ(st.calls[AD9959_TRACE_API_WRITE], 6);
+	TEST_EQ(st.calls[AD9959_TRACE_API_UPDATE], 1);
+	TEST_EQ(st.calls[AD9959_TRACE_API_FLUSH], 0);		// IO_update内部的flush计入外层调用
+	TEST_EQ(st.events, 7);
+	TEST_EQ(st.bytes, ad9959_host_emu.stats.bytes - before.bytes);
+	TEST_EQ(st.frames, ad9959_host_emu.stats.frames - before.frames);
+	TEST_EQ(st.updates, ad9959_host_emu.stats.io_updates - before.io_updates);
+
+	n = ad9959_trace_recent(ev, AD9959_TRACE_DEPTH);
+	TEST_EQ(n, 7);
+	bad = 0;
+	for(i = 0; i < 6; i++)
+	{
+		if(ev[i].api != AD9959_TRACE_API_WRITE || ev[i].bytes != 0 || ev[i].frames != 0 || ev[i].updates != 0)
+			bad++;
+	}
+	TEST_EQ(bad, 0);
+	TEST_EQ(ev[0].reg, CSR);
+	TEST_EQ(ev[5].reg, CFTW0);
+	TEST_EQ(ev[6].api, AD9959_TRACE_API_UPDATE);
+	TEST_EQ(ev[6].bytes, st.bytes);
+	TEST_EQ(ev[6].frames, 1);
+	TEST_EQ(ev[6].updates, 1);
+
+	/* 跳频：每次IO_update的事件与仿真芯片在这次调用中收到的一致 */
+	bad = 0;
+	for(i = 0; i < HOPS; i++)
+	{
+		mark = ad9959_host_emu.stats;
+		ad9959_set_signal_out(0, 1000000 + 1000 * (i + 1), 0, 1023);
+		n = ad9959_trace_recent(ev, 1);
+		if(n != 1 || ev[0].api != AD9959_TRACE_API_UPDATE
+		   || ev[0].bytes != ad9959_host_emu.stats.bytes - mark.bytes
+		   || ev[0].frames != ad9959_host_emu.stats.frames - mark.frames
+		   || ev[0].updates != ad9959_host_emu.stats.io_updates - mark.io_updates)
+			bad++;
+	}
+	TEST_EQ(bad, 0);
+
+	/* 单独调用ad9959_flush()记为一次FLUSH */
+	{
+		uint8_t ftw[4] = {0x01, 0x89, 0x37, 0x4C};
+
+		mark = ad9959_host_emu.stats;
+		ad9959_channel_sel_enable(1);
+		AD9959_WriteData_Unified(CFTW0, 4, ftw);
+		ad9959_flush();
+		n = ad9959_trace_recent(ev, 1);
+		TEST_EQ(ev[0].api, AD9959_TRACE_API_FLUSH);
+		TEST_EQ(ev[0].bytes, ad9959_host_emu.stats.bytes - mark.bytes);
+		TEST_EQ(ev[0].frames, 1);
+		TEST_EQ(ev[0].updates, 0);
+	}
+
+	/* 累计值与仿真芯片一致 */
+	ad9959_trace_snapshot(&st);
+	TEST_EQ(st.calls[AD9959_TRACE_API_WRITE], 6 * (1 + HOPS) + 2);
+	TEST_EQ(st.calls[AD9959_TRACE_API_UPDATE], 1 + HOPS);
+	TEST_EQ(st.calls[AD9959_TRACE_API_FLUSH], 1);
+	TEST_EQ(st.events, 7 * (1 + HOPS) + 3);
+	TEST_EQ(st.bytes, ad9959_host_emu.stats.bytes - before.bytes);
+	TEST_EQ(st.frames, ad9959_host_emu.stats.frames - before.frames);
+	TEST_EQ(st.updates, ad9959_host_emu.stats.io_updates - before.io_updates);
+
+	/* 环形缓冲区已回绕：只保留最近AD9959_TRACE_DEPTH个，时间先后排列，最后是FLUSH */
+	n = ad9959_trace_recent(ev, AD9959_TRACE_DEPTH + 8);
+	TEST_EQ(n, AD9959_TRACE_DEPTH);
+	TEST_EQ(ev[n - 1].api, AD9959_TRACE_API_FLUSH);
+	TEST_EQ(ev[n - 2].api, AD9959_TRACE_API_WRITE);
+	TEST_EQ(ev[n - 2].reg, CFTW0);
+	TEST_EQ(ev[n - 3].reg, CSR);
+	TEST_EQ(ev[n - 4].api, AD9959_TRACE_API_UPDATE);
+	bad = 0;
+	for(i = 1; i < n; i++)
+	{
+		if((int32_t)(ev[i].start - ev[i - 1].start) < 0)
+			bad++;
+	}
+	TEST_EQ(bad, 0);
+
+	/* 清零 */
+	ad9959_trace_reset();
+	ad9959_trace_snapshot(&st);
+	TEST_EQ(st.events, 0);
+	TEST_EQ(st.bytes, 0);
+	TEST_EQ(ad9959_trace_recent(ev, AD9959_TRACE_DEPTH), 0);
+
+	return TEST_RESULT();
+}